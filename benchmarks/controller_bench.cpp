@@ -0,0 +1,244 @@
+/**
+ * @file controller_bench.cpp
+ * @brief Microbenchmarks for the equipment controller hot paths
+ */
+
+#include "equipment_controller.h"
+#include "fake_serial_device.h"
+#include "limit_check.h"
+#include "result_export.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace MechatronicTest;
+
+namespace {
+
+EquipmentConfig makeOfflineConfig() {
+    EquipmentConfig config;
+    config.device_port = "bench_port";
+    config.baud_rate = 115200;
+    config.measurement_tolerance = 0.1;
+    config.max_retry_attempts = 3;
+    config.enable_logging = false;
+    config.log_file_path = "";
+    return config;
+}
+
+} // namespace
+
+// Response parsing as done by runTest()/runTestInto()
+static void BM_ParseResultFrame(benchmark::State& state) {
+    constexpr std::string_view frame = "RESULT:4.98731:V:PASS";
+    TestOutcome outcome;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parseResultFrame(frame, outcome));
+        benchmark::DoNotOptimize(outcome);
+    }
+}
+BENCHMARK(BM_ParseResultFrame);
+
+// Multi-channel reply parsing into a reused readings buffer
+static void BM_ParseMultiChannelFrame(benchmark::State& state) {
+    std::string frame = "RESULT:";
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        frame += (i == 0 ? "" : ",");
+        frame += std::to_string(4.9 + 0.001 * static_cast<double>(i));
+    }
+    frame += ":V:PASS";
+    TestOutcome outcome;
+    std::vector<double> readings;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parseResultFrame(frame, outcome, &readings));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseMultiChannelFrame)->Arg(64)->Arg(512);
+
+// Host-side limit check; the SIMD implementation against the scalar one
+template <size_t (*Check)(const double*, const double*, const double*, size_t, std::uint64_t*)>
+static void BM_CheckLimits(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    std::vector<double> readings(count, 5.0), lower(count, 4.9), upper(count, 5.1);
+    std::vector<std::uint64_t> mask((count + 63) / 64);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Check(readings.data(), lower.data(), upper.data(), count, mask.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(Check == checkLimits ? limitCheckImplementation() : "scalar");
+}
+BENCHMARK_TEMPLATE(BM_CheckLimits, checkLimits)->Arg(64)->Arg(512);
+BENCHMARK_TEMPLATE(BM_CheckLimits, checkLimitsScalar)->Arg(64)->Arg(512);
+
+// Result timestamps; formatTimestamp() replaced Impl::getCurrentTimestamp()
+static void BM_FormatTimestampBuffer(benchmark::State& state) {
+    char buffer[32];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(formatTimestamp(std::chrono::system_clock::now(), buffer, sizeof(buffer)));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_FormatTimestampBuffer);
+
+static void BM_FormatTimestampString(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(formatTimestamp(std::chrono::system_clock::now()));
+    }
+}
+BENCHMARK(BM_FormatTimestampString);
+
+// Command formatting; the argument is the number of test parameters
+static void BM_FormatTestCommand(benchmark::State& state) {
+    std::vector<std::string> params;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        params.push_back("param_" + std::to_string(i));
+    }
+    std::string command;
+    for (auto _ : state) {
+        formatTestCommand(command, 0, "device_0042", params);
+        benchmark::DoNotOptimize(command.data());
+    }
+}
+BENCHMARK(BM_FormatTestCommand)->Arg(2)->Arg(8);
+
+static void BM_FormatTaggedTestCommand(benchmark::State& state) {
+    std::vector<std::string> params = {"voltage", "5.0"};
+    std::string command;
+    TestTicket tag = 1;
+    for (auto _ : state) {
+        formatTestCommand(command, tag++, "device_0042", params);
+        benchmark::DoNotOptimize(command.data());
+    }
+}
+BENCHMARK(BM_FormatTaggedTestCommand);
+
+// setStatus() via pause()/resume(); two status changes per iteration
+static void BM_SetStatusNoCallback(benchmark::State& state) {
+    EquipmentController controller;
+    controller.start();
+    for (auto _ : state) {
+        controller.pause();
+        controller.resume();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_SetStatusNoCallback);
+
+static void BM_SetStatusWithCallback(benchmark::State& state) {
+    EquipmentController controller;
+    int delivered = 0;
+    controller.setStatusCallback([&delivered](EquipmentStatus, const std::string&) { ++delivered; });
+    controller.start();
+    for (auto _ : state) {
+        controller.pause();
+        controller.resume();
+    }
+    controller.waitForStatusEvents();
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_SetStatusWithCallback);
+
+static void BM_GetHealthMetrics(benchmark::State& state) {
+    EquipmentController controller;
+    controller.initialize(makeOfflineConfig());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(controller.getHealthMetrics());
+    }
+}
+BENCHMARK(BM_GetHealthMetrics);
+
+static void BM_GetHealthSnapshot(benchmark::State& state) {
+    EquipmentController controller;
+    controller.initialize(makeOfflineConfig());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(controller.getHealthSnapshot());
+    }
+}
+BENCHMARK(BM_GetHealthSnapshot);
+
+#ifndef _WIN32
+// Full runTest() round trip through a pseudo-terminal fake device
+static void BM_LoopbackRunTest(benchmark::State& state) {
+    FakeSerialDevice device([](const std::string& command) -> std::string {
+        return command.rfind("TEST:", 0) == 0 ? "RESULT:4.98:V:PASS\r\n" : "";
+    });
+    EquipmentController controller;
+    if (!device.valid() || !controller.initialize(makeFakeDeviceConfig(device.port())) || !controller.start()) {
+        state.SkipWithError("Fake device unavailable");
+        return;
+    }
+
+    std::vector<std::string> params = {"voltage", "5.0"};
+    for (auto _ : state) {
+        TestResult result = controller.runTest("device_1", params);
+        if (!result.passed) {
+            state.SkipWithError(result.notes.c_str());
+            break;
+        }
+    }
+    controller.stop();
+}
+BENCHMARK(BM_LoopbackRunTest)->UseRealTime();
+
+static void BM_LoopbackRunTestInto(benchmark::State& state) {
+    FakeSerialDevice device([](const std::string& command) -> std::string {
+        return command.rfind("TEST:", 0) == 0 ? "RESULT:4.98:V:PASS\r\n" : "";
+    });
+    EquipmentController controller;
+    if (!device.valid() || !controller.initialize(makeFakeDeviceConfig(device.port())) || !controller.start()) {
+        state.SkipWithError("Fake device unavailable");
+        return;
+    }
+
+    std::string device_id = "device_1";
+    std::vector<std::string> params = {"voltage", "5.0"};
+    TestOutcome outcome;
+    for (auto _ : state) {
+        if (!controller.runTestInto(device_id, params, outcome)) {
+            state.SkipWithError(outcomeNote(outcome.code));
+            break;
+        }
+    }
+    controller.stop();
+}
+BENCHMARK(BM_LoopbackRunTestInto)->UseRealTime();
+
+// Export throughput, including the write to disk
+static void BM_CsvExportStore(benchmark::State& state) {
+    ResultStore store;
+    auto rows = static_cast<size_t>(state.range(0));
+    store.reserve(rows);
+    ResultRecord record{};
+    record.unit = UnitCode::VOLT;
+    record.timestamp_us = toEpochMicros(std::chrono::system_clock::now());
+    record.device_index = store.internDevice("bench_board");
+    for (size_t i = 0; i < rows; ++i) {
+        record.test_id = i + 1;
+        record.timestamp_us += 250;
+        record.value = 12.0 + static_cast<double>(i % 1000) * 0.001;
+        record.passed = (i % 50) != 0;
+        store.append(record);
+    }
+
+    CsvExporter exporter;
+    for (auto _ : state) {
+        if (!exporter.exportStore(store, "bench_export.csv")) {
+            state.SkipWithError("export failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * exporter.getStats().bytes));
+    std::remove("bench_export.csv");
+}
+BENCHMARK(BM_CsvExportStore)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,190 @@
+/**
+ * @file async_logger.h
+ * @brief Asynchronous, batching text logger with file rotation
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include "mpsc_queue.h"
+#include "result_store.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Log message severity
+ */
+enum class LogLevel : std::uint8_t {
+    DEBUG,
+    INFO,
+    WARNING,
+    ERROR
+};
+
+/**
+ * @brief Logger tuning
+ */
+struct LoggerOptions {
+    size_t queue_capacity = 8192;             ///< Messages buffered before producers start dropping
+    size_t max_file_bytes = 10 * 1024 * 1024; ///< Rotate once the file reaches this size; 0 disables
+    int rotate_interval_s = 0;                ///< Rotate after this many seconds; 0 disables
+    int max_files = 5;                        ///< Rotated files kept as path.1 ... path.N
+    int flush_interval_ms = 20;               ///< How often the flusher polls the queue
+};
+
+/**
+ * @brief One queued log message
+ *
+ * Fixed size so the queue never allocates. Results are queued as packed
+ * records and only formatted as text on the flusher thread.
+ */
+struct LogEntry {
+    static constexpr size_t SOURCE_CAPACITY = 32;
+    static constexpr size_t TEXT_CAPACITY = 192;
+
+    enum class Kind : std::uint8_t { TEXT, RESULT };
+
+    Kind kind;
+    LogLevel level;
+    std::int64_t timestamp_us;      ///< Enqueue time, microseconds since the Unix epoch
+    ResultRecord result;            ///< RESULT entries only
+    char source[SOURCE_CAPACITY];   ///< e.g. the controller's port; NUL-terminated
+    char text[TEXT_CAPACITY];       ///< Message, or device ID for RESULT entries; NUL-terminated
+};
+
+/**
+ * @brief Logger whose producers never block or make syscalls
+ *
+ * log() and logResult() copy into a preallocated slot of a lock-free MPSC
+ * queue and return. A background flusher drains the queue every
+ * flush_interval_ms, formats the batch into one buffer and writes it with
+ * a single fwrite()/fflush(), rotating the file by size or age. When the
+ * queue is full messages are dropped and counted, and the flusher records
+ * how many were lost. Messages longer than LogEntry::TEXT_CAPACITY are
+ * truncated.
+ */
+class AsyncLogger {
+public:
+    /**
+     * @brief Get the logger for a path, creating it on first use
+     *
+     * Controllers configured with the same log file share one logger and
+     * therefore one file and flusher. Options only apply when the logger
+     * is created.
+     *
+     * @param path Log file path
+     * @param options Logger tuning
+     * @return Shared logger; check isOpen() for failures
+     */
+    static std::shared_ptr<AsyncLogger> forPath(const std::string& path, const LoggerOptions& options = {});
+
+    /**
+     * @brief Constructor; opens the file and starts the flusher
+     * @param path Log file path, appended to if it exists
+     * @param options Logger tuning
+     */
+    explicit AsyncLogger(const std::string& path, const LoggerOptions& options = {});
+
+    /**
+     * @brief Destructor; writes all queued messages and stops the flusher
+     */
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    /**
+     * @brief Check whether the log file could be opened
+     * @return true if open
+     */
+    bool isOpen() const { return fileOpen.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Queue a text message
+     * @param level Severity
+     * @param source Originator, e.g. a port name
+     * @param message Message text
+     * @return false if the queue was full and the message was dropped
+     */
+    bool log(LogLevel level, std::string_view source, std::string_view message);
+
+    /**
+     * @brief Queue a test outcome
+     * @param source Originator
+     * @param device_id Device identifier
+     * @param outcome Test outcome
+     * @return false if dropped
+     */
+    bool logResult(std::string_view source, std::string_view device_id, const TestOutcome& outcome);
+
+    /**
+     * @brief Queue a test result
+     * @param source Originator
+     * @param result Test result
+     * @return false if dropped
+     */
+    bool logResult(std::string_view source, const TestResult& result);
+
+    /**
+     * @brief Block until messages queued by this thread have been written
+     */
+    void flush();
+
+    /**
+     * @brief Get number of messages dropped because the queue was full
+     * @return Dropped message count
+     */
+    std::uint64_t droppedMessages() const { return dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the log file path
+     * @return Path
+     */
+    const std::string& path() const { return filePath; }
+
+private:
+    bool enqueue(LogEntry::Kind kind, LogLevel level, std::string_view source, std::string_view text,
+                 const ResultRecord* result);
+    void flusherLoop();
+    size_t drain();
+    void appendEntry(const LogEntry& entry);
+    void rotateIfNeeded();
+    void openFile();
+
+    std::string filePath;
+    LoggerOptions options;
+    MpscQueue<LogEntry> queue;
+    std::atomic<std::uint64_t> dropped;
+    std::uint64_t reportedDrops;
+
+    // Flusher-owned output state
+    std::FILE* file;
+    size_t fileBytes;
+    std::chrono::steady_clock::time_point fileOpened;
+    std::string batch;
+    std::atomic<bool> fileOpen;
+
+    std::thread flusher;
+    std::atomic<bool> stopping;
+    std::atomic<std::uint64_t> flushRequests;
+    std::atomic<std::uint64_t> flushesDone;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+};
+
+} // namespace MechatronicTest
+
+#endif // ASYNC_LOGGER_H
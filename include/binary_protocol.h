@@ -0,0 +1,140 @@
+/**
+ * @file binary_protocol.h
+ * @brief Compact binary command/response protocol with CRC
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include "equipment_controller.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Frame types of the binary protocol
+ */
+enum class BinaryOpcode : std::uint8_t {
+    TEST = 0x01,        ///< Payload: device, then parameters, each length-prefixed
+    BATCH = 0x02,       ///< Payload: device count, devices, then parameters; one RESULT per device
+    CALIBRATE = 0x03,   ///< Empty payload
+    RESULT = 0x81,      ///< Payload: float32 value, unit code, verdict (1 = PASS)
+    CHANNELS = 0x82,    ///< Payload: first channel LE16, then float32 readings; precedes its RESULT
+    CALIBRATED = 0x83,  ///< Empty payload
+    ERROR = 0xFF        ///< Payload: device-specific error code
+};
+
+/** ASCII request that switches a link to the binary protocol */
+constexpr std::string_view BINARY_PROTOCOL_REQUEST = "PROTO:BIN1";
+/** Device acknowledgement; binary frames follow on both sides */
+constexpr std::string_view BINARY_PROTOCOL_ACK = "PROTO_OK:BIN1";
+
+constexpr size_t BINARY_MAX_PAYLOAD = 255;
+/** length, opcode, 16-bit sequence, CRC */
+constexpr size_t BINARY_FRAME_OVERHEAD = 6;
+/** Most readings carried by one CHANNELS frame */
+constexpr size_t BINARY_CHANNELS_PER_FRAME = (BINARY_MAX_PAYLOAD - 2) / 4;
+
+/**
+ * @brief A decoded binary frame
+ *
+ * On the wire the frame is [length][opcode][sequence LE16][payload][CRC LE16],
+ * where the CRC-16/CCITT covers everything before it. The whole frame is
+ * COBS-encoded and followed by a 0x00 delimiter, so a receiver can split
+ * frames with the same framer used for ASCII lines and resynchronise after
+ * noise at the next delimiter.
+ */
+struct BinaryFrame {
+    BinaryOpcode opcode;
+    std::uint16_t sequence;  ///< Echoed in replies; 0 for untagged commands
+    std::uint8_t length;
+    unsigned char payload[BINARY_MAX_PAYLOAD];
+};
+
+/**
+ * @brief Result of decoding a wire frame
+ */
+enum class BinaryDecodeStatus {
+    OK,
+    MALFORMED,  ///< Bad COBS encoding or a length that does not match
+    BAD_CRC     ///< Well-formed but corrupted in transit
+};
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF)
+ */
+std::uint16_t crc16(const void* data, size_t length);
+
+/**
+ * @brief Append one encoded frame, including its delimiter
+ * @return false if the payload is longer than BINARY_MAX_PAYLOAD
+ */
+bool appendBinaryFrame(std::string& out, BinaryOpcode opcode, std::uint16_t sequence,
+                       const void* payload, size_t length);
+
+/**
+ * @brief Decode one delimited frame, as returned by the framer without its 0x00
+ */
+BinaryDecodeStatus decodeBinaryFrame(std::string_view encoded, BinaryFrame& frame);
+
+/**
+ * @brief Encode a TEST command; the binary counterpart of formatTestCommand()
+ * @param command Destination; cleared first so its capacity is reused
+ * @return false if the device or parameters do not fit in one frame
+ */
+bool encodeTestCommand(std::string& command, std::uint16_t sequence, std::string_view device_id,
+                       const std::vector<std::string>& test_parameters);
+
+/**
+ * @brief Encode a BATCH command for devices [first, last)
+ * @param command Destination; cleared first so its capacity is reused
+ * @return false if the devices or parameters do not fit in one frame
+ */
+bool encodeBatchCommand(std::string& command, std::uint16_t sequence, const std::vector<std::string>& device_ids,
+                        size_t first, size_t last, const std::vector<std::string>& test_parameters);
+
+/**
+ * @brief Append a RESULT reply, as a device would send it
+ */
+void appendResultFrame(std::string& out, std::uint16_t sequence, float value, UnitCode unit, bool passed);
+
+/**
+ * @brief Append the CHANNELS frames for a multi-channel reply, as a device would send them
+ *
+ * Readings are split into frames of up to BINARY_CHANNELS_PER_FRAME; the
+ * RESULT frame with the same sequence follows them and carries channel 0.
+ */
+void appendChannelFrames(std::string& out, std::uint16_t sequence, const double* readings, size_t count);
+
+/**
+ * @brief Add a CHANNELS frame's readings to those of earlier frames
+ *
+ * Channels skipped by a lost frame are left as NaN, so that limit checks fail them.
+ *
+ * @return false for any other frame type or a malformed payload
+ */
+bool parseBinaryChannels(const BinaryFrame& frame, std::vector<double>& readings);
+
+/**
+ * @brief Fill an outcome from a RESULT frame
+ * @return false for any other frame type or a short payload
+ */
+bool parseBinaryResult(const BinaryFrame& frame, TestOutcome& outcome);
+
+/**
+ * @brief Split length-prefixed strings from a payload, starting at offset
+ * @param fields Views into frame.payload
+ * @return false if a length runs past the end of the payload
+ */
+bool splitBinaryFields(const BinaryFrame& frame, size_t offset, std::vector<std::string_view>& fields);
+
+} // namespace MechatronicTest
+
+#endif // BINARY_PROTOCOL_H
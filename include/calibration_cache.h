@@ -0,0 +1,109 @@
+/**
+ * @file calibration_cache.h
+ * @brief On-disk cache of per-fixture calibration profiles
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef CALIBRATION_CACHE_H
+#define CALIBRATION_CACHE_H
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Outcome of a fixture's last successful calibration
+ */
+struct CalibrationProfile {
+    std::string fixture_id;
+    std::chrono::system_clock::time_point calibrated_at;
+    std::string data;  ///< Device's calibration reply, e.g. "CAL_OK:gain=1.002"
+};
+
+/**
+ * @brief Check whether a profile is still inside its validity window
+ * @param profile Calibration profile
+ * @param validity How long a calibration stays valid
+ * @param now Current time
+ * @return false once validity has elapsed, or if calibrated_at lies in the future
+ */
+bool calibrationValid(const CalibrationProfile& profile, std::chrono::seconds validity,
+                      std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+/**
+ * @brief Small text file holding the latest calibration of each fixture
+ *
+ * One line per fixture: "<fixture>\t<calibrated_at, us since epoch>\t<data>".
+ * Every lookup re-reads the file and every update rewrites it through a
+ * temporary file and rename(), so readers never see a partial file and
+ * calibrations recorded by other processes are picked up. Within one
+ * process, controllers sharing a path should share one cache (see
+ * forPath()) so their updates are serialized and none are lost.
+ */
+class CalibrationCache {
+public:
+    /**
+     * @brief Get the cache for a file, shared by everyone using the same path
+     * @param path Cache file path
+     * @return Shared cache
+     */
+    static std::shared_ptr<CalibrationCache> forPath(const std::string& path);
+
+    /**
+     * @brief Constructor; the file is created on the first store()
+     * @param path Cache file path
+     */
+    explicit CalibrationCache(std::string path);
+
+    /**
+     * @brief Look up a fixture's profile
+     * @param fixture_id Fixture identifier
+     * @param profile Receives the profile if found
+     * @return true if the fixture has a cached profile
+     */
+    bool find(const std::string& fixture_id, CalibrationProfile& profile) const;
+
+    /**
+     * @brief Record a profile, replacing the fixture's previous one
+     * @param profile Profile; fixture_id and data must not contain tabs or newlines
+     * @return false if the profile is invalid or the file could not be written
+     */
+    bool store(const CalibrationProfile& profile);
+
+    /**
+     * @brief Forget a fixture's profile, e.g. after a failed calibration
+     * @param fixture_id Fixture identifier
+     * @return false if the file could not be written
+     */
+    bool erase(const std::string& fixture_id);
+
+    /**
+     * @brief Get the cache file path
+     */
+    const std::string& path() const { return filePath; }
+
+    /**
+     * @brief Get last error message
+     * @return Error message
+     */
+    std::string getLastError() const;
+
+private:
+    using Profiles = std::map<std::string, CalibrationProfile>;
+
+    Profiles readFile() const;
+    bool writeFile(const Profiles& profiles);
+
+    std::string filePath;
+    mutable std::mutex mutex;
+    std::string lastError;
+};
+
+} // namespace MechatronicTest
+
+#endif // CALIBRATION_CACHE_H
@@ -14,6 +14,16 @@
 #include <functional>
 #include <mutex>
 #include <thread>
+#include <future>
+#include <string_view>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+
+#include "line_framer.h"
+#include "latency_histogram.h"
+#include "response_timeout.h"
+#include "spc_monitor.h"
 
 namespace MechatronicTest {
 
@@ -28,6 +38,21 @@ enum class EquipmentStatus {
     MAINTENANCE
 };
 
+/**
+ * @brief How a test ended
+ */
+enum class OutcomeCode : std::uint8_t {
+    COMPLETED,
+    NOT_RUNNING,
+    NOT_CONNECTED,
+    PIPELINE_BUSY,
+    SEND_FAILED,
+    NO_RESPONSE,
+    INVALID_RESPONSE,
+    CORRUPT_RESPONSE,  ///< Binary frame failed its CRC
+    STREAMING          ///< A stream owns the link until stopStream()
+};
+
 /**
  * @brief Test result structure
  */
@@ -39,25 +64,247 @@ struct TestResult {
     std::string units;
     std::string timestamp;
     std::string notes;
+    std::chrono::system_clock::time_point completed_at;  ///< Same instant as timestamp, unformatted
+    std::vector<double> measurements;             ///< Every channel reading; measurement_value is channel 0
+    std::vector<std::uint32_t> failed_channels;   ///< Channels outside their host-side limits
+    OutcomeCode outcome = OutcomeCode::COMPLETED;  ///< How the test ended; notes describe it for people
 };
 
+/**
+ * @brief Interned measurement units
+ */
+enum class UnitCode : std::uint8_t {
+    NONE,
+    VOLT,
+    MILLIVOLT,
+    AMPERE,
+    MILLIAMPERE,
+    OHM,
+    KILOOHM,
+    WATT,
+    HERTZ,
+    CELSIUS,
+    SECOND,
+    MILLISECOND,
+    MILLIMETER,
+    NEWTON,
+    OTHER
+};
+
+/**
+ * @brief Fixed-size test result that never touches the heap
+ *
+ * Filled by EquipmentController::runTestInto(); the timestamp is only
+ * formatted if the outcome is converted for reporting.
+ */
+struct TestOutcome {
+    OutcomeCode code;
+    bool passed;
+    UnitCode unit;
+    char units[8];  ///< Units as reported, NUL-terminated, truncated if longer
+    double measurement_value;      ///< Channel 0 of a multi-channel reply
+    std::uint32_t channel_count;   ///< Readings in the reply
+    std::uint32_t failed_channels; ///< Channels outside their limits; 0 without host-side limits
+    std::chrono::system_clock::time_point timestamp;
+};
+
+/**
+ * @brief Point-in-time copy of a controller's health counters
+ *
+ * Counts cover tests since the controller was created; calls rejected
+ * because the equipment was not running are not counted.
+ */
+struct HealthSnapshot {
+    std::uint64_t tests_run;
+    std::uint64_t tests_passed;
+    std::uint64_t tests_failed;     ///< Completed with a FAIL verdict
+    std::uint64_t errors;           ///< Ended without a valid result, e.g. send failure or timeout
+    std::uint64_t timeouts;         ///< Errors where the device did not answer
+    std::uint64_t retries;          ///< Extra attempts made by the retry policy
+    std::uint64_t recovered_by_retry;  ///< Tests that completed only after a retry
+    std::uint64_t bytes_sent;       ///< Over the current hardware link
+    std::uint64_t bytes_received;   ///< Over the current hardware link
+    double failure_rate;            ///< tests_failed / tests_run
+    double error_rate;              ///< errors / tests_run
+    double mean_response_ms;        ///< Mean send-to-response time of synchronous tests
+    double uptime_s;                ///< Seconds since initialize(), 0 before
+};
+
+/**
+ * @brief Settings of a streaming acquisition, see EquipmentController::startStream()
+ */
+struct StreamOptions {
+    size_t block_samples = 1024;  ///< Samples per SampleBlock
+    size_t ring_blocks = 64;      ///< Blocks buffered for the consumer, rounded up to a power of two
+    int max_block_age_ms = 50;    ///< Hand over a partly filled block after this long, so slow streams still arrive
+};
+
+/**
+ * @brief A chunk of streamed samples, in a buffer reused for the whole stream
+ */
+struct SampleBlock {
+    std::uint64_t sequence;      ///< Blocks since the stream started; a gap means blocks were dropped
+    std::uint64_t first_sample;  ///< Stream position of samples[0]
+    std::chrono::steady_clock::time_point received;  ///< Arrival of the last sample
+    std::vector<double> samples;  ///< At most StreamOptions::block_samples; capacity never changes
+};
+
+/**
+ * @brief Counters of a streaming acquisition
+ */
+struct StreamStats {
+    std::uint64_t blocks;           ///< Handed to the consumer
+    std::uint64_t samples;          ///< Handed to the consumer
+    std::uint64_t dropped_blocks;   ///< Discarded because the consumer had not freed a block
+    std::uint64_t dropped_samples;
+    std::uint64_t missed_frames;    ///< DATA frames the device numbered but that never arrived
+    std::uint64_t malformed_frames;
+    bool device_ended;              ///< The device acknowledged the stop with STREAM:END
+    bool link_lost;                 ///< The connection failed while streaming
+};
+
+/**
+ * @brief Map a units string to its interned code
+ * @param units Units as reported by the device
+ * @return Unit code, OTHER if not recognized
+ */
+UnitCode unitCodeFromString(std::string_view units);
+
+/**
+ * @brief Get the canonical units string for a code
+ * @param unit Unit code
+ * @return Static string, "?" for OTHER
+ */
+const char* unitCodeToString(UnitCode unit);
+
+/**
+ * @brief Get the TestResult notes text for an outcome code
+ * @param code Outcome code
+ * @return Static string
+ */
+const char* outcomeNote(OutcomeCode code);
+
+/**
+ * @brief Parse a "RESULT:value[,value...]:units:status" frame
+ *
+ * Multi-channel replies list one reading per channel, comma-separated;
+ * measurement_value is the first. Allocation-free once readings has
+ * grown to the reply's channel count.
+ *
+ * @param frame Response frame
+ * @param outcome Receives value, units, channel count and pass flag on success
+ * @param readings Optional; receives every reading
+ * @return true if the frame is a well-formed RESULT
+ */
+bool parseResultFrame(std::string_view frame, TestOutcome& outcome, std::vector<double>* readings = nullptr);
+
+/**
+ * @brief Parse a "DATA:<sequence>:sample[,sample...]" streaming frame
+ *
+ * Allocation-free once samples has grown to the frame's sample count.
+ *
+ * @param frame Streaming frame
+ * @param sequence Receives the device's frame counter
+ * @param samples Receives the samples
+ * @return true if the frame is a well-formed DATA frame
+ */
+bool parseSampleFrame(std::string_view frame, std::uint64_t& sequence, std::vector<double>& samples);
+
+/**
+ * @brief Format a time as local "YYYY-MM-DD HH:MM:SS" into a caller buffer
+ * @param when Time to format
+ * @param buffer Destination, at least 20 bytes
+ * @param length Destination capacity
+ * @return Characters written, excluding the terminating NUL
+ */
+size_t formatTimestamp(std::chrono::system_clock::time_point when, char* buffer, size_t length);
+
+/**
+ * @brief Format a time as local "YYYY-MM-DD HH:MM:SS"
+ * @param when Time to format
+ * @return Formatted timestamp
+ */
+std::string formatTimestamp(std::chrono::system_clock::time_point when);
+
 /**
  * @brief Equipment configuration structure
  */
 struct EquipmentConfig {
+    std::string interface_type = "serial";  ///< createHardwareInterface() type: "serial", "tcp", "usb" or "sim"
     std::string device_port;
     int baud_rate;
     double measurement_tolerance;
-    int max_retry_attempts;
+    int max_retry_attempts = 3;   ///< Retries of a failed synchronous test; see RetryPolicy
+    double retry_backoff_ms = 10.0;      ///< Wait before the first retry; doubles with each retry
+    double retry_max_backoff_ms = 500.0;
+    double retry_jitter = 0.5;           ///< Randomized fraction of each wait, 0..1
+    bool retry_on_timeout = false;       ///< Off by default: each retry of a dead fixture waits out another timeout
+    bool retry_on_invalid_response = true;
+    bool retry_on_corrupt_response = true;
+    bool retry_on_send_failure = true;
+    bool adaptive_timeouts = true;         ///< Learn response timeouts per device type and command; see ResponseTimeoutEstimator
+    int response_timeout_floor_ms = 50;    ///< Shortest learned timeout
+    int response_timeout_ceiling_ms = 5000;  ///< Longest timeout, and the timeout until responses have been seen
+    double response_timeout_k = 4.0;       ///< Mean deviations of response time tolerated before timing out
     bool enable_logging;
     std::string log_file_path;
+    int pipeline_depth = 1;  ///< Test commands kept in flight by submitTest(); >1 enables sequence tags, also on runTest()
+    bool batch_commands = false;  ///< Firmware accepts multi-device "BATCH:" commands
+    int max_batch_size = 32;      ///< Most devices encoded in one BATCH command
+    std::string journal_file_path;  ///< Binary result journal; used when enable_logging is set
+    std::string station_id;         ///< Recorded in the journal header; defaults to device_port
+    bool serial_low_latency = true;  ///< Set ASYNC_LOW_LATENCY on USB-serial adapters that support it
+    int serial_vmin = 0;             ///< termios VMIN
+    int serial_vtime_ds = 0;         ///< termios VTIME, tenths of a second
+    bool serial_sync_writes = true;  ///< Open the port with O_SYNC; false skips it for lower write latency
+    bool binary_protocol = false;    ///< Offer the binary framed protocol at initialize(); ASCII if the device declines
+    // Host-side limits (see channelLimitsFrom()); when any are set, the host's
+    // verdict on every channel replaces the device's PASS/FAIL
+    std::vector<double> channel_nominal;      ///< Channel i passes within nominal[i] +/- measurement_tolerance
+    std::vector<double> channel_lower_limit;  ///< Per-channel lower limits; override the tolerance band where given
+    std::vector<double> channel_upper_limit;  ///< Per-channel upper limits; override the tolerance band where given
+    std::string calibration_cache_path;       ///< Per-fixture calibration profiles (CalibrationCache); empty disables
+    std::string fixture_id;                   ///< Calibration cache key; defaults to station_id, then device_port
+    int calibration_validity_s = 8 * 3600;    ///< How long a calibration stays valid; 0 always recalibrates
+    int calibration_timeout_seconds = 10;     ///< Longest wait for the device to acknowledge CALIBRATE
+    bool spc_enabled = true;                  ///< Track completed measurements with an SpcMonitor
+    int spc_baseline_samples = 25;            ///< Samples per device type and test that set its control limits
 };
 
+/**
+ * @brief Handle for a test submitted with EquipmentController::submitTest()
+ *
+ * Tickets increase monotonically per controller; 0 means the submission failed.
+ */
+using TestTicket = std::uint64_t;
+
+/**
+ * @brief Format a "[#<tag>:]TEST:<device>[:<param>...]" command
+ * @param command Destination; cleared first so its capacity is reused
+ * @param tag Sequence tag for pipelined commands, 0 for none
+ * @param device_id Device identifier
+ * @param test_parameters Test parameters
+ */
+void formatTestCommand(std::string& command, TestTicket tag, std::string_view device_id,
+                       const std::vector<std::string>& test_parameters);
+
+/**
+ * @brief Callback function type for asynchronous test completion
+ */
+using TestCallback = std::function<void(const TestResult&)>;
+
 /**
  * @brief Callback function type for status updates
  */
 using StatusCallback = std::function<void(EquipmentStatus, const std::string&)>;
 
+/**
+ * @brief Handle for a listener added with EquipmentController::addStatusListener()
+ *
+ * 0 is never a valid listener.
+ */
+using StatusListenerId = std::uint64_t;
+
 /**
  * @brief Main equipment controller class
  */
@@ -112,12 +359,160 @@ public:
      */
     TestResult runTest(const std::string& device_id, const std::vector<std::string>& test_parameters);
 
+    /**
+     * @brief Run a test without heap allocation in steady state
+     *
+     * Same protocol as runTest(), but the result is written into a
+     * caller-owned fixed-size record; runTest() is this plus conversion.
+     * Multi-channel readings go into an optional caller-owned vector that
+     * only allocates while it grows.
+     *
+     * @param device_id Device identifier
+     * @param test_parameters Test parameters
+     * @param outcome Receives the result
+     * @param readings Optional; receives every channel reading of a completed test
+     * @return true if a well-formed RESULT was received
+     */
+    bool runTestInto(const std::string& device_id, const std::vector<std::string>& test_parameters,
+                     TestOutcome& outcome, std::vector<double>* readings = nullptr);
+
+    /**
+     * @brief Run a test on the controller's worker thread
+     *
+     * Returns immediately; tests queued this way run one after another in
+     * submission order. Tests still queued when the controller is destroyed
+     * are discarded.
+     *
+     * @param device_id Device identifier
+     * @param test_parameters Test parameters
+     * @param callback Called with the result on the worker thread
+     */
+    void runTestAsync(const std::string& device_id, const std::vector<std::string>& test_parameters,
+                      TestCallback callback);
+
+    /**
+     * @brief Run a test on the controller's worker thread
+     * @param device_id Device identifier
+     * @param test_parameters Test parameters
+     * @return Future that becomes ready with the test result
+     */
+    std::future<TestResult> runTestAsync(const std::string& device_id,
+                                         const std::vector<std::string>& test_parameters);
+
+    /**
+     * @brief Send a test command without waiting for its response
+     *
+     * Up to EquipmentConfig::pipeline_depth commands are kept in flight; when
+     * the window is full this first waits for the oldest response. With a
+     * window above one, commands go out as "#<ticket>:TEST:..." and the device
+     * is expected to echo the tag so responses can arrive in any order;
+     * untagged responses are matched to the oldest outstanding command.
+     *
+     * @param device_id Device identifier
+     * @param test_parameters Test parameters
+     * @return Ticket for the submitted test, or 0 on failure (see getLastError())
+     */
+    TestTicket submitTest(const std::string& device_id, const std::vector<std::string>& test_parameters);
+
+    /**
+     * @brief Wait for all outstanding submitted tests
+     * @param timeout_ms Maximum total wait; tests still unanswered are reported as failed
+     * @return Results of all tests completed since the last call, in submission order
+     */
+    std::vector<TestResult> collectResults(int timeout_ms = 5000);
+
+    /**
+     * @brief Run the same test on many devices
+     *
+     * Controller state is checked once and the timestamps are shared by the
+     * whole batch. When EquipmentConfig::batch_commands is set, devices are
+     * sent as "BATCH:dev1,dev2,...:params" commands of at most max_batch_size
+     * devices, each answered by one RESULT line per device in order;
+     * otherwise each device gets its own TEST command, pipelined up to
+     * pipeline_depth.
+     *
+     * @param device_ids Device identifiers
+     * @param test_parameters Test parameters shared by all devices
+     * @return One result per device, in the order given
+     */
+    std::vector<TestResult> runTestBatch(const std::vector<std::string>& device_ids,
+                                         const std::vector<std::string>& test_parameters);
+
+    /**
+     * @brief Get number of submitted tests still awaiting a response; never blocks
+     * @return Outstanding test count
+     */
+    size_t pendingTests() const;
+
+    /**
+     * @brief Start streaming sample data from a device
+     *
+     * Sends "STREAM:<device>[:params]"; after the device answers STREAM:OK,
+     * a reader thread owns the link and parses its "DATA:<seq>:samples"
+     * frames into SampleBlocks in a lock-free single-producer,
+     * single-consumer ring allocated here. Nothing is allocated while
+     * streaming, so memory stays constant however long the capture runs.
+     * When the consumer falls behind and the ring is full, new blocks are
+     * dropped and counted rather than buffered.
+     *
+     * Tests, submissions and calibration fail at once with
+     * OutcomeCode::STREAMING until stopStream(); collectResults() returns
+     * nothing meanwhile. Requires the ASCII protocol.
+     *
+     * @param device_id Device identifier
+     * @param stream_parameters Parameters appended to the STREAM command
+     * @param options Block size and buffering
+     * @return false if not running, already streaming, or the device refused (see getLastError())
+     */
+    bool startStream(const std::string& device_id, const std::vector<std::string>& stream_parameters,
+                     const StreamOptions& options = {});
+
+    /**
+     * @brief Hand buffered blocks to a function, waiting for the first
+     *
+     * Call from one thread at a time. Blocks not read before stopStream()
+     * can still be read afterwards, until the next startStream().
+     *
+     * @param handler Called with each block; the block is reused once it returns
+     * @param timeout_ms Maximum wait for a block
+     * @return Blocks handled; 0 on timeout or once a stopped stream is drained
+     */
+    size_t readStream(const std::function<void(const SampleBlock&)>& handler, int timeout_ms = 100);
+
+    /**
+     * @brief Send STREAM:STOP, wait for STREAM:END and stop the reader thread
+     * @return Final counters
+     */
+    StreamStats stopStream();
+
+    /**
+     * @brief Check whether the reader thread is receiving a stream
+     */
+    bool isStreaming() const;
+
+    /**
+     * @brief Get counters of the current or last stream
+     */
+    StreamStats getStreamStats() const;
+
     /**
      * @brief Get current equipment status
      * @return Current status
      */
     EquipmentStatus getStatus() const;
 
+    /**
+     * @brief Check whether the hardware link is up; never blocks, even while a test or stream runs
+     * @return true if the hardware interface is connected
+     */
+    bool isConnected() const;
+
+    /**
+     * @brief Check whether initialize() switched the link to the binary protocol
+     * @return true if commands and responses use binary frames
+     */
+    bool usingBinaryProtocol() const;
+
     /**
      * @brief Get last error message
      * @return Error message
@@ -126,22 +521,137 @@ public:
 
     /**
      * @brief Set status callback function
-     * @param callback Callback function
+     *
+     * Replaces the callback set by a previous call; listeners added with
+     * addStatusListener() are unaffected. Like all status listeners it runs
+     * on the controller's dispatcher thread, so it may call back into the
+     * controller. Consecutive updates with the same status that arrive
+     * faster than they are delivered are coalesced into the latest one.
+     *
+     * @param callback Callback function; empty to remove
      */
     void setStatusCallback(StatusCallback callback);
 
+    /**
+     * @brief Subscribe to status changes
+     * @param callback Listener, called on the dispatcher thread
+     * @return Listener handle
+     */
+    StatusListenerId addStatusListener(StatusCallback callback);
+
+    /**
+     * @brief Unsubscribe a status listener
+     * @param id Handle from addStatusListener()
+     * @return true if the listener was registered
+     */
+    bool removeStatusListener(StatusListenerId id);
+
+    /**
+     * @brief Wait until all status changes so far have been delivered
+     *
+     * Status events still queued when the controller is destroyed are
+     * discarded.
+     *
+     * @param timeout_ms Timeout in milliseconds
+     * @return true if delivery caught up within the timeout
+     */
+    bool waitForStatusEvents(int timeout_ms = 1000);
+
     /**
      * @brief Perform equipment calibration
-     * @return true if calibration successful, false otherwise
+     *
+     * Allowed while idle or running with no pipelined tests outstanding; the
+     * equipment is in MAINTENANCE while the device calibrates and then
+     * returns to its previous state. While the last calibration is within
+     * calibration_validity_s, including one loaded from the calibration
+     * cache at initialize(), this returns at once without contacting the
+     * device. A failed calibration invalidates the previous one, in memory
+     * and in the cache.
+     *
+     * @param force Recalibrate even if the current calibration is still valid
+     * @return true if calibration successful or still valid, false otherwise
+     */
+    bool calibrate(bool force = false);
+
+    /**
+     * @brief Perform equipment calibration on the controller's worker thread
+     *
+     * Queued behind tests already submitted with runTestAsync(), so a
+     * station can recalibrate between trays without blocking the caller.
+     *
+     * @param force Recalibrate even if the current calibration is still valid
+     * @return Future that becomes ready with the result of calibrate()
+     */
+    std::future<bool> calibrateAsync(bool force = false);
+
+    /**
+     * @brief Check whether the last calibration is within its validity window
+     * @return true if calibrate() would skip the device
+     */
+    bool calibrationValid() const;
+
+    /**
+     * @brief Get the time of the last successful calibration
+     * @return Calibration time, the epoch if the fixture has never been calibrated or the last calibration failed
      */
-    bool calibrate();
+    std::chrono::system_clock::time_point lastCalibration() const;
 
     /**
      * @brief Get equipment health metrics
-     * @return Health metrics as key-value pairs
+     * @return Health metrics as key-value pairs, built from getHealthSnapshot(),
+     *         followed by "Response_Timeout_Ms:<type>/<command>" and
+     *         "Smoothed_Response_Ms:<type>/<command>" for each learned timeout
      */
     std::vector<std::pair<std::string, double>> getHealthMetrics() const;
 
+    /**
+     * @brief Read the health counters without locking or allocating
+     * @return Snapshot of the counters
+     */
+    HealthSnapshot getHealthSnapshot() const;
+
+    /**
+     * @brief Get the learned response timeouts
+     * @return One entry per device type and command seen since initialize()
+     */
+    std::vector<ResponseTimeoutStats> getResponseTimeouts() const;
+
+    /**
+     * @brief Get running statistics of completed measurements
+     *
+     * Measurements of runTest(), runTestInto() and runTestBatch() are
+     * tracked per device type and test (the first test parameter), with
+     * channel 0's host-side limits as specification limits.
+     *
+     * @return One entry per device type and test
+     */
+    std::vector<SpcStats> getSpcStats() const;
+
+    /**
+     * @brief Set the function told when a measurement violates a control-chart rule
+     *
+     * Called on the thread that ran the test, before the test call returns;
+     * it must not start tests on this controller. Alarms are also logged.
+     *
+     * @param callback Alarm handler; null stops reporting
+     */
+    void setSpcAlarmCallback(SpcAlarmCallback callback);
+
+    /**
+     * @brief Get latency percentiles for each stage of runTest()/runTestInto()
+     *
+     * Only tests that complete successfully are timed. Stages are recorded
+     * into lock-free histograms, so this can be polled while tests run.
+     *
+     * @return Per-stage count, mean, p50, p99, p99.9 and max in microseconds
+     */
+    LatencyReport getLatencyReport() const;
+
+    /**
+     * @brief Discard all recorded latencies
+     */
+    void resetLatencyStats();
+
 private:
     class Impl;
     std::unique_ptr<Impl> pImpl;
@@ -149,20 +659,119 @@ private:
 
 /**
  * @brief Hardware interface class
+ *
+ * Each interface owns a persistent receive buffer. Implementations provide
+ * readAvailable(); framing, leftover bytes between calls and the default
+ * receiveResponse() are handled here.
  */
 class HardwareInterface {
 public:
     virtual ~HardwareInterface() = default;
+
+    /**
+     * @brief Take interface-specific settings before connect()
+     * @param config Equipment configuration
+     */
+    virtual void configure(const EquipmentConfig& config) { (void)config; }
+
     virtual bool connect(const std::string& port, int baud_rate) = 0;
     virtual bool disconnect() = 0;
     virtual bool sendCommand(const std::string& command) = 0;
-    virtual std::string receiveResponse(int timeout_ms = 1000) = 0;
+
+    /**
+     * @brief Send bytes exactly as given, without a line terminator
+     * @param data Bytes to send, e.g. encoded binary protocol frames
+     * @param length Number of bytes
+     * @return false if the interface cannot send raw bytes or the write failed
+     */
+    virtual bool sendRaw(const char* data, size_t length);
+
+    virtual std::string receiveResponse(int timeout_ms = 1000);
+
+    /**
+     * @brief Check whether the link is up; safe to call while another thread sends or receives
+     */
     virtual bool isConnected() const = 0;
+
+    /**
+     * @brief Switch received framing between ASCII lines and binary protocol frames
+     * @param binary true for 0x00-delimited binary frames, false for text lines
+     */
+    void setBinaryFraming(bool binary) { receiveBuffer.setFraming(binary ? '\0' : '\n', !binary); }
+
+    /**
+     * @brief Receive the next line-terminated frame
+     * @param timeout_ms Maximum time to wait for a complete frame
+     * @return View into the receive buffer without the terminator, valid until
+     *         the next receive call on this interface; empty on timeout or error
+     */
+    std::string_view receiveFrame(int timeout_ms = 1000);
+
+    /**
+     * @brief Drop buffered bytes and everything the device has already sent, without waiting
+     * @return Number of bytes dropped
+     */
+    size_t discardInput();
+
+    /**
+     * @brief Arrival times of the frame last returned by receiveFrame()
+     */
+    struct FrameTiming {
+        std::chrono::steady_clock::time_point first_byte;  ///< Read that delivered the frame's first byte
+        std::chrono::steady_clock::time_point terminator;  ///< Read that completed the frame
+    };
+
+    /**
+     * @brief Get arrival times of the last received frame
+     * @return Timing of the frame last returned by receiveFrame()
+     */
+    const FrameTiming& lastFrameTiming() const { return frameTiming; }
+
+    /**
+     * @brief Get total bytes written to the device
+     * @return Byte count, including terminators
+     */
+    std::uint64_t bytesSent() const { return sentBytes.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get total bytes read from the device
+     * @return Byte count
+     */
+    std::uint64_t bytesReceived() const { return receivedBytes.load(std::memory_order_relaxed); }
+
+protected:
+    /**
+     * @brief Account for bytes written; call from sendCommand() implementations
+     * @param bytes Bytes written
+     */
+    void countSent(size_t bytes) { sentBytes.fetch_add(bytes, std::memory_order_relaxed); }
+
+    /**
+     * @brief Wait until input is readable, then read whatever has arrived
+     * @param buffer Destination buffer
+     * @param length Capacity of the destination buffer
+     * @param timeout_ms Maximum time to wait for the first byte
+     * @return Number of bytes read, 0 on timeout, -1 on error
+     */
+    virtual long readAvailable(char* buffer, size_t length, int timeout_ms);
+
+    /**
+     * @brief Drop any buffered bytes, e.g. after (re)connecting
+     */
+    void resetReceiveBuffer() { receiveBuffer.clear(); }
+
+private:
+    LineFramer receiveBuffer{16384};  ///< Fits ASCII replies of several hundred channels
+    FrameTiming frameTiming;
+    std::chrono::steady_clock::time_point partialSince;  ///< Arrival of the oldest unconsumed byte
+    std::atomic<std::uint64_t> sentBytes{0};
+    std::atomic<std::uint64_t> receivedBytes{0};
 };
 
 /**
  * @brief Factory function to create hardware interface
- * @param interface_type Type of interface ("serial", "ethernet", "usb")
+ * @param interface_type Type of interface ("serial", "tcp" or its alias "ethernet", "usb" when built
+ *        with libusb, "sim")
  * @return Unique pointer to hardware interface
  */
 std::unique_ptr<HardwareInterface> createHardwareInterface(const std::string& interface_type);
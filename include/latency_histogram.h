@@ -0,0 +1,178 @@
+/**
+ * @file latency_histogram.h
+ * @brief Lock-free log-linear latency histograms for hot-path instrumentation
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Percentile summary of one histogram, in microseconds
+ */
+struct LatencySummary {
+    std::uint64_t count;
+    double mean_us;
+    double p50_us;
+    double p99_us;
+    double p999_us;
+    double max_us;
+};
+
+/**
+ * @brief HDR-style histogram of durations with ~3% relative precision
+ *
+ * Values below 64 ns get one bucket each; above that every power of two is
+ * split into 32 equal sub-buckets, up to about 73 minutes. record() is a
+ * handful of relaxed atomic increments, so any number of threads can
+ * record concurrently without locks; summaries read the buckets without
+ * stopping writers and may be off by the samples recorded meanwhile.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr std::uint64_t SUB_BUCKETS = 1ull << SUB_BUCKET_BITS;
+    static constexpr unsigned GROUPS = 37;
+    static constexpr size_t BUCKET_COUNT = 2 * SUB_BUCKETS + (GROUPS - 1) * SUB_BUCKETS;
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Record one duration
+     * @param nanoseconds Duration; values past the top bucket are clamped
+     */
+    void record(std::uint64_t nanoseconds) {
+        buckets[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+        std::uint64_t seen = maximum.load(std::memory_order_relaxed);
+        while (nanoseconds > seen &&
+               !maximum.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Record the time between two steady_clock readings
+     * @param begin Start of the interval
+     * @param end End of the interval; ignored if before begin
+     */
+    void record(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+        if (end >= begin) {
+            record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+        }
+    }
+
+    /**
+     * @brief Get number of recorded values
+     * @return Sample count
+     */
+    std::uint64_t count() const { return total.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Estimate a percentile
+     * @param percentile Percentile in [0, 100]
+     * @return Duration in nanoseconds, 0 if empty
+     */
+    std::uint64_t valueAtPercentile(double percentile) const;
+
+    /**
+     * @brief Summarize count, mean, p50, p99, p99.9 and max
+     * @return Summary in microseconds
+     */
+    LatencySummary summary() const;
+
+    /**
+     * @brief Discard all recorded values
+     */
+    void reset();
+
+    /**
+     * @brief Map a duration to its bucket
+     * @param nanoseconds Duration
+     * @return Bucket index
+     */
+    static size_t bucketIndex(std::uint64_t nanoseconds) {
+        if (nanoseconds < 2 * SUB_BUCKETS) {
+            return static_cast<size_t>(nanoseconds);
+        }
+        unsigned magnitude = 63u - static_cast<unsigned>(countLeadingZeros(nanoseconds));
+        unsigned group = magnitude - SUB_BUCKET_BITS;
+        if (group >= GROUPS) {
+            return BUCKET_COUNT - 1;
+        }
+        size_t sub = static_cast<size_t>((nanoseconds >> group) - SUB_BUCKETS);
+        return 2 * SUB_BUCKETS + (group - 1) * SUB_BUCKETS + sub;
+    }
+
+    /**
+     * @brief Get the largest duration that maps to a bucket
+     * @param index Bucket index
+     * @return Upper bound in nanoseconds
+     */
+    static std::uint64_t bucketUpperBound(size_t index);
+
+private:
+    static int countLeadingZeros(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(value);
+#else
+        int zeros = 0;
+        for (std::uint64_t bit = 1ull << 63; bit && !(value & bit); bit >>= 1) ++zeros;
+        return zeros;
+#endif
+    }
+
+    std::atomic<std::uint64_t> buckets[BUCKET_COUNT];
+    std::atomic<std::uint64_t> total;
+    std::atomic<std::uint64_t> sum;
+    std::atomic<std::uint64_t> maximum;
+};
+
+/**
+ * @brief Stages of a synchronous test timed by EquipmentController
+ */
+enum class LatencyStage : std::uint8_t {
+    BUILD,        ///< Formatting the test command
+    SEND,         ///< sendCommand()
+    FIRST_BYTE,   ///< From send completing to the first response byte
+    TERMINATOR,   ///< From the first byte to the frame terminator
+    PARSE,        ///< Parsing the response frame
+    TOTAL,        ///< Whole test, start to parsed result
+    COUNT
+};
+
+constexpr size_t LATENCY_STAGE_COUNT = static_cast<size_t>(LatencyStage::COUNT);
+
+/**
+ * @brief Get a display name for a stage
+ * @param stage Stage
+ * @return Static string, e.g. "first_byte"
+ */
+const char* latencyStageName(LatencyStage stage);
+
+/**
+ * @brief Per-stage summaries from EquipmentController::getLatencyReport()
+ */
+struct LatencyReport {
+    LatencySummary stages[LATENCY_STAGE_COUNT];
+
+    const LatencySummary& operator[](LatencyStage stage) const {
+        return stages[static_cast<size_t>(stage)];
+    }
+};
+
+} // namespace MechatronicTest
+
+#endif // LATENCY_HISTOGRAM_H
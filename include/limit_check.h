@@ -0,0 +1,89 @@
+/**
+ * @file limit_check.h
+ * @brief Host-side pass/fail evaluation of multi-channel measurements
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef LIMIT_CHECK_H
+#define LIMIT_CHECK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MechatronicTest {
+
+struct EquipmentConfig;
+
+/**
+ * @brief Inclusive per-channel limits, stored as two contiguous arrays
+ */
+struct ChannelLimits {
+    std::vector<double> lower;
+    std::vector<double> upper;
+
+    size_t channels() const { return lower.size(); }
+    bool empty() const { return lower.empty(); }
+};
+
+/**
+ * @brief Build the limits configured for an equipment
+ *
+ * Channel i uses channel_lower_limit[i] / channel_upper_limit[i] where
+ * given, otherwise channel_nominal[i] -/+ measurement_tolerance. A side
+ * with neither is unbounded. No channel settings means no host-side
+ * checking.
+ *
+ * @param config Equipment configuration
+ * @return Limits, one entry per channel
+ */
+ChannelLimits channelLimitsFrom(const EquipmentConfig& config);
+
+/**
+ * @brief Count readings outside [lower, upper], using SIMD where available
+ *
+ * Uses AVX2 on x86 CPUs that support it (selected at run time) and NEON on
+ * AArch64, with checkLimitsScalar() elsewhere. NaN readings fail.
+ *
+ * @param readings Values to check
+ * @param lower Lower limits, one per reading
+ * @param upper Upper limits, one per reading
+ * @param count Number of readings
+ * @param fail_mask Optional; receives bit i set for each failed reading, in
+ *        (count + 63) / 64 words that are cleared first
+ * @return Number of failed readings
+ */
+size_t checkLimits(const double* readings, const double* lower, const double* upper, size_t count,
+                   std::uint64_t* fail_mask);
+
+/**
+ * @brief Portable reference implementation of checkLimits()
+ */
+size_t checkLimitsScalar(const double* readings, const double* lower, const double* upper, size_t count,
+                         std::uint64_t* fail_mask);
+
+/**
+ * @brief Check a reply's readings against configured limits
+ *
+ * Channels the limits cover but the reply lacks count as failed; readings
+ * beyond the configured channels are not checked.
+ *
+ * @param limits Per-channel limits
+ * @param readings Reply readings
+ * @param count Number of readings
+ * @param fail_mask Resized to cover every channel; bit i set for each failed channel
+ * @return Number of failed channels
+ */
+size_t checkChannelLimits(const ChannelLimits& limits, const double* readings, size_t count,
+                          std::vector<std::uint64_t>& fail_mask);
+
+/**
+ * @brief Name of the implementation checkLimits() dispatches to
+ * @return "avx2", "neon" or "scalar"
+ */
+const char* limitCheckImplementation();
+
+} // namespace MechatronicTest
+
+#endif // LIMIT_CHECK_H
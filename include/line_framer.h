@@ -0,0 +1,95 @@
+/**
+ * @file line_framer.h
+ * @brief Persistent receive buffer and line tokenizer for hardware interfaces
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef LINE_FRAMER_H
+#define LINE_FRAMER_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Fixed-capacity receive buffer that splits incoming bytes into frames
+ *
+ * Bytes are read straight into the buffer's free tail and stay there until a
+ * complete frame has been consumed, so anything received after a terminator
+ * is kept for the next call. Unread bytes are slid back to the front only
+ * when the tail runs out, which keeps every frame contiguous and lets frames
+ * be handed out as views without copying.
+ */
+class LineFramer {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Buffer size in bytes; also the longest frame accepted
+     * @param terminator Frame terminator byte
+     */
+    explicit LineFramer(size_t capacity = 4096, char terminator = '\n');
+
+    /**
+     * @brief Make room for an incoming read
+     * @param length Set to the number of bytes that may be written
+     * @return Pointer to the free region; invalidates previously returned frames
+     */
+    char* prepareWrite(size_t& length);
+
+    /**
+     * @brief Account for bytes written into the region from prepareWrite()
+     * @param length Number of bytes actually written
+     */
+    void commitWrite(size_t length);
+
+    /**
+     * @brief Extract the next complete frame
+     *
+     * Trailing whitespace (including the '\r' of "\r\n") is stripped and empty
+     * lines are skipped. Only bytes that have not been scanned before are
+     * searched for the terminator. If the buffer fills up without a
+     * terminator, its contents are returned as one oversized frame so the
+     * stream cannot stall.
+     *
+     * @param frame View into the buffer, valid until the next prepareWrite()
+     * @return true if a frame was extracted, false if more bytes are needed
+     */
+    bool nextFrame(std::string_view& frame);
+
+    /**
+     * @brief Number of buffered bytes not yet returned as a frame
+     */
+    size_t buffered() const { return tail - head; }
+
+    /**
+     * @brief Total buffer capacity in bytes
+     */
+    size_t capacity() const { return storage.size(); }
+
+    /**
+     * @brief Discard all buffered bytes
+     */
+    void clear();
+
+    /**
+     * @brief Change how frames are delimited; applies to bytes not yet returned
+     * @param terminator Frame terminator byte
+     * @param trim_whitespace Strip trailing whitespace from frames (text protocols)
+     */
+    void setFraming(char terminator, bool trim_whitespace);
+
+private:
+    std::vector<char> storage;
+    char terminator;
+    bool trimWhitespace;
+    size_t head;     // first unconsumed byte
+    size_t scanned;  // bytes in [head, scanned) contain no terminator
+    size_t tail;     // one past the last received byte
+};
+
+} // namespace MechatronicTest
+
+#endif // LINE_FRAMER_H
@@ -0,0 +1,138 @@
+/**
+ * @file mpsc_queue.h
+ * @brief Bounded lock-free multi-producer, single-consumer queue
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Bounded lock-free queue for many producers and one consumer
+ *
+ * Slots are preallocated and reused, and each carries a sequence number
+ * that tells producers and the consumer whose turn it is, so neither side
+ * takes a lock, allocates or makes a syscall. Producers claim a slot with
+ * one compare-and-swap and fill it in place; a full queue rejects the push
+ * instead of blocking. Only one thread may consume at a time.
+ *
+ * @tparam T Default-constructible slot type; large types are fine since
+ *           values are written and read in place
+ */
+template <typename T>
+class MpscQueue {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Slot count, rounded up to a power of two
+     */
+    explicit MpscQueue(size_t capacity)
+        : mask(roundUp(capacity) - 1), cells(new Cell[mask + 1]), enqueuePos(0), dequeuePos(0) {
+        for (size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief Get slot count
+     * @return Capacity
+     */
+    size_t capacity() const { return mask + 1; }
+
+    /**
+     * @brief Claim a slot and fill it in place
+     * @param fill Callable taking T&; runs on the producer thread
+     * @return false if the queue is full
+     */
+    template <typename Fill>
+    bool tryEmplace(Fill&& fill) {
+        size_t position = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(cell->value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Copy a value into the queue
+     * @param value Value to push
+     * @return false if the queue is full
+     */
+    bool tryPush(const T& value) {
+        return tryEmplace([&value](T& slot) { slot = value; });
+    }
+
+    /**
+     * @brief Hand the oldest value to a function, then release its slot
+     * @param consume Callable taking T&; the reference is valid only during the call
+     * @return false if the queue is empty or the oldest push is still being filled
+     */
+    template <typename Consume>
+    bool tryConsume(Consume&& consume) {
+        Cell& cell = cells[dequeuePos & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            return false;
+        }
+
+        consume(cell.value);
+        cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+    /**
+     * @brief Move the oldest value out of the queue
+     * @param value Receives the value
+     * @return false if nothing was available
+     */
+    bool tryPop(T& value) {
+        return tryConsume([&value](T& slot) { value = std::move(slot); });
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        return size;
+    }
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) size_t dequeuePos;  ///< Consumer-owned
+};
+
+} // namespace MechatronicTest
+
+#endif // MPSC_QUEUE_H
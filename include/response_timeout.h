@@ -0,0 +1,134 @@
+/**
+ * @file response_timeout.h
+ * @brief Adaptive response timeouts learned from observed response times
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef RESPONSE_TIMEOUT_H
+#define RESPONSE_TIMEOUT_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MechatronicTest {
+
+struct EquipmentConfig;
+
+/**
+ * @brief Bounds and gains of a ResponseTimeoutEstimator
+ */
+struct TimeoutOptions {
+    bool adaptive = true;    ///< false always waits ceiling_ms
+    int floor_ms = 50;       ///< Shortest timeout ever used
+    int ceiling_ms = 5000;   ///< Longest timeout, and the timeout before the first sample
+    double k = 4.0;          ///< Deviations added to the smoothed response time
+    double alpha = 0.125;    ///< Gain of the smoothed response time
+    double beta = 0.25;      ///< Gain of the mean deviation
+};
+
+/**
+ * @brief Take the timeout settings from an equipment configuration
+ * @param config Equipment configuration
+ * @return Timeout options
+ */
+TimeoutOptions timeoutOptionsFrom(const EquipmentConfig& config);
+
+/**
+ * @brief Current estimate for one device type and command
+ */
+struct ResponseTimeoutStats {
+    std::string device_type;
+    std::string command;
+    std::uint64_t samples;
+    double smoothed_ms;    ///< SRTT
+    double deviation_ms;   ///< RTTVAR
+    double timeout_ms;     ///< Timeout the next command waits
+};
+
+/**
+ * @brief Per-(device type, command) timeout estimator after TCP's RTO (RFC 6298)
+ *
+ * Each completed response updates a smoothed response time and its mean
+ * deviation; the timeout is smoothed + k * deviation, clamped to
+ * [floor_ms, ceiling_ms]. Until a key has a sample it waits the ceiling,
+ * so nothing is timed out before its normal latency is known. A timeout
+ * doubles the key's timeout (up to the ceiling) until the next response,
+ * so a device that has merely slowed down is given more time on the retry
+ * while a dead one is still detected quickly.
+ *
+ * Lookups compare views and do not allocate once a key has been seen.
+ */
+class ResponseTimeoutEstimator {
+public:
+    /**
+     * @brief Constructor
+     * @param options Bounds and gains
+     */
+    explicit ResponseTimeoutEstimator(const TimeoutOptions& options = {});
+
+    /**
+     * @brief Replace the options and forget all estimates
+     * @param options Bounds and gains
+     */
+    void reset(const TimeoutOptions& options);
+
+    /**
+     * @brief Get the timeout to use for the next command
+     * @param device_type Device type, see deviceTypeOf()
+     * @param command Command or test type
+     * @param ceiling_ms Overrides options.ceiling_ms if positive, e.g. for calibration
+     * @return Timeout in milliseconds
+     */
+    int timeoutMs(std::string_view device_type, std::string_view command, int ceiling_ms = 0);
+
+    /**
+     * @brief Record the response time of a completed command
+     */
+    void recordResponse(std::string_view device_type, std::string_view command,
+                        std::chrono::steady_clock::duration elapsed);
+
+    /**
+     * @brief Record that a command timed out
+     */
+    void recordTimeout(std::string_view device_type, std::string_view command, int ceiling_ms = 0);
+
+    /**
+     * @brief Get the estimates of every key seen so far
+     * @return One entry per (device type, command)
+     */
+    std::vector<ResponseTimeoutStats> snapshot() const;
+
+private:
+    struct Entry {
+        std::string device_type;
+        std::string command;
+        std::uint64_t samples = 0;
+        double smoothed_ms = 0.0;
+        double deviation_ms = 0.0;
+        double backoff = 1.0;  ///< Doubles on each timeout, reset by a response
+        int ceiling_ms = 0;    ///< Ceiling override of the last lookup; 0 uses options.ceiling_ms
+    };
+
+    Entry& entry(std::string_view device_type, std::string_view command);
+    double timeoutOf(const Entry& entry) const;
+
+    TimeoutOptions options;
+    mutable std::mutex mutex;  // Held briefly; snapshots come from other threads
+    std::vector<Entry> entries;
+};
+
+/**
+ * @brief Device type of a device identifier: trailing digits and separators removed
+ * @param device_id Device identifier, e.g. "DEVICE_001"
+ * @return View into device_id, e.g. "DEVICE"
+ */
+std::string_view deviceTypeOf(std::string_view device_id);
+
+} // namespace MechatronicTest
+
+#endif // RESPONSE_TIMEOUT_H
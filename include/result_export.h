@@ -0,0 +1,158 @@
+/**
+ * @file result_export.h
+ * @brief Bulk CSV export of result stores and journals
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef RESULT_EXPORT_H
+#define RESULT_EXPORT_H
+
+#include "result_journal.h"
+#include "result_store.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Settings of a CsvExporter
+ */
+struct ExportOptions {
+    size_t buffer_bytes = 1 << 20;   ///< Output buffer; handed to the OS in one write each time it fills
+    size_t row_group_rows = 65536;   ///< Rows formatted between progress updates and cancellation checks
+    bool header = true;              ///< Write the column names as the first line
+    char delimiter = ',';
+};
+
+/**
+ * @brief Progress and totals of an export
+ */
+struct ExportStats {
+    std::uint64_t rows;          ///< Rows written so far
+    std::uint64_t total_rows;    ///< Rows in the source
+    std::uint64_t bytes;         ///< Bytes written so far
+    std::uint64_t row_groups;    ///< Row groups completed
+    double elapsed_ms;           ///< Duration of the last finished export
+    bool running;                ///< An export is in progress
+};
+
+/**
+ * @brief Writes results as CSV without allocating per row
+ *
+ * Columns are test_id, timestamp (ISO 8601 UTC with microseconds),
+ * device_id, value, unit, outcome and passed. Every row is formatted with
+ * std::to_chars straight into one preallocated buffer that is written out
+ * whenever it fills, and the calendar date is only recomputed when a
+ * row's day differs from the previous one's, so the cost per row is a few
+ * integer and float conversions plus a memcpy. Rows are processed in
+ * row groups; progress is published and cancel() honoured between groups.
+ *
+ * The output is written to "<path>.tmp" and renamed over path once
+ * complete, so a reader never sees a partial file.
+ *
+ * A JournalReader sees the records committed when it was opened, so
+ * exportJournalAsync() can run on a background thread while the station
+ * keeps appending to the same journal. A ResultStore is not thread-safe and
+ * is only exported synchronously.
+ */
+class CsvExporter {
+public:
+    /**
+     * @brief Constructor
+     * @param options Buffer size, row group size and format
+     */
+    explicit CsvExporter(const ExportOptions& options = {});
+
+    /**
+     * @brief Destructor; cancels and waits for a background export
+     */
+    ~CsvExporter();
+
+    CsvExporter(const CsvExporter&) = delete;
+    CsvExporter& operator=(const CsvExporter&) = delete;
+
+    /**
+     * @brief Export every result of a store
+     * @param store Source; must not be modified during the call
+     * @param path Destination file
+     * @return true if all rows were written
+     */
+    bool exportStore(const ResultStore& store, const std::string& path);
+
+    /**
+     * @brief Export every record of an open journal
+     * @param journal Source
+     * @param path Destination file
+     * @return true if all rows were written
+     */
+    bool exportJournal(const JournalReader& journal, const std::string& path);
+
+    /**
+     * @brief Open a journal file and export its committed records
+     * @param journal_path Journal file
+     * @param path Destination file
+     * @return true if all rows were written
+     */
+    bool exportJournal(const std::string& journal_path, const std::string& path);
+
+    /**
+     * @brief Export a journal file on a background thread
+     * @param journal_path Journal file; records appended after the export starts are not included
+     * @param path Destination file
+     * @return Future result; ready at once with false if an export is already running
+     */
+    std::future<bool> exportJournalAsync(const std::string& journal_path, const std::string& path);
+
+    /**
+     * @brief Stop the running export at the next row group; it returns false and leaves no file
+     */
+    void cancel();
+
+    /**
+     * @brief Get progress and totals; safe while an export runs
+     */
+    ExportStats getStats() const;
+
+    /**
+     * @brief Get the reason the last export failed
+     */
+    std::string getLastError() const;
+
+private:
+    class Writer;
+
+    bool begin();
+    bool writeStore(const ResultStore& store, const std::string& path);
+    bool writeJournal(const JournalReader& journal, const std::string& path);
+    bool writeJournalFile(const std::string& journal_path, const std::string& path);
+    template <typename FormatRow>
+    bool run(const std::string& path, size_t rows, FormatRow&& formatRow);
+    void setError(const std::string& error);
+
+    ExportOptions options;
+    std::vector<char> buffer;  ///< Allocated on first use and kept between exports
+
+    std::atomic<bool> busy;
+    std::atomic<bool> cancelled;
+    std::atomic<std::uint64_t> rowsWritten;
+    std::atomic<std::uint64_t> totalRows;
+    std::atomic<std::uint64_t> bytesWritten;
+    std::atomic<std::uint64_t> groupsWritten;
+    std::atomic<double> elapsedMs;
+    std::thread worker;
+
+    mutable std::mutex errorMutex;
+    std::string lastError;
+};
+
+} // namespace MechatronicTest
+
+#endif // RESULT_EXPORT_H
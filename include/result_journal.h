@@ -0,0 +1,232 @@
+/**
+ * @file result_journal.h
+ * @brief Memory-mapped, append-only binary result journal
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef RESULT_JOURNAL_H
+#define RESULT_JOURNAL_H
+
+#include "result_store.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Fixed-size file header at offset 0 of every journal
+ *
+ * record_count is only written once the records it covers have been
+ * synced, and the header page is synced after it, so even after a power
+ * loss readers never see a count that runs past durable data. Records
+ * appended since the last sync are not yet visible to readers.
+ */
+struct JournalHeader {
+    char magic[8];               ///< "MTRJRNL" followed by NUL
+    std::uint32_t schema_version;
+    std::uint32_t record_size;   ///< sizeof(JournalRecord) when written
+    std::uint64_t record_count;  ///< Records synced to disk
+    std::int64_t created_us;     ///< Creation time, microseconds since the Unix epoch
+    char station_id[32];         ///< NUL-terminated, truncated if longer
+    std::uint8_t reserved[8];
+};
+
+static_assert(sizeof(JournalHeader) == 72, "JournalHeader layout changed");
+
+/**
+ * @brief One journal entry: a packed result plus its device ID
+ *
+ * The device ID is stored inline so a journal is readable on its own.
+ */
+struct JournalRecord {
+    ResultRecord result;
+    char device_id[32];  ///< NUL-terminated, truncated if longer
+};
+
+static_assert(sizeof(JournalRecord) == 64, "JournalRecord layout changed");
+
+/**
+ * @brief Journal tuning
+ */
+struct JournalOptions {
+    size_t grow_records = 65536;      ///< Records added to the mapping each time it fills
+    size_t sync_every_records = 4096; ///< msync after this many appends...
+    int sync_interval_ms = 1000;      ///< ...and at least this often while any are unsynced
+};
+
+/**
+ * @brief Current journal schema version
+ */
+constexpr std::uint32_t JOURNAL_SCHEMA_VERSION = 1;
+
+/**
+ * @brief Append-only writer for the binary result journal
+ *
+ * Records are copied straight into a shared file mapping, so an append is
+ * a memcpy. A background thread msyncs appended records at least every
+ * sync_interval_ms, so the tail of a burst reaches disk while the station
+ * is idle; records are also synced on close. Reopening an existing journal
+ * continues after its last synced record. Not available on Windows.
+ */
+class ResultJournal {
+public:
+    /**
+     * @brief Constructor
+     */
+    ResultJournal();
+
+    /**
+     * @brief Destructor; flushes and closes the journal
+     */
+    ~ResultJournal();
+
+    ResultJournal(const ResultJournal&) = delete;
+    ResultJournal& operator=(const ResultJournal&) = delete;
+
+    /**
+     * @brief Open or create a journal
+     * @param path Journal file path
+     * @param station_id Station identifier recorded in a new journal's header
+     * @param options Growth and sync tuning
+     * @return true on success; see getLastError() otherwise
+     */
+    bool open(const std::string& path, const std::string& station_id, const JournalOptions& options = {});
+
+    /**
+     * @brief Flush and close the journal
+     */
+    void close();
+
+    /**
+     * @brief Check whether the journal is open
+     * @return true if open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Append a record
+     * @param device_id Device identifier
+     * @param record Result record; test_id 0 assigns the next sequence number
+     * @return true on success
+     */
+    bool append(std::string_view device_id, const ResultRecord& record);
+
+    /**
+     * @brief Append an outcome from EquipmentController::runTestInto()
+     * @param device_id Device identifier
+     * @param outcome Test outcome
+     * @return true on success
+     */
+    bool append(std::string_view device_id, const TestOutcome& outcome);
+
+    /**
+     * @brief Append a TestResult
+     * @param result Test result
+     * @return true on success
+     */
+    bool append(const TestResult& result);
+
+    /**
+     * @brief Force all written records to disk
+     * @return true on success
+     */
+    bool flush();
+
+    /**
+     * @brief Get number of appended records, synced or not
+     * @return Record count
+     */
+    std::uint64_t recordCount() const;
+
+    /**
+     * @brief Get last error message
+     * @return Error message
+     */
+    std::string getLastError() const;
+
+private:
+    bool remap(size_t capacity_records);
+    bool syncRange(size_t first_record, size_t end_record);
+    void flusherLoop();
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeCondition;
+    JournalOptions options;
+    std::string lastError;
+    int fd;
+    void* mapping;
+    size_t mappedBytes;
+    size_t capacityRecords;
+    size_t appendedRecords;
+    size_t syncedRecords;
+    bool stopping;
+    std::thread flusher;
+};
+
+/**
+ * @brief Read-only view of a journal file
+ */
+class JournalReader {
+public:
+    /**
+     * @brief Constructor
+     */
+    JournalReader();
+
+    /**
+     * @brief Destructor
+     */
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    /**
+     * @brief Map a journal for reading
+     * @param path Journal file path
+     * @return true if the file is a valid journal
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmap the journal
+     */
+    void close();
+
+    /**
+     * @brief Get the journal header
+     * @return Header in the mapping
+     */
+    const JournalHeader& header() const;
+
+    /**
+     * @brief Get number of synced records at open time
+     * @return Record count
+     */
+    size_t size() const { return recordCount; }
+
+    /**
+     * @brief Access a record
+     * @param index Record index
+     * @return Record in the mapping
+     */
+    const JournalRecord& record(size_t index) const;
+
+private:
+    int fd;
+    const void* mapping;
+    size_t mappedBytes;
+    size_t recordCount;
+};
+
+} // namespace MechatronicTest
+
+#endif // RESULT_JOURNAL_H
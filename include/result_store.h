@@ -0,0 +1,206 @@
+/**
+ * @file result_store.h
+ * @brief Compact result records and a columnar in-memory result store
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef RESULT_STORE_H
+#define RESULT_STORE_H
+
+#include "equipment_controller.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Packed, trivially copyable test result
+ *
+ * 32 bytes with no pointers, so records can be copied, memory-mapped or
+ * written to disk as-is. Device IDs are stored as an index into the owning
+ * store's device table.
+ */
+struct ResultRecord {
+    std::uint64_t test_id;       ///< Sequence number within the store
+    std::int64_t timestamp_us;   ///< Microseconds since the Unix epoch
+    double value;                ///< Measurement value
+    std::uint32_t device_index;  ///< Index into the device table
+    UnitCode unit;
+    OutcomeCode outcome;
+    std::uint8_t passed;         ///< 1 if the test passed
+    std::uint8_t reserved;       ///< Always 0; keeps the layout free of padding
+};
+
+static_assert(sizeof(ResultRecord) == 32, "ResultRecord must stay 32 bytes");
+
+/**
+ * @brief Convert a time point to the record timestamp representation
+ * @param when Time point
+ * @return Microseconds since the Unix epoch
+ */
+std::int64_t toEpochMicros(std::chrono::system_clock::time_point when);
+
+/**
+ * @brief Convert a record timestamp back to a time point
+ * @param epoch_us Microseconds since the Unix epoch
+ * @return Time point
+ */
+std::chrono::system_clock::time_point fromEpochMicros(std::int64_t epoch_us);
+
+/**
+ * @brief Pack an outcome from EquipmentController::runTestInto()
+ * @param outcome Test outcome
+ * @param device_index Device index to store
+ * @param test_id Test ID to store
+ * @return Record
+ */
+ResultRecord makeResultRecord(const TestOutcome& outcome, std::uint32_t device_index, std::uint64_t test_id);
+
+/**
+ * @brief Pack a TestResult
+ * @param result Test result
+ * @param device_index Device index to store
+ * @param test_id Test ID to store
+ * @return Record
+ */
+ResultRecord makeResultRecord(const TestResult& result, std::uint32_t device_index, std::uint64_t test_id);
+
+/**
+ * @brief Structure-of-arrays store for large numbers of results
+ *
+ * Each field lives in its own contiguous column, so statistical passes
+ * over e.g. values or pass flags touch only the memory they need.
+ * Conversion to and from TestResult is provided for compatibility; units
+ * that have no UnitCode are reported back as "?".
+ */
+class ResultStore {
+public:
+    /**
+     * @brief Constructor
+     */
+    ResultStore();
+
+    /**
+     * @brief Reserve space for a number of results in every column
+     * @param capacity Number of results
+     */
+    void reserve(size_t capacity);
+
+    /**
+     * @brief Get number of stored results
+     * @return Result count
+     */
+    size_t size() const { return testIds.size(); }
+
+    /**
+     * @brief Check whether the store is empty
+     * @return true if no results are stored
+     */
+    bool empty() const { return testIds.empty(); }
+
+    /**
+     * @brief Remove all results and devices
+     */
+    void clear();
+
+    /**
+     * @brief Look up or add a device in the device table
+     * @param device_id Device identifier
+     * @return Device index
+     */
+    std::uint32_t internDevice(std::string_view device_id);
+
+    /**
+     * @brief Get a device identifier from its index
+     * @param device_index Device index
+     * @return Device identifier
+     */
+    const std::string& deviceName(std::uint32_t device_index) const;
+
+    /**
+     * @brief Get number of distinct devices
+     * @return Device count
+     */
+    size_t deviceCount() const { return deviceNames.size(); }
+
+    /**
+     * @brief Append a record as-is
+     * @param record Record whose device_index refers to this store's device table
+     */
+    void append(const ResultRecord& record);
+
+    /**
+     * @brief Append an outcome from EquipmentController::runTestInto()
+     * @param device_id Device identifier
+     * @param outcome Test outcome
+     * @return Test ID assigned to the result
+     */
+    std::uint64_t append(std::string_view device_id, const TestOutcome& outcome);
+
+    /**
+     * @brief Append a TestResult
+     * @param result Test result
+     * @return Test ID assigned to the result
+     */
+    std::uint64_t append(const TestResult& result);
+
+    /**
+     * @brief Reassemble one result as a packed record
+     * @param index Row index
+     * @return Record
+     */
+    ResultRecord record(size_t index) const;
+
+    /**
+     * @brief Reassemble one result as a TestResult
+     * @param index Row index
+     * @return Test result
+     */
+    TestResult toTestResult(size_t index) const;
+
+    /**
+     * @brief Call a function with every record in insertion order
+     * @param fn Callable taking const ResultRecord&
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t i = 0; i < size(); ++i) {
+            fn(record(i));
+        }
+    }
+
+    /// @name Column access; each pointer addresses size() contiguous elements
+    /// @{
+    const std::uint64_t* testIdColumn() const { return testIds.data(); }
+    const std::int64_t* timestampColumn() const { return timestamps.data(); }
+    const double* valueColumn() const { return values.data(); }
+    const std::uint32_t* deviceColumn() const { return devices.data(); }
+    const UnitCode* unitColumn() const { return units.data(); }
+    const OutcomeCode* outcomeColumn() const { return outcomes.data(); }
+    const std::uint8_t* passedColumn() const { return passed.data(); }
+    /// @}
+
+private:
+    std::vector<std::uint64_t> testIds;
+    std::vector<std::int64_t> timestamps;
+    std::vector<double> values;
+    std::vector<std::uint32_t> devices;
+    std::vector<UnitCode> units;
+    std::vector<OutcomeCode> outcomes;
+    std::vector<std::uint8_t> passed;
+
+    std::vector<std::string> deviceNames;
+    std::map<std::string, std::uint32_t, std::less<>> deviceIndex;
+    std::uint64_t nextTestId;
+};
+
+} // namespace MechatronicTest
+
+#endif // RESULT_STORE_H
@@ -0,0 +1,64 @@
+/**
+ * @file retry_policy.h
+ * @brief Which failed tests are retried, and how long to wait between attempts
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef RETRY_POLICY_H
+#define RETRY_POLICY_H
+
+#include "equipment_controller.h"
+
+#include <chrono>
+#include <cstdint>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Retry settings of a controller
+ */
+struct RetryPolicy {
+    int max_retries = 3;                                ///< Attempts after the first; 0 disables retries
+    std::chrono::microseconds initial_backoff{10000};   ///< Wait before the first retry
+    std::chrono::microseconds max_backoff{500000};      ///< Cap on the doubling wait
+    double jitter = 0.5;          ///< Fraction of each wait that is randomized, 0..1
+    bool retry_timeout = false;   ///< NO_RESPONSE
+    bool retry_invalid = true;    ///< INVALID_RESPONSE, e.g. line noise in an ASCII reply
+    bool retry_corrupt = true;    ///< CORRUPT_RESPONSE, a binary reply that failed its CRC
+    bool retry_send = true;       ///< SEND_FAILED
+};
+
+/**
+ * @brief Take the retry settings from an equipment configuration
+ * @param config Equipment configuration
+ * @return Retry policy
+ */
+RetryPolicy retryPolicyFrom(const EquipmentConfig& config);
+
+/**
+ * @brief Check whether a failure class is retried at all
+ * @param policy Retry policy
+ * @param code How the attempt ended
+ * @return false for completed tests, whatever their verdict, and for
+ *         failures a retry cannot fix, such as NOT_RUNNING
+ */
+bool isRetryable(const RetryPolicy& policy, OutcomeCode code);
+
+/**
+ * @brief Wait before a retry: exponential backoff with jitter
+ *
+ * The base wait doubles from initial_backoff with every retry up to
+ * max_backoff; the jitter fraction of it is then drawn uniformly, so
+ * stations that failed together (e.g. on a shared noisy link) spread out.
+ *
+ * @param policy Retry policy
+ * @param retry Retry number, 1 for the first retry
+ * @param random_state Caller's generator state; advanced on every call
+ * @return Time to wait before sending again
+ */
+std::chrono::microseconds retryDelay(const RetryPolicy& policy, int retry, std::uint64_t& random_state);
+
+} // namespace MechatronicTest
+
+#endif // RETRY_POLICY_H
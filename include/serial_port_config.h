@@ -0,0 +1,68 @@
+/**
+ * @file serial_port_config.h
+ * @brief Line settings and latency tuning for POSIX serial ports
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef SERIAL_PORT_CONFIG_H
+#define SERIAL_PORT_CONFIG_H
+
+namespace MechatronicTest {
+
+struct EquipmentConfig;
+
+/**
+ * @brief How a serial port is opened and configured
+ */
+struct SerialOptions {
+    int baud_rate = 115200;
+    bool low_latency = true;   ///< Ask the driver (e.g. FTDI) to push received bytes immediately
+    int vmin = 0;              ///< termios VMIN; 0 lets read() return whatever poll() saw
+    int vtime_ds = 0;          ///< termios VTIME in tenths of a second
+    bool sync_writes = true;   ///< Open with O_SYNC
+};
+
+/**
+ * @brief Take the serial settings from an equipment configuration
+ * @param config Equipment configuration
+ * @return Serial options
+ */
+SerialOptions serialOptionsFrom(const EquipmentConfig& config);
+
+#ifndef _WIN32
+
+/**
+ * @brief Open flags for a serial port with the given options
+ * @param options Serial options
+ * @return Flags for open()
+ */
+int serialOpenFlags(const SerialOptions& options);
+
+/**
+ * @brief Switch an open port to raw 8N1 at the configured rate and timing
+ *
+ * Standard rates, including the high ones up to 4000000 where the platform
+ * defines them, go through termios; any other rate is set as a custom
+ * divisor with termios2 on Linux. Failing to enable low-latency mode is
+ * not an error, since many adapters and pseudo-terminals do not support it.
+ *
+ * @param fd Open serial port
+ * @param options Serial options
+ * @return false if the line settings or baud rate could not be applied
+ */
+bool configureSerialPort(int fd, const SerialOptions& options);
+
+/**
+ * @brief Set a baud rate that has no termios constant (termios2 BOTHER)
+ * @param fd Open serial port
+ * @param baud_rate Rate in bits per second
+ * @return false where termios2 is unavailable or the driver rejects the rate
+ */
+bool setCustomBaudRate(int fd, int baud_rate);
+
+#endif // _WIN32
+
+} // namespace MechatronicTest
+
+#endif // SERIAL_PORT_CONFIG_H
@@ -0,0 +1,165 @@
+/**
+ * @file simulated_interface.h
+ * @brief In-process simulated test equipment for load testing without fixtures
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef SIMULATED_INTERFACE_H
+#define SIMULATED_INTERFACE_H
+
+#include "equipment_controller.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Shape of the simulated response latency
+ */
+enum class LatencyDistribution {
+    FIXED,        ///< Always latency_us
+    UNIFORM,      ///< latency_us +/- latency_jitter_us
+    NORMAL,       ///< Mean latency_us, standard deviation latency_jitter_us
+    EXPONENTIAL   ///< Mean latency_us; long-tailed
+};
+
+/**
+ * @brief Behaviour of a SimulatedInterface
+ */
+struct SimulationModel {
+    LatencyDistribution distribution = LatencyDistribution::FIXED;
+    double latency_us = 0.0;               ///< Time from a command to its reply
+    double latency_jitter_us = 0.0;        ///< Spread, see LatencyDistribution
+    double max_commands_per_second = 0.0;  ///< Commands the device can process per second; 0 is unlimited
+    double drop_rate = 0.0;                ///< Probability a test gets no reply
+    double corrupt_rate = 0.0;             ///< Probability a reply is not a valid RESULT frame
+    double fail_rate = 0.0;                ///< Probability a valid result has a FAIL verdict
+    double nominal_value = 5.0;            ///< Measurement when the command has no numeric parameter
+    double value_noise = 0.0;              ///< Standard deviation added to measurements
+    std::string units = "V";
+    int channels = 1;                      ///< Readings per RESULT; channel i reads the measurement plus i * channel_step
+    double channel_step = 0.0;
+    double calibration_ms = 0.0;           ///< Time to answer CALIBRATE
+    double stream_rate_hz = 10000.0;       ///< Samples per second while streaming
+    int stream_frame_samples = 100;        ///< Samples per DATA frame
+    double stream_amplitude = 0.0;         ///< Sine wave added to streamed samples
+    double stream_frequency_hz = 50.0;
+    std::uint32_t seed = 1;
+};
+
+/**
+ * @brief Parse a model from "key=value,key=value" text
+ *
+ * Keys are the SimulationModel field names; distribution takes fixed,
+ * uniform, normal or exponential. Fields not mentioned keep their values.
+ *
+ * @param spec Model description
+ * @param model Model to update
+ * @return false if a key or value was not understood
+ */
+bool parseSimulationModel(std::string_view spec, SimulationModel& model);
+
+/**
+ * @brief HardwareInterface backed by an in-process device model
+ *
+ * Understands the same commands as the firmware: "TEST:<device>[:params]",
+ * "BATCH:<dev1>,<dev2>,...[:params]" (one reply per device), "CALIBRATE"
+ * and "#<seq>:" sequence tags, which are echoed. "STREAM:<device>[:params]"
+ * answers STREAM:OK and then sends "DATA:<seq>:samples" frames at
+ * stream_rate_hz until "STREAM:STOP", which is answered by STREAM:END. It also accepts the
+ * binary protocol request and then speaks binary frames (corrupted replies
+ * then fail their CRC). Each test gets a RESULT
+ * frame whose value is the first numeric test parameter (or
+ * nominal_value) plus noise, one reading per channel. The device processes commands one at a time
+ * at up to max_commands_per_second and replies in order after the
+ * modelled latency. Replies become readable through readAvailable() like
+ * bytes from a port, so framing, pipelining and timing behave as they do
+ * with real equipment.
+ *
+ * Selected with interface type "sim". connect() accepts any port; a port
+ * containing '=' is parsed with parseSimulationModel().
+ */
+class SimulatedInterface : public HardwareInterface {
+public:
+    /**
+     * @brief Constructor
+     * @param model Device behaviour
+     */
+    explicit SimulatedInterface(const SimulationModel& model = {});
+
+    bool connect(const std::string& port, int baud_rate) override;
+    bool disconnect() override;
+    bool sendCommand(const std::string& command) override;
+    bool sendRaw(const char* data, size_t length) override;
+    bool isConnected() const override;
+
+    /**
+     * @brief Replace the device model; takes effect for later commands
+     * @param model Device behaviour
+     */
+    void setModel(const SimulationModel& model);
+
+    /**
+     * @brief Get the device model
+     * @return Current model
+     */
+    SimulationModel getModel() const;
+
+    /**
+     * @brief Get number of commands received since connecting
+     * @return Command count
+     */
+    std::uint64_t commandsReceived() const;
+
+protected:
+    long readAvailable(char* buffer, size_t length, int timeout_ms) override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Reply bytes that become readable at a point in time
+     */
+    struct Reply {
+        Clock::time_point ready;
+        std::string bytes;
+    };
+
+    void handleTest(std::string_view tag, std::uint16_t sequence, double expected, std::string& out);
+    void handleBinaryFrame(std::string_view encoded);
+    void schedule(std::string bytes, double extra_us);
+    void queueStreamFrame();
+    double sampleLatencyUs();
+    bool chance(double probability);
+
+    mutable std::mutex mutex;
+    std::condition_variable replyReady;
+    SimulationModel model;
+    std::mt19937 random;
+    bool connected;
+    std::deque<Reply> replies;
+    size_t replyOffset;              ///< Bytes of replies.front() already read
+    Clock::time_point deviceFreeAt;  ///< When the device finishes its current command
+    Clock::time_point lastReplyAt;   ///< Keeps replies in command order
+    std::uint64_t commands;
+    bool binary;           ///< Switched to the binary protocol
+    std::string rawInput;  ///< Binary bytes after the last complete frame
+    std::vector<double> readings;  ///< Channel readings of the reply being built
+    bool streaming;
+    Clock::time_point streamStart;
+    std::uint64_t streamFrames;    ///< DATA frames queued since STREAM
+    double streamLevel;            ///< Value streamed samples vary around
+};
+
+} // namespace MechatronicTest
+
+#endif // SIMULATED_INTERFACE_H
@@ -0,0 +1,227 @@
+/**
+ * @file spc_monitor.h
+ * @brief Online statistics and statistical process control of measurements
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef SPC_MONITOR_H
+#define SPC_MONITOR_H
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MechatronicTest {
+
+struct EquipmentConfig;
+
+/**
+ * @brief Running quantile estimate in constant memory (P-square algorithm)
+ *
+ * Jain and Chlamtac's P-square estimator keeps five markers whose heights
+ * approximate the minimum, p/2, p, (1+p)/2 quantiles and the maximum, and
+ * moves them with a piecewise-parabolic fit as samples arrive. Each sample
+ * costs a handful of comparisons; nothing is stored per sample.
+ */
+class P2Quantile {
+public:
+    /**
+     * @brief Constructor
+     * @param p Quantile to track, 0..1
+     */
+    explicit P2Quantile(double p = 0.5);
+
+    void add(double sample);
+
+    /**
+     * @brief Get the estimate; exact while fewer than five samples have been seen
+     * @return Estimated quantile, 0 before the first sample
+     */
+    double value() const;
+
+private:
+    double parabolic(int i, double d) const;
+    double linear(int i, int d) const;
+
+    double p;
+    std::uint64_t count;
+    double heights[5];
+    double positions[5];
+    double desired[5];
+    double increments[5];
+};
+
+/**
+ * @brief Western Electric rule violated by a sample, most severe first
+ */
+enum class SpcRule : std::uint8_t {
+    NONE,
+    BEYOND_3_SIGMA,               ///< Rule 1: one point beyond 3 sigma
+    TWO_OF_THREE_BEYOND_2_SIGMA,  ///< Rule 2: two of three consecutive points beyond 2 sigma, same side
+    FOUR_OF_FIVE_BEYOND_1_SIGMA,  ///< Rule 3: four of five consecutive points beyond 1 sigma, same side
+    EIGHT_ON_ONE_SIDE             ///< Rule 4: eight consecutive points on one side of the center line
+};
+
+/**
+ * @brief Get a short description of a rule
+ * @return Static string
+ */
+const char* spcRuleName(SpcRule rule);
+
+/**
+ * @brief Settings of an SpcMonitor
+ */
+struct SpcOptions {
+    bool enabled = true;
+    std::uint64_t baseline_samples = 25;  ///< Samples that set the center line and sigma before rules apply
+    size_t max_keys = 256;                ///< Device type/test pairs tracked; later ones are ignored
+    double lower_spec = -std::numeric_limits<double>::infinity();  ///< For Cp and Cpk
+    double upper_spec = std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief Take the SPC settings from an equipment configuration
+ *
+ * Specification limits are channel 0's host-side limits, if any.
+ *
+ * @param config Equipment configuration
+ * @return SPC options
+ */
+SpcOptions spcOptionsFrom(const EquipmentConfig& config);
+
+/**
+ * @brief Statistics of one device type and test
+ */
+struct SpcStats {
+    std::string device_type;
+    std::string test;
+    std::uint64_t samples;
+    double mean;
+    double stddev;       ///< Sample standard deviation of every measurement
+    double min;
+    double max;
+    double p01;          ///< P-square estimates
+    double p50;
+    double p99;
+    double center;       ///< Center line from the baseline; 0 until it is complete
+    double sigma;        ///< Baseline standard deviation; 0 until it is complete
+    double cp;           ///< (USL - LSL) / 6 sigma; NaN without both spec limits
+    double cpk;          ///< Distance from the mean to the nearer spec limit in 3 sigma units; NaN without spec limits
+    std::uint64_t alarms;    ///< Samples that violated a rule
+    SpcRule last_rule;       ///< Rule of the latest alarm
+    std::uint64_t last_alarm_sample;  ///< Sample number (1-based) of the latest alarm, 0 if none
+};
+
+/**
+ * @brief A rule violation, reported by the sample that caused it
+ */
+struct SpcAlarm {
+    std::string device_type;
+    std::string test;
+    SpcRule rule;
+    double value;
+    double z;                ///< (value - center) / sigma
+    std::uint64_t sample;    ///< 1-based sample number within the key
+};
+
+using SpcAlarmCallback = std::function<void(const SpcAlarm&)>;
+
+/**
+ * @brief Per-(device type, test) running statistics and control-chart rules
+ *
+ * Every sample updates, in constant time and memory: Welford's running
+ * mean and variance, the minimum and maximum, P-square estimates of the
+ * 1st, 50th and 99th percentiles, and the state of the four Western
+ * Electric rules. The first baseline_samples of a key fix its center line
+ * and sigma (phase I); every later sample is checked against them as it
+ * arrives, so a drifting process is flagged by the sample that shows it.
+ * Rules 2 and 3 keep the last few zone hits as bit masks and rule 4 a
+ * signed run length, so no history is stored.
+ *
+ * Queries read the accumulated state and do no work per sample seen.
+ */
+class SpcMonitor {
+public:
+    /**
+     * @brief Constructor
+     * @param options Baseline length, key limit and spec limits
+     */
+    explicit SpcMonitor(const SpcOptions& options = {});
+
+    /**
+     * @brief Replace the options and forget every key
+     */
+    void reset(const SpcOptions& options);
+
+    /**
+     * @brief Set the function alarms are reported to
+     *
+     * Called on the thread that recorded the sample, after the monitor's
+     * lock is released.
+     */
+    void setAlarmCallback(SpcAlarmCallback callback);
+
+    /**
+     * @brief Add one measurement
+     * @param device_type Device type, see deviceTypeOf()
+     * @param test Test type
+     * @param value Measurement
+     * @return Most severe rule the sample violated, NONE if in control or still in the baseline
+     */
+    SpcRule record(std::string_view device_type, std::string_view test, double value);
+
+    /**
+     * @brief Get the statistics of one key
+     * @return false if the key has no samples
+     */
+    bool stats(std::string_view device_type, std::string_view test, SpcStats& out) const;
+
+    /**
+     * @brief Get the statistics of every key
+     */
+    std::vector<SpcStats> snapshot() const;
+
+private:
+    struct Entry {
+        std::string device_type;
+        std::string test;
+        std::uint64_t samples = 0;
+        double mean = 0.0;
+        double m2 = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        P2Quantile p01{0.01};
+        P2Quantile p50{0.5};
+        P2Quantile p99{0.99};
+        double center = 0.0;
+        double sigma = 0.0;
+        bool baselined = false;
+        std::uint8_t above2 = 0;  ///< Bit i: sample i back was beyond +2 sigma
+        std::uint8_t below2 = 0;
+        std::uint8_t above1 = 0;
+        std::uint8_t below1 = 0;
+        std::int64_t run = 0;     ///< Consecutive samples above (positive) or below (negative) center
+        std::uint64_t alarms = 0;
+        SpcRule lastRule = SpcRule::NONE;
+        std::uint64_t lastAlarm = 0;
+    };
+
+    Entry* find(std::string_view device_type, std::string_view test);
+    const Entry* find(std::string_view device_type, std::string_view test) const;
+    SpcRule check(Entry& entry, double z);
+    SpcStats statsOf(const Entry& entry) const;
+
+    SpcOptions options;
+    mutable std::mutex mutex;  // Held for a few arithmetic operations per call
+    std::vector<Entry> entries;
+    SpcAlarmCallback alarmCallback;
+};
+
+} // namespace MechatronicTest
+
+#endif // SPC_MONITOR_H
@@ -0,0 +1,125 @@
+/**
+ * @file spsc_ring.h
+ * @brief Bounded lock-free single-producer, single-consumer ring of reusable slots
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Bounded lock-free ring for exactly one producer and one consumer
+ *
+ * Slots are allocated once and written and read in place, so slot types
+ * that own buffers (e.g. a vector with reserved capacity) keep them for the
+ * life of the ring. Each side owns one index and keeps a cached copy of the
+ * other's, so a push or pop usually touches no shared cache line. A full
+ * ring rejects the claim instead of blocking or overwriting.
+ *
+ * @tparam T Default-constructible slot type
+ */
+template <typename T>
+class SpscRing {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Slot count, rounded up to a power of two
+     * @param init Callable taking T&, run once per slot, e.g. to reserve buffers
+     */
+    template <typename Init>
+    SpscRing(size_t capacity, Init&& init)
+        : mask(roundUp(capacity) - 1), slots(new T[mask + 1]), head(0), tail(0), cachedTail(0), cachedHead(0) {
+        for (size_t i = 0; i <= mask; ++i) {
+            init(slots[i]);
+        }
+    }
+
+    explicit SpscRing(size_t capacity) : SpscRing(capacity, [](T&) {}) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Get slot count
+     * @return Capacity
+     */
+    size_t capacity() const { return mask + 1; }
+
+    /**
+     * @brief Get the next free slot to fill; producer only
+     * @return Slot, or nullptr if the ring is full. The same slot is returned
+     *         until publish() is called.
+     */
+    T* claim() {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position - cachedTail > mask) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (position - cachedTail > mask) {
+                return nullptr;
+            }
+        }
+        return &slots[position & mask];
+    }
+
+    /**
+     * @brief Hand the claimed slot to the consumer; producer only
+     */
+    void publish() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get the oldest published slot; consumer only
+     * @return Slot, or nullptr if the ring is empty. Valid until release().
+     */
+    T* front() {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position == cachedHead) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (position == cachedHead) {
+                return nullptr;
+            }
+        }
+        return &slots[position & mask];
+    }
+
+    /**
+     * @brief Return the slot from front() to the producer; consumer only
+     */
+    void release() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get the number of published slots not yet released
+     * @return Approximate if called while the other side is active
+     */
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        return size;
+    }
+
+    const size_t mask;
+    std::unique_ptr<T[]> slots;
+    alignas(64) std::atomic<size_t> head;  ///< Next slot to publish; written by the producer
+    alignas(64) std::atomic<size_t> tail;  ///< Next slot to release; written by the consumer
+    alignas(64) size_t cachedTail;         ///< Producer's copy of tail
+    alignas(64) size_t cachedHead;         ///< Consumer's copy of head
+};
+
+} // namespace MechatronicTest
+
+#endif // SPSC_RING_H
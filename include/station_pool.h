@@ -0,0 +1,195 @@
+/**
+ * @file station_pool.h
+ * @brief Parallel test execution across many equipment controllers
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef STATION_POOL_H
+#define STATION_POOL_H
+
+#include "equipment_controller.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Completion callback for a pooled test
+ *
+ * Called on the worker thread of the station that ran the test.
+ */
+using PoolCallback = std::function<void(size_t station, const TestResult&)>;
+
+/**
+ * @brief Aggregate counters for a station pool
+ */
+struct PoolSummary {
+    size_t submitted;
+    size_t completed;
+    size_t passed;
+    size_t failed;
+    size_t stolen;                       ///< Tests run by a station other than the one queued on
+    size_t abandoned;                    ///< Tests still queued when stop() was called; never run
+    std::vector<size_t> station_completed;  ///< Tests completed per station
+};
+
+/**
+ * @brief Owns several equipment controllers and runs tests on them in parallel
+ *
+ * Each station that is connected when start() is called gets a worker
+ * thread and a queue. Unpinned tests go to the queues in round-robin order;
+ * a worker whose queue runs dry steals unpinned tests from the back of the
+ * busiest other queue, so slow fixtures do not hold up the tray.
+ */
+class StationPool {
+public:
+    /**
+     * @brief Station index for tests that may run anywhere
+     */
+    static constexpr size_t ANY_STATION = static_cast<size_t>(-1);
+
+    /**
+     * @brief Constructor
+     */
+    StationPool();
+
+    /**
+     * @brief Destructor; stops the pool and waits for running tests
+     */
+    ~StationPool();
+
+    StationPool(const StationPool&) = delete;
+    StationPool& operator=(const StationPool&) = delete;
+
+    /**
+     * @brief Add an existing controller as a station
+     * @param controller Controller, normally already initialized
+     * @return Station index, or ANY_STATION if the pool is already running
+     */
+    size_t addStation(std::unique_ptr<EquipmentController> controller);
+
+    /**
+     * @brief Create and initialize a controller as a new station
+     * @param config Equipment configuration for the station
+     * @return Station index, or ANY_STATION if the pool is already running; the
+     *         station stays inactive if initialization fails
+     */
+    size_t addStation(const EquipmentConfig& config);
+
+    /**
+     * @brief Get number of stations
+     * @return Station count
+     */
+    size_t stationCount() const;
+
+    /**
+     * @brief Access a station's controller
+     * @param index Station index
+     * @return Controller reference
+     */
+    EquipmentController& station(size_t index);
+
+    /**
+     * @brief Start all connected stations and their worker threads
+     * @return true if at least one station is active
+     */
+    bool start();
+
+    /**
+     * @brief Stop the workers after their current test
+     *
+     * Tests still queued are reported as failed with "Station pool stopped".
+     */
+    void stop();
+
+    /**
+     * @brief Queue a test
+     * @param device_id Device identifier
+     * @param test_parameters Test parameters
+     * @param callback Optional completion callback; without one the result is
+     *                 kept for takeResults()
+     * @param station Preferred station, or ANY_STATION
+     * @param pinned If true the test only runs on the preferred station
+     * @return false if the pool is not running or the station is not active
+     */
+    bool submit(const std::string& device_id, const std::vector<std::string>& test_parameters,
+                PoolCallback callback = nullptr, size_t station = ANY_STATION, bool pinned = false);
+
+    /**
+     * @brief Block until every submitted test has completed
+     */
+    void waitIdle();
+
+    /**
+     * @brief Take the results of completed tests submitted without a callback
+     * @return Results in completion order
+     */
+    std::vector<TestResult> takeResults();
+
+    /**
+     * @brief Get aggregate counters
+     * @return Pool summary
+     */
+    PoolSummary getSummary() const;
+
+    /**
+     * @brief Check whether a station has a running worker
+     * @param index Station index
+     * @return true if the station accepts tests
+     */
+    bool isStationActive(size_t index) const;
+
+private:
+    struct Job {
+        std::string device_id;
+        std::vector<std::string> test_parameters;
+        PoolCallback callback;
+        bool pinned;
+    };
+
+    struct Station {
+        std::unique_ptr<EquipmentController> controller;
+        mutable std::mutex queueMutex;
+        std::deque<Job> queue;
+        std::thread worker;
+        std::atomic<bool> active{false};
+        std::atomic<size_t> completed{0};
+    };
+
+    void workerLoop(size_t index);
+    bool takeJob(size_t index, Job& job, bool& stolen);
+    void finishJob(size_t index, Job& job, const TestResult& result);
+    void deliver(size_t index, Job& job, const TestResult& result);
+
+    std::vector<std::unique_ptr<Station>> stations;
+    std::atomic<bool> running;
+    std::atomic<size_t> nextStation;
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable idleCondition;
+    size_t outstanding;
+
+    std::mutex resultsMutex;
+    std::vector<TestResult> results;
+
+    std::atomic<size_t> submittedCount;
+    std::atomic<size_t> passedCount;
+    std::atomic<size_t> failedCount;
+    std::atomic<size_t> stolenCount;
+    std::atomic<size_t> abandonedCount;
+};
+
+} // namespace MechatronicTest
+
+#endif // STATION_POOL_H
@@ -0,0 +1,123 @@
+/**
+ * @file status_dispatcher.h
+ * @brief Asynchronous delivery of equipment status changes to listeners
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef STATUS_DISPATCHER_H
+#define STATUS_DISPATCHER_H
+
+#include "equipment_controller.h"
+#include "mpsc_queue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Delivers status events to listeners on a dedicated thread
+ *
+ * publish() copies the event into a lock-free queue and returns, so status
+ * changes never wait on listener code. A dispatcher thread, started with
+ * the first listener, drains the queue and calls every listener without
+ * holding any lock; listeners may therefore add or remove listeners or
+ * call back into the controller. When several consecutive events with the
+ * same status are waiting, only the latest is delivered. If the queue
+ * overflows, the dispatcher reports the latest status once it catches up.
+ * Events still queued on destruction are discarded.
+ */
+class StatusDispatcher {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Events buffered before publish() starts dropping
+     */
+    explicit StatusDispatcher(size_t capacity = 256);
+
+    /**
+     * @brief Destructor; stops the dispatcher thread
+     */
+    ~StatusDispatcher();
+
+    StatusDispatcher(const StatusDispatcher&) = delete;
+    StatusDispatcher& operator=(const StatusDispatcher&) = delete;
+
+    /**
+     * @brief Add a listener
+     * @param callback Listener
+     * @return Listener handle, 0 if callback is empty
+     */
+    StatusListenerId addListener(StatusCallback callback);
+
+    /**
+     * @brief Remove a listener
+     * @param id Listener handle
+     * @return true if the listener was registered
+     */
+    bool removeListener(StatusListenerId id);
+
+    /**
+     * @brief Queue a status event; does nothing while there are no listeners
+     * @param status New status
+     * @param message Status message, truncated to MESSAGE_CAPACITY - 1 characters
+     */
+    void publish(EquipmentStatus status, std::string_view message);
+
+    /**
+     * @brief Stop the dispatcher thread and discard undelivered events
+     *
+     * Once stopped, listeners are no longer called.
+     */
+    void stop();
+
+    /**
+     * @brief Wait until events published so far have been delivered
+     * @param timeout_ms Timeout in milliseconds
+     * @return true if delivery caught up
+     */
+    bool waitDelivered(int timeout_ms);
+
+    static constexpr size_t MESSAGE_CAPACITY = 160;
+
+private:
+    struct Event {
+        EquipmentStatus status;
+        char message[MESSAGE_CAPACITY];
+    };
+
+    using ListenerList = std::vector<std::pair<StatusListenerId, StatusCallback>>;
+
+    void dispatchLoop();
+    void deliver(const std::shared_ptr<const ListenerList>& targets, EquipmentStatus status,
+                 const std::string& message);
+
+    MpscQueue<Event> queue;
+    std::atomic<EquipmentStatus> latest;
+    std::atomic<bool> overflowed;
+    std::atomic<std::uint64_t> published;
+    std::atomic<std::uint64_t> delivered;
+
+    // Copy-on-write so the dispatcher can iterate without holding the lock
+    std::mutex listenersMutex;
+    std::shared_ptr<const ListenerList> listeners;
+    std::atomic<size_t> listenerCount;
+    StatusListenerId nextListenerId;
+
+    std::thread dispatchThread;
+    std::atomic<bool> stopping;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+};
+
+} // namespace MechatronicTest
+
+#endif // STATUS_DISPATCHER_H
@@ -0,0 +1,89 @@
+/**
+ * @file tcp_interface.h
+ * @brief TCP hardware interface for network-attached testers
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef TCP_INTERFACE_H
+#define TCP_INTERFACE_H
+
+#include "equipment_controller.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Connection behaviour of a TcpInterface
+ */
+struct TcpOptions {
+    int connect_timeout_ms = 2000;
+    int send_timeout_ms = 1000;     ///< Longest wait for socket buffer space
+    bool keepalive = true;          ///< Detect dead peers on idle connections
+    int keepalive_idle_s = 10;
+    int keepalive_interval_s = 5;
+    int keepalive_count = 3;
+    bool reconnect = true;          ///< Re-establish a lost connection on the next send
+    int reconnect_attempts = 3;
+    int reconnect_backoff_ms = 50;  ///< Delay before the second attempt; doubles per attempt
+};
+
+/**
+ * @brief HardwareInterface over a TCP stream
+ *
+ * The port is "host:port" (IPv6 literals as "[addr]:port"). The socket is
+ * non-blocking with TCP_NODELAY, so a command leaves as soon as it is
+ * written; sendmsg() gathers the command and its "\r\n" terminator without
+ * copying them into a send buffer.
+ *
+ * A connection lost while idle or reading is re-established by the next
+ * sendCommand(); isConnected() stays true until disconnect() is called or
+ * reconnecting fails. Available on POSIX systems; elsewhere connect()
+ * fails.
+ */
+class TcpInterface : public HardwareInterface {
+public:
+    /**
+     * @brief Constructor
+     * @param options Connection behaviour
+     */
+    explicit TcpInterface(const TcpOptions& options = {});
+    ~TcpInterface() override;
+
+    bool connect(const std::string& port, int baud_rate) override;
+    bool disconnect() override;
+    bool sendCommand(const std::string& command) override;
+    bool sendRaw(const char* data, size_t length) override;
+    bool isConnected() const override;
+
+    /**
+     * @brief Get number of times a lost connection was re-established
+     * @return Reconnect count
+     */
+    std::uint64_t reconnects() const { return reconnectCount; }
+
+protected:
+    long readAvailable(char* buffer, size_t length, int timeout_ms) override;
+
+private:
+    bool openSocket();
+    void closeSocket();
+    bool reconnect();
+    bool peerClosed();
+    bool deliver(const char* data, size_t length, bool terminate);
+    bool writeParts(const char* data, size_t length, bool terminate);
+
+    TcpOptions options;
+    std::string host;
+    std::string service;
+    int socket_fd;
+    std::atomic<bool> open;        ///< Between a successful connect() and disconnect()
+    std::uint64_t reconnectCount;
+};
+
+} // namespace MechatronicTest
+
+#endif // TCP_INTERFACE_H
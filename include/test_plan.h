@@ -0,0 +1,168 @@
+/**
+ * @file test_plan.h
+ * @brief Test plans: dependency graphs of test steps run as one part test
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef TEST_PLAN_H
+#define TEST_PLAN_H
+
+#include "equipment_controller.h"
+#include "station_pool.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace MechatronicTest {
+
+/**
+ * @brief One step of a test plan
+ */
+struct TestStep {
+    std::string id;
+    std::vector<std::string> parameters;   ///< Test parameters, as for EquipmentController::runTest()
+    std::vector<std::string> depends_on;   ///< Steps that must pass before this one starts
+    size_t station = StationPool::ANY_STATION;  ///< Instrument the step needs, or any free one
+    bool hard_fail = true;                 ///< A failure aborts the steps not yet started
+};
+
+/**
+ * @brief Outcome of one step
+ */
+struct StepResult {
+    std::string id;
+    bool ran;          ///< false if the plan aborted or a dependency failed first
+    bool passed;
+    size_t station;    ///< Station that ran the step; ANY_STATION if it did not run
+    TestResult result;
+};
+
+/**
+ * @brief Outcome of a whole plan for one part
+ */
+struct PlanResult {
+    bool passed;                  ///< Every hard_fail step ran and passed
+    bool aborted;                 ///< A hard failure stopped the plan early
+    std::string failed_step;      ///< First hard failure, empty if none
+    std::vector<StepResult> steps;  ///< In the order the steps were added
+    std::chrono::steady_clock::duration elapsed;
+};
+
+/**
+ * @brief Directed acyclic graph of test steps
+ *
+ * Steps are added in any order and compile() checks the graph and flattens
+ * it into a topological schedule with each step's dependents stored
+ * contiguously, so running a plan only decrements counters. run() on a
+ * StationPool starts every step whose dependencies have passed as soon as
+ * they have, so independent steps run concurrently on whichever stations
+ * are free; run() on a single controller runs the schedule in order.
+ *
+ * A step starts only if all of its dependencies passed. A failed step with
+ * hard_fail set aborts the plan: nothing else is started and steps already
+ * running are allowed to finish. A soft failure only skips the steps that
+ * depend on it.
+ */
+class TestPlan {
+public:
+    /**
+     * @brief Constructor
+     * @param name Plan name, for reports
+     */
+    explicit TestPlan(std::string name = std::string());
+
+    /**
+     * @brief Add a step; invalidates a previous compile()
+     * @param step Step; its id must be unique and non-empty
+     * @return false if the id is empty or already used
+     */
+    bool addStep(TestStep step);
+
+    /**
+     * @brief Check the graph and build the execution schedule
+     * @return false on an unknown dependency or a cycle, see getLastError()
+     */
+    bool compile();
+
+    /**
+     * @brief Check whether the plan compiled and has not changed since
+     */
+    bool isCompiled() const { return compiled; }
+
+    /**
+     * @brief Run the plan for one part across a station pool
+     * @param pool Running station pool
+     * @param device_id Part under test
+     * @return Plan outcome; fails without running anything if the plan is not compiled
+     */
+    PlanResult run(StationPool& pool, const std::string& device_id) const;
+
+    /**
+     * @brief Run the plan for one part on a single controller, one step at a time
+     * @param controller Running controller
+     * @param device_id Part under test
+     * @return Plan outcome; station is 0 for steps that ran
+     */
+    PlanResult run(EquipmentController& controller, const std::string& device_id) const;
+
+    const std::string& name() const { return planName; }
+    const std::vector<TestStep>& steps() const { return planSteps; }
+
+    /**
+     * @brief Get the compiled schedule
+     * @return Step indices in a dependency-respecting order
+     */
+    const std::vector<size_t>& schedule() const { return order; }
+
+    /**
+     * @brief Get the reason compile() or loadTestPlan() failed
+     */
+    std::string getLastError() const { return lastError; }
+
+private:
+    PlanResult newResult() const;
+    void finishStep(PlanResult& plan, size_t step, bool ran, size_t station, const TestResult& result) const;
+
+    std::string planName;
+    std::vector<TestStep> planSteps;
+    bool compiled;
+    std::vector<size_t> order;
+    std::vector<size_t> indegree;         ///< Unfinished dependencies of each step
+    std::vector<size_t> dependentsBegin;  ///< dependents[begin[i], begin[i + 1]) depend on step i
+    std::vector<size_t> dependents;
+    std::string lastError;
+
+    friend bool loadTestPlan(const std::string& path, TestPlan& plan);
+};
+
+/**
+ * @brief Load and compile the test_plan section of a YAML configuration
+ *
+ *     test_plan:
+ *       name: standard_part
+ *       steps:
+ *         - id: power_up
+ *           parameters: [power, "on"]
+ *           station: 0                  # optional
+ *         - id: voltage
+ *           parameters: [voltage, "5.0"]
+ *           depends_on: [power_up]
+ *         - id: vision
+ *           parameters: [vision, check]
+ *           depends_on: [voltage]
+ *           hard_fail: false
+ *
+ * Requires a build with yaml-cpp (HAS_YAML_CPP); otherwise it always fails.
+ *
+ * @param path Configuration file
+ * @param plan Replaced by the loaded plan
+ * @return false if the file cannot be read, has no valid test_plan, or does not compile
+ */
+bool loadTestPlan(const std::string& path, TestPlan& plan);
+
+} // namespace MechatronicTest
+
+#endif // TEST_PLAN_H
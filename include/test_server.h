@@ -0,0 +1,158 @@
+/**
+ * @file test_server.h
+ * @brief Socket front end that serves test requests from a resident station pool
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef TEST_SERVER_H
+#define TEST_SERVER_H
+
+#include "station_pool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Where a TestServer listens
+ */
+struct ServerAddress {
+    bool unix_socket = false;
+    std::string host;  ///< TCP host or address; empty listens on all interfaces
+    std::string port;  ///< TCP port; "0" picks a free one
+    std::string path;  ///< Unix socket path
+};
+
+/**
+ * @brief Parse a listen address
+ *
+ * Accepts "unix:<path>", "host:port", "[v6addr]:port" and ":port".
+ *
+ * @param text Address as given on the command line
+ * @param address Parsed address
+ * @return false if the address is malformed
+ */
+bool parseServerAddress(const std::string& text, ServerAddress& address);
+
+/**
+ * @brief Limits of a TestServer
+ */
+struct ServerOptions {
+    size_t max_clients = 64;
+    size_t max_pending_per_client = 256;  ///< Tests a client may have queued; more are refused with ERROR
+    size_t max_request_bytes = 4096;      ///< Longest request line
+};
+
+/**
+ * @brief Line protocol server in front of a StationPool
+ *
+ * Any number of clients connect over TCP or a Unix socket and send
+ * newline-terminated requests; every request carries a client-chosen
+ * tag that is echoed in its reply:
+ *
+ *     TEST:<tag>:<device>[:<param>...]   queue a test on any station
+ *     STATUS:<tag>                       pool summary
+ *     HEALTH:<tag>:<station>             health metrics of one station
+ *     PING:<tag>
+ *
+ * Replies:
+ *
+ *     RESULT:<tag>:<PASS|FAIL>:<station>:<values>:<units>:<notes>
+ *     STATUS:<tag>:<stations>:<active>:<submitted>:<completed>:<passed>:<failed>
+ *     HEALTH:<tag>:<name>=<value>,...
+ *     PONG:<tag>
+ *     ERROR:<tag>:<message>
+ *
+ * <values> lists every channel reading separated by commas. Tests from all
+ * clients are multiplexed onto the pool, so a client may pipeline many
+ * TEST requests and receives their results in completion order. Results
+ * are written from the station worker that finished the test; only
+ * requests and partial writes go through the server's poll() thread.
+ * Available on POSIX systems; elsewhere start() fails.
+ */
+class TestServer {
+public:
+    /**
+     * @brief Constructor
+     * @param pool Station pool the tests run on; must outlive the server
+     * @param options Limits
+     */
+    explicit TestServer(StationPool& pool, const ServerOptions& options = {});
+
+    /**
+     * @brief Destructor; stops the server
+     */
+    ~TestServer();
+
+    TestServer(const TestServer&) = delete;
+    TestServer& operator=(const TestServer&) = delete;
+
+    /**
+     * @brief Bind the address and start serving
+     * @param address Listen address, see parseServerAddress()
+     * @return false if the address is malformed or cannot be bound
+     */
+    bool start(const std::string& address);
+
+    /**
+     * @brief Stop accepting requests and close every connection
+     *
+     * Tests already queued keep running; their results are discarded.
+     */
+    void stop();
+
+    /**
+     * @brief Check whether the server is serving
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Get the bound address, with the actual port if "0" was requested
+     * @return "host:port" or "unix:<path>"
+     */
+    std::string boundAddress() const;
+
+    /**
+     * @brief Get number of connected clients
+     */
+    size_t clientCount() const;
+
+    /**
+     * @brief Get the reason start() failed
+     */
+    std::string getLastError() const;
+
+private:
+    struct Waker;
+    struct Client;
+
+    void serve();
+    void acceptClients();
+    bool readRequests(const std::shared_ptr<Client>& client);
+    void handleRequest(const std::shared_ptr<Client>& client, std::string_view request);
+    void closeClient(Client& client);
+
+    StationPool& pool;
+    ServerOptions options;
+    int listenFd;
+    ServerAddress listenAddress;
+    std::string bound;
+    std::shared_ptr<Waker> waker;
+    std::vector<std::shared_ptr<Client>> clients;  // Only touched by the serve thread
+    std::atomic<size_t> connected;
+    std::atomic<bool> running;
+    std::thread thread;
+    mutable std::mutex errorMutex;
+    std::string lastError;
+};
+
+} // namespace MechatronicTest
+
+#endif // TEST_SERVER_H
@@ -0,0 +1,111 @@
+/**
+ * @file usb_interface.h
+ * @brief USB bulk-transfer hardware interface (requires libusb-1.0)
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef USB_INTERFACE_H
+#define USB_INTERFACE_H
+
+#include "equipment_controller.h"
+
+#ifdef HAS_LIBUSB
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct libusb_context;
+struct libusb_device_handle;
+struct libusb_transfer;
+
+namespace MechatronicTest {
+
+/**
+ * @brief Endpoint and queueing settings of a UsbInterface
+ */
+struct UsbOptions {
+    int interface_number = 0;
+    unsigned char bulk_in_endpoint = 0x81;
+    unsigned char bulk_out_endpoint = 0x01;
+    size_t transfer_size = 16384;        ///< Bytes per queued bulk-IN transfer
+    int queued_transfers = 8;            ///< Bulk-IN transfers kept submitted at all times
+    size_t receive_capacity = 1 << 20;   ///< Received bytes held until readAvailable() takes them
+    int send_timeout_ms = 1000;
+};
+
+/**
+ * @brief HardwareInterface over a pair of USB bulk endpoints
+ *
+ * The port is "<vid>:<pid>" in hex, optionally followed by ":<serial>"
+ * to pick one of several identical fixtures, e.g. "1209:0001:DAQ42".
+ *
+ * Several bulk-IN transfers stay queued on the device and each is
+ * resubmitted from its completion callback, so the device always has a
+ * buffer to fill while the host parses earlier data. Completed data goes
+ * into a byte ring that readAvailable() drains into the framer. If the
+ * reader falls behind by more than receive_capacity bytes, the newest
+ * data is discarded and counted in droppedBytes().
+ */
+class UsbInterface : public HardwareInterface {
+public:
+    /**
+     * @brief Constructor
+     * @param options Endpoints and queueing
+     */
+    explicit UsbInterface(const UsbOptions& options = {});
+    ~UsbInterface() override;
+
+    bool connect(const std::string& port, int baud_rate) override;
+    bool disconnect() override;
+    bool sendCommand(const std::string& command) override;
+    bool sendRaw(const char* data, size_t length) override;
+    bool isConnected() const override;
+
+    /**
+     * @brief Get number of received bytes discarded because the ring was full
+     * @return Dropped byte count
+     */
+    std::uint64_t droppedBytes() const { return dropped.load(std::memory_order_relaxed); }
+
+protected:
+    long readAvailable(char* buffer, size_t length, int timeout_ms) override;
+
+private:
+    static void transferComplete(libusb_transfer* transfer);
+    void onTransfer(libusb_transfer* transfer);
+    void handleEvents();
+    void release();
+    bool bulkOut(const unsigned char* data, size_t length);
+
+    UsbOptions options;
+    libusb_context* context;
+    libusb_device_handle* handle;
+    std::vector<libusb_transfer*> transfers;
+    std::vector<std::vector<unsigned char>> transferBuffers;
+    std::thread eventThread;
+    std::atomic<bool> running;
+    std::atomic<int> activeTransfers;
+    std::atomic<bool> connected;
+    std::string txBuffer;
+
+    // Byte ring between the event thread and readAvailable()
+    std::mutex ringMutex;
+    std::condition_variable dataReady;
+    std::vector<char> ring;
+    size_t ringHead;   ///< Next byte to read
+    size_t ringSize;   ///< Bytes held
+    bool failed;       ///< A transfer failed; the device is gone
+    std::atomic<std::uint64_t> dropped;
+};
+
+} // namespace MechatronicTest
+
+#endif // HAS_LIBUSB
+
+#endif // USB_INTERFACE_H
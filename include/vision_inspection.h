@@ -0,0 +1,214 @@
+/**
+ * @file vision_inspection.h
+ * @brief Camera inspection pipeline producing TestResults (requires OpenCV)
+ * @author Automated Mechatronic Test System Team
+ * @date 2024
+ */
+
+#ifndef VISION_INSPECTION_H
+#define VISION_INSPECTION_H
+
+#ifdef HAS_OPENCV
+
+#include "equipment_controller.h"
+#include "latency_histogram.h"
+#include "mpsc_queue.h"
+
+#include <opencv2/core.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Camera and measurement settings of a VisionInspector
+ */
+struct VisionOptions {
+    std::string camera = "0";      ///< cv::VideoCapture device index, file or stream URL
+    int width = 640;               ///< Frame size; every pooled buffer is allocated at this size
+    int height = 480;
+    size_t pool_frames = 6;        ///< Frames in flight across all stages
+    size_t queue_depth = 16;       ///< Inspections waiting for capture; more are rejected
+    cv::Rect roi;                  ///< Region measured; empty uses the whole frame
+    int blur_kernel = 5;           ///< Gaussian blur before thresholding; odd, 0 disables
+    double threshold = -1.0;       ///< Binarization level 0..255; negative picks one with Otsu's method
+    bool dark_part = false;        ///< The part is darker than the background
+    double min_area_px = 1.0;      ///< Largest blob must cover at least this many pixels
+    double max_area_px = 1e12;
+};
+
+/**
+ * @brief Fills a pooled frame; returns false if no image could be taken
+ *
+ * The frame is preallocated at the configured size and type CV_8UC3;
+ * writing into it in place (e.g. cv::VideoCapture::read()) avoids
+ * allocation. A source that replaces the buffer still works.
+ */
+using FrameSource = std::function<bool(cv::Mat& frame)>;
+
+/**
+ * @brief Stages of an inspection timed by VisionInspector
+ */
+enum class VisionStage : std::uint8_t {
+    QUEUED,      ///< From inspect() to the start of capture
+    CAPTURE,
+    PREPROCESS,  ///< Grayscale, blur and threshold
+    MEASURE,     ///< Contours and the verdict
+    COUNT
+};
+
+/**
+ * @brief Counters of a VisionInspector
+ */
+struct VisionStats {
+    std::uint64_t inspected;
+    std::uint64_t passed;
+    std::uint64_t capture_errors;
+    std::uint64_t rejected;           ///< inspect() calls refused because the queue was full
+    LatencySummary stages[static_cast<size_t>(VisionStage::COUNT)];
+};
+
+/**
+ * @brief Capture, preprocess and measure parts on three overlapping threads
+ *
+ * Each stage runs on its own thread and hands frames to the next through a
+ * bounded queue, so while one part is measured the next is preprocessed
+ * and a third captured. Frames come from a fixed pool allocated by start();
+ * when every frame is in flight, capture waits for one to be released instead
+ * of allocating, which bounds memory and applies backpressure.
+ *
+ * inspect() returns immediately, so a station can trigger the camera and
+ * then run its electrical tests on the same part while the image is taken
+ * and measured:
+ *
+ *     auto vision = inspector.inspect(part);
+ *     TestResult electrical = controller.runTest(part, params);
+ *     TestResult optical = vision.get();
+ *
+ * The measurement is the area in pixels of the largest blob in the region
+ * of interest. TestResult::measurements holds area, centroid x and y, and
+ * bounding box width and height, and the part passes if the area is within
+ * [min_area_px, max_area_px].
+ */
+class VisionInspector {
+public:
+    /**
+     * @brief Constructor
+     * @param options Camera and measurement settings
+     * @param source Frame source; null opens options.camera with cv::VideoCapture
+     */
+    explicit VisionInspector(const VisionOptions& options = {}, FrameSource source = nullptr);
+
+    /**
+     * @brief Destructor; stops the pipeline
+     */
+    ~VisionInspector();
+
+    VisionInspector(const VisionInspector&) = delete;
+    VisionInspector& operator=(const VisionInspector&) = delete;
+
+    /**
+     * @brief Open the camera, allocate the frame pool and start the stage threads
+     * @return false if the camera cannot be opened
+     */
+    bool start();
+
+    /**
+     * @brief Stop the stage threads; inspections not yet finished fail
+     */
+    void stop();
+
+    /**
+     * @brief Queue an inspection of one part
+     * @param device_id Part identifier, copied into the result
+     * @return Future result; ready at once with a failed result if the
+     *         pipeline is stopped or its queue is full
+     */
+    std::future<TestResult> inspect(const std::string& device_id);
+
+    /**
+     * @brief Get counters and per-stage latencies
+     */
+    VisionStats getStats() const;
+
+    /**
+     * @brief Get the reason start() failed
+     */
+    std::string getLastError() const;
+
+private:
+    struct Request {
+        std::string device_id;
+        std::promise<TestResult> promise;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    struct Frame {
+        cv::Mat raw;      ///< CV_8UC3 camera image
+        cv::Mat gray;
+        cv::Mat blurred;
+        cv::Mat mask;
+        Request request;
+        bool captured = false;
+        bool pending = false;  ///< request's promise not yet set
+    };
+
+    /**
+     * @brief Bounded hand-off of frame indices between two stages
+     */
+    struct Handoff {
+        explicit Handoff(size_t capacity) : queue(capacity) {}
+        MpscQueue<size_t> queue;
+        std::mutex mutex;
+        std::condition_variable ready;
+
+        void push(size_t frame);
+        bool pop(size_t& frame, const std::atomic<bool>& running);
+    };
+
+    void captureLoop();
+    void preprocessLoop();
+    void measureLoop();
+    void measure(Frame& frame, TestResult& result);
+    void finish(size_t frame, TestResult result);
+    static TestResult failedResult(const std::string& device_id, OutcomeCode outcome, const char* notes);
+
+    VisionOptions options;
+    FrameSource source;
+    std::vector<Frame> frames;
+    std::unique_ptr<MpscQueue<Request>> requests;
+    std::mutex requestMutex;
+    std::condition_variable requestReady;
+    std::unique_ptr<Handoff> freeFrames;
+    std::unique_ptr<Handoff> captured;
+    std::unique_ptr<Handoff> preprocessed;
+    std::vector<std::vector<cv::Point>> contours;  ///< Reused by the measure thread
+    std::atomic<bool> running;
+    std::thread captureThread;
+    std::thread preprocessThread;
+    std::thread measureThread;
+
+    std::atomic<std::uint64_t> inspectedCount;
+    std::atomic<std::uint64_t> passedCount;
+    std::atomic<std::uint64_t> captureErrors;
+    std::atomic<std::uint64_t> rejectedCount;
+    LatencyHistogram latency[static_cast<size_t>(VisionStage::COUNT)];
+
+    mutable std::mutex errorMutex;
+    std::string lastError;
+};
+
+} // namespace MechatronicTest
+
+#endif // HAS_OPENCV
+
+#endif // VISION_INSPECTION_H
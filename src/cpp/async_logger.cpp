@@ -0,0 +1,227 @@
+/**
+ * @file async_logger.cpp
+ * @brief Implementation of the asynchronous logger
+ */
+
+#include "async_logger.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace MechatronicTest {
+
+namespace {
+
+void copyTruncated(char* destination, size_t capacity, std::string_view source) {
+    size_t length = std::min(source.size(), capacity - 1);
+    std::memcpy(destination, source.data(), length);
+    destination[length] = '\0';
+}
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARNING: return "WARNING";
+        case LogLevel::ERROR: return "ERROR";
+    }
+    return "INFO";
+}
+
+} // namespace
+
+std::shared_ptr<AsyncLogger> AsyncLogger::forPath(const std::string& path, const LoggerOptions& options) {
+    static std::mutex registryMutex;
+    static std::map<std::string, std::weak_ptr<AsyncLogger>> registry;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto& entry = registry[path];
+    auto logger = entry.lock();
+    if (!logger) {
+        logger = std::make_shared<AsyncLogger>(path, options);
+        entry = logger;
+    }
+    return logger;
+}
+
+AsyncLogger::AsyncLogger(const std::string& path, const LoggerOptions& logger_options)
+    : filePath(path), options(logger_options), queue(std::max<size_t>(2, logger_options.queue_capacity)),
+      dropped(0), reportedDrops(0), file(nullptr), fileBytes(0), fileOpen(false), stopping(false),
+      flushRequests(0), flushesDone(0) {
+    options.flush_interval_ms = std::max(1, options.flush_interval_ms);
+    batch.reserve(64 * 1024);
+    openFile();
+    flusher = std::thread(&AsyncLogger::flusherLoop, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    stopping = true;
+    wakeCondition.notify_one();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+bool AsyncLogger::enqueue(LogEntry::Kind kind, LogLevel level, std::string_view source, std::string_view text,
+                          const ResultRecord* result) {
+    auto now = toEpochMicros(std::chrono::system_clock::now());
+    bool queued = queue.tryEmplace([&](LogEntry& entry) {
+        entry.kind = kind;
+        entry.level = level;
+        entry.timestamp_us = now;
+        if (result) {
+            entry.result = *result;
+        }
+        copyTruncated(entry.source, sizeof(entry.source), source);
+        copyTruncated(entry.text, sizeof(entry.text), text);
+    });
+    if (!queued) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    return queued;
+}
+
+bool AsyncLogger::log(LogLevel level, std::string_view source, std::string_view message) {
+    return enqueue(LogEntry::Kind::TEXT, level, source, message, nullptr);
+}
+
+bool AsyncLogger::logResult(std::string_view source, std::string_view device_id, const TestOutcome& outcome) {
+    ResultRecord record = makeResultRecord(outcome, 0, 0);
+    return enqueue(LogEntry::Kind::RESULT, outcome.code == OutcomeCode::COMPLETED ? LogLevel::INFO : LogLevel::ERROR,
+                   source, device_id, &record);
+}
+
+bool AsyncLogger::logResult(std::string_view source, const TestResult& result) {
+    ResultRecord record = makeResultRecord(result, 0, 0);
+    return enqueue(LogEntry::Kind::RESULT, record.outcome == OutcomeCode::COMPLETED ? LogLevel::INFO : LogLevel::ERROR,
+                   source, result.device_id, &record);
+}
+
+void AsyncLogger::flush() {
+    std::uint64_t request = flushRequests.fetch_add(1, std::memory_order_acq_rel) + 1;
+    wakeCondition.notify_one();
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (flushesDone.load(std::memory_order_acquire) < request) {
+        wakeCondition.wait_for(lock, std::chrono::milliseconds(options.flush_interval_ms));
+    }
+}
+
+void AsyncLogger::flusherLoop() {
+    for (;;) {
+        bool stop = stopping.load(std::memory_order_acquire);
+        std::uint64_t requested = flushRequests.load(std::memory_order_acquire);
+
+        drain();
+        if (requested != flushesDone.load(std::memory_order_relaxed)) {
+            flushesDone.store(requested, std::memory_order_release);
+            wakeCondition.notify_all();
+        }
+        if (stop) {
+            break;
+        }
+
+        // Producers never signal, so poll; explicit flushes and shutdown wake early
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wakeCondition.wait_for(lock, std::chrono::milliseconds(options.flush_interval_ms), [this] {
+            return stopping.load() || flushRequests.load() != flushesDone.load();
+        });
+    }
+}
+
+size_t AsyncLogger::drain() {
+    size_t count = 0;
+    batch.clear();
+    while (queue.tryConsume([this](LogEntry& entry) { appendEntry(entry); })) {
+        ++count;
+    }
+
+    std::uint64_t lost = dropped.load(std::memory_order_relaxed);
+    if (lost != reportedDrops) {
+        batch += "[WARNING] logger: ";
+        batch += std::to_string(lost - reportedDrops);
+        batch += " messages dropped (queue full)\n";
+        reportedDrops = lost;
+    }
+
+    if (!batch.empty()) {
+        rotateIfNeeded();
+        if (file) {
+            std::fwrite(batch.data(), 1, batch.size(), file);
+            std::fflush(file);
+            fileBytes += batch.size();
+        }
+    }
+    return count;
+}
+
+void AsyncLogger::appendEntry(const LogEntry& entry) {
+    auto when = fromEpochMicros(entry.timestamp_us);
+    char stamp[48];
+    size_t length = formatTimestamp(when, stamp, sizeof(stamp));
+    std::snprintf(stamp + length, sizeof(stamp) - length, ".%03d",
+                  static_cast<int>((entry.timestamp_us / 1000) % 1000));
+
+    batch += stamp;
+    batch += " [";
+    batch += levelName(entry.level);
+    batch += "] ";
+    batch += entry.source;
+    batch += ": ";
+
+    if (entry.kind == LogEntry::Kind::RESULT) {
+        const ResultRecord& result = entry.result;
+        char value[32];
+        std::snprintf(value, sizeof(value), "%.6g", result.value);
+        batch += "RESULT ";
+        batch += entry.text;
+        batch += result.passed ? " PASS " : " FAIL ";
+        batch += value;
+        batch += ' ';
+        batch += unitCodeToString(result.unit);
+        batch += " (";
+        batch += outcomeNote(result.outcome);
+        batch += ')';
+    } else {
+        batch += entry.text;
+    }
+    batch += '\n';
+}
+
+void AsyncLogger::rotateIfNeeded() {
+    bool bySize = options.max_file_bytes > 0 && fileBytes >= options.max_file_bytes;
+    bool byAge = options.rotate_interval_s > 0 &&
+                 std::chrono::steady_clock::now() - fileOpened >= std::chrono::seconds(options.rotate_interval_s);
+    if (!file || !(bySize || byAge)) {
+        return;
+    }
+
+    std::fclose(file);
+    file = nullptr;
+
+    // path.N-1 -> path.N, ..., path -> path.1
+    int keep = std::max(1, options.max_files);
+    std::remove((filePath + "." + std::to_string(keep)).c_str());
+    for (int i = keep - 1; i >= 1; --i) {
+        std::rename((filePath + "." + std::to_string(i)).c_str(),
+                    (filePath + "." + std::to_string(i + 1)).c_str());
+    }
+    std::rename(filePath.c_str(), (filePath + ".1").c_str());
+    openFile();
+}
+
+void AsyncLogger::openFile() {
+    file = std::fopen(filePath.c_str(), "a");
+    fileBytes = 0;
+    if (file) {
+        std::fseek(file, 0, SEEK_END);
+        long position = std::ftell(file);
+        fileBytes = position > 0 ? static_cast<size_t>(position) : 0;
+    }
+    fileOpened = std::chrono::steady_clock::now();
+    fileOpen.store(file != nullptr, std::memory_order_release);
+}
+
+} // namespace MechatronicTest
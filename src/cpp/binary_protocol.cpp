@@ -0,0 +1,280 @@
+/**
+ * @file binary_protocol.cpp
+ * @brief Implementation of the binary device protocol
+ */
+
+#include "binary_protocol.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace MechatronicTest {
+
+namespace {
+
+constexpr size_t MAX_BODY = BINARY_MAX_PAYLOAD + BINARY_FRAME_OVERHEAD;
+
+struct Crc16Table {
+    std::uint16_t entries[256];
+
+    Crc16Table() {
+        for (unsigned i = 0; i < 256; ++i) {
+            std::uint16_t crc = static_cast<std::uint16_t>(i << 8);
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = static_cast<std::uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+            }
+            entries[i] = crc;
+        }
+    }
+};
+
+const Crc16Table CRC16_TABLE;
+
+/**
+ * @brief Builds a payload of length-prefixed fields in a fixed buffer
+ */
+struct PayloadWriter {
+    unsigned char bytes[BINARY_MAX_PAYLOAD];
+    size_t length = 0;
+    bool overflow = false;
+
+    void byte(unsigned char value) {
+        if (length >= sizeof(bytes)) {
+            overflow = true;
+            return;
+        }
+        bytes[length++] = value;
+    }
+
+    void field(std::string_view text) {
+        if (text.size() > 255 || length + 1 + text.size() > sizeof(bytes)) {
+            overflow = true;
+            return;
+        }
+        bytes[length++] = static_cast<unsigned char>(text.size());
+        std::memcpy(bytes + length, text.data(), text.size());
+        length += text.size();
+    }
+};
+
+/**
+ * @brief COBS-encode data and append it followed by the 0x00 delimiter
+ */
+void appendCobs(std::string& out, const unsigned char* data, size_t length) {
+    size_t codeAt = out.size();
+    out.push_back('\0');
+    unsigned char code = 1;
+    for (size_t i = 0; i < length; ++i) {
+        if (data[i] == 0) {
+            out[codeAt] = static_cast<char>(code);
+            codeAt = out.size();
+            out.push_back('\0');
+            code = 1;
+            continue;
+        }
+        out.push_back(static_cast<char>(data[i]));
+        if (++code == 0xFF) {
+            out[codeAt] = static_cast<char>(code);
+            codeAt = out.size();
+            out.push_back('\0');
+            code = 1;
+        }
+    }
+    out[codeAt] = static_cast<char>(code);
+    out.push_back('\0');
+}
+
+bool decodeCobs(std::string_view encoded, unsigned char* out, size_t capacity, size_t& length) {
+    length = 0;
+    size_t i = 0;
+    while (i < encoded.size()) {
+        auto code = static_cast<unsigned char>(encoded[i++]);
+        if (code == 0) return false;
+        for (unsigned j = 1; j < code; ++j) {
+            if (i >= encoded.size() || length >= capacity) return false;
+            out[length++] = static_cast<unsigned char>(encoded[i++]);
+        }
+        if (code != 0xFF && i < encoded.size()) {
+            if (length >= capacity) return false;
+            out[length++] = 0;
+        }
+    }
+    return true;
+}
+
+void putLe16(unsigned char* out, std::uint16_t value) {
+    out[0] = static_cast<unsigned char>(value & 0xFF);
+    out[1] = static_cast<unsigned char>(value >> 8);
+}
+
+std::uint16_t getLe16(const unsigned char* in) {
+    return static_cast<std::uint16_t>(in[0] | (in[1] << 8));
+}
+
+void putFloat(unsigned char* out, float value) {
+    static_assert(sizeof(float) == 4, "binary frames carry IEEE-754 binary32 values");
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<unsigned char>(bits >> (8 * i));
+    }
+}
+
+float getFloat(const unsigned char* in) {
+    std::uint32_t bits = 0;
+    for (int i = 0; i < 4; ++i) {
+        bits |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+std::uint16_t crc16(const void* data, size_t length) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    std::uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc = static_cast<std::uint16_t>((crc << 8) ^ CRC16_TABLE.entries[((crc >> 8) ^ bytes[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+bool appendBinaryFrame(std::string& out, BinaryOpcode opcode, std::uint16_t sequence,
+                       const void* payload, size_t length) {
+    if (length > BINARY_MAX_PAYLOAD) {
+        return false;
+    }
+    unsigned char body[MAX_BODY];
+    body[0] = static_cast<unsigned char>(length);
+    body[1] = static_cast<unsigned char>(opcode);
+    putLe16(body + 2, sequence);
+    if (length > 0) {
+        std::memcpy(body + 4, payload, length);
+    }
+    putLe16(body + 4 + length, crc16(body, 4 + length));
+    appendCobs(out, body, length + BINARY_FRAME_OVERHEAD);
+    return true;
+}
+
+BinaryDecodeStatus decodeBinaryFrame(std::string_view encoded, BinaryFrame& frame) {
+    unsigned char body[MAX_BODY];
+    size_t length = 0;
+    if (!decodeCobs(encoded, body, sizeof(body), length) || length < BINARY_FRAME_OVERHEAD) {
+        return BinaryDecodeStatus::MALFORMED;
+    }
+    if (crc16(body, length - 2) != getLe16(body + length - 2)) {
+        return BinaryDecodeStatus::BAD_CRC;
+    }
+    if (body[0] != length - BINARY_FRAME_OVERHEAD) {
+        return BinaryDecodeStatus::MALFORMED;
+    }
+
+    frame.opcode = static_cast<BinaryOpcode>(body[1]);
+    frame.sequence = getLe16(body + 2);
+    frame.length = body[0];
+    std::memcpy(frame.payload, body + 4, frame.length);
+    return BinaryDecodeStatus::OK;
+}
+
+bool encodeTestCommand(std::string& command, std::uint16_t sequence, std::string_view device_id,
+                       const std::vector<std::string>& test_parameters) {
+    command.clear();
+    PayloadWriter payload;
+    payload.field(device_id);
+    for (const auto& param : test_parameters) {
+        payload.field(param);
+    }
+    return !payload.overflow &&
+           appendBinaryFrame(command, BinaryOpcode::TEST, sequence, payload.bytes, payload.length);
+}
+
+bool encodeBatchCommand(std::string& command, std::uint16_t sequence, const std::vector<std::string>& device_ids,
+                        size_t first, size_t last, const std::vector<std::string>& test_parameters) {
+    command.clear();
+    if (last - first > 255) {
+        return false;
+    }
+    PayloadWriter payload;
+    payload.byte(static_cast<unsigned char>(last - first));
+    for (size_t i = first; i < last; ++i) {
+        payload.field(device_ids[i]);
+    }
+    for (const auto& param : test_parameters) {
+        payload.field(param);
+    }
+    return !payload.overflow &&
+           appendBinaryFrame(command, BinaryOpcode::BATCH, sequence, payload.bytes, payload.length);
+}
+
+void appendResultFrame(std::string& out, std::uint16_t sequence, float value, UnitCode unit, bool passed) {
+    unsigned char payload[6];
+    putFloat(payload, value);
+    payload[4] = static_cast<unsigned char>(unit);
+    payload[5] = passed ? 1 : 0;
+    appendBinaryFrame(out, BinaryOpcode::RESULT, sequence, payload, sizeof(payload));
+}
+
+bool parseBinaryResult(const BinaryFrame& frame, TestOutcome& outcome) {
+    if (frame.opcode != BinaryOpcode::RESULT || frame.length < 6) {
+        return false;
+    }
+    float value = getFloat(frame.payload);
+
+    UnitCode unit = frame.payload[4] <= static_cast<unsigned char>(UnitCode::OTHER)
+        ? static_cast<UnitCode>(frame.payload[4]) : UnitCode::OTHER;
+    const char* units = unitCodeToString(unit);
+    size_t unitsLength = std::min(std::strlen(units), sizeof(outcome.units) - 1);
+    std::memcpy(outcome.units, units, unitsLength);
+    outcome.units[unitsLength] = '\0';
+
+    outcome.code = OutcomeCode::COMPLETED;
+    outcome.measurement_value = value;
+    outcome.unit = unit;
+    outcome.passed = frame.payload[5] == 1;
+    outcome.channel_count = 1;
+    return true;
+}
+
+void appendChannelFrames(std::string& out, std::uint16_t sequence, const double* readings, size_t count) {
+    unsigned char payload[BINARY_MAX_PAYLOAD];
+    for (size_t first = 0; first < count; first += BINARY_CHANNELS_PER_FRAME) {
+        size_t n = std::min(BINARY_CHANNELS_PER_FRAME, count - first);
+        putLe16(payload, static_cast<std::uint16_t>(first));
+        for (size_t i = 0; i < n; ++i) {
+            putFloat(payload + 2 + 4 * i, static_cast<float>(readings[first + i]));
+        }
+        appendBinaryFrame(out, BinaryOpcode::CHANNELS, sequence, payload, 2 + 4 * n);
+    }
+}
+
+bool parseBinaryChannels(const BinaryFrame& frame, std::vector<double>& readings) {
+    if (frame.opcode != BinaryOpcode::CHANNELS || frame.length < 2 || (frame.length - 2) % 4 != 0) {
+        return false;
+    }
+    size_t first = getLe16(frame.payload);
+    size_t n = (frame.length - 2) / 4;
+    if (readings.size() < first + n) {
+        readings.resize(first + n, std::numeric_limits<double>::quiet_NaN());
+    }
+    for (size_t i = 0; i < n; ++i) {
+        readings[first + i] = getFloat(frame.payload + 2 + 4 * i);
+    }
+    return true;
+}
+
+bool splitBinaryFields(const BinaryFrame& frame, size_t offset, std::vector<std::string_view>& fields) {
+    fields.clear();
+    while (offset < frame.length) {
+        size_t size = frame.payload[offset++];
+        if (offset + size > frame.length) {
+            return false;
+        }
+        fields.emplace_back(reinterpret_cast<const char*>(frame.payload) + offset, size);
+        offset += size;
+    }
+    return true;
+}
+
+} // namespace MechatronicTest
@@ -0,0 +1,133 @@
+/**
+ * @file calibration_cache.cpp
+ * @brief Implementation of the calibration profile cache
+ */
+
+#include "calibration_cache.h"
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string_view>
+
+namespace MechatronicTest {
+
+namespace {
+
+bool storable(const std::string& text) {
+    return text.find_first_of("\t\r\n") == std::string::npos;
+}
+
+} // namespace
+
+bool calibrationValid(const CalibrationProfile& profile, std::chrono::seconds validity,
+                      std::chrono::system_clock::time_point now) {
+    auto age = now - profile.calibrated_at;
+    return age >= std::chrono::system_clock::duration::zero() && age < validity;
+}
+
+std::shared_ptr<CalibrationCache> CalibrationCache::forPath(const std::string& path) {
+    static std::mutex registryMutex;
+    static std::map<std::string, std::weak_ptr<CalibrationCache>> registry;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto& entry = registry[path];
+    auto cache = entry.lock();
+    if (!cache) {
+        cache = std::make_shared<CalibrationCache>(path);
+        entry = cache;
+    }
+    return cache;
+}
+
+CalibrationCache::CalibrationCache(std::string path) : filePath(std::move(path)) {}
+
+bool CalibrationCache::find(const std::string& fixture_id, CalibrationProfile& profile) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Profiles profiles = readFile();
+    auto it = profiles.find(fixture_id);
+    if (it == profiles.end()) {
+        return false;
+    }
+    profile = it->second;
+    return true;
+}
+
+bool CalibrationCache::store(const CalibrationProfile& profile) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (profile.fixture_id.empty() || !storable(profile.fixture_id) || !storable(profile.data)) {
+        lastError = "Calibration profile contains tabs or newlines";
+        return false;
+    }
+    Profiles profiles = readFile();
+    profiles[profile.fixture_id] = profile;
+    return writeFile(profiles);
+}
+
+bool CalibrationCache::erase(const std::string& fixture_id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Profiles profiles = readFile();
+    if (profiles.erase(fixture_id) == 0) {
+        return true;
+    }
+    return writeFile(profiles);
+}
+
+std::string CalibrationCache::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastError;
+}
+
+CalibrationCache::Profiles CalibrationCache::readFile() const {
+    Profiles profiles;
+    std::ifstream in(filePath);
+    std::string line;
+    while (std::getline(in, line)) {
+        // Lines that do not parse, e.g. from a newer format, are skipped
+        size_t first = line.find('\t');
+        size_t second = first == std::string::npos ? first : line.find('\t', first + 1);
+        if (first == 0 || second == std::string::npos) continue;
+
+        std::int64_t micros = 0;
+        auto parsed = std::from_chars(line.data() + first + 1, line.data() + second, micros);
+        if (parsed.ec != std::errc() || parsed.ptr != line.data() + second) continue;
+
+        CalibrationProfile profile;
+        profile.fixture_id = line.substr(0, first);
+        profile.calibrated_at = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(micros)));
+        profile.data = line.substr(second + 1);
+        profiles[profile.fixture_id] = std::move(profile);
+    }
+    return profiles;
+}
+
+bool CalibrationCache::writeFile(const Profiles& profiles) {
+    std::string temporary = filePath + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        for (const auto& entry : profiles) {
+            const CalibrationProfile& profile = entry.second;
+            auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                profile.calibrated_at.time_since_epoch()).count();
+            out << profile.fixture_id << '\t' << micros << '\t' << profile.data << '\n';
+        }
+        out.flush();
+        if (!out) {
+            lastError = "Failed to write calibration cache " + temporary;
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+#ifdef _WIN32
+    std::remove(filePath.c_str());  // rename() does not replace an existing file on Windows
+#endif
+    if (std::rename(temporary.c_str(), filePath.c_str()) != 0) {
+        lastError = "Failed to replace calibration cache " + filePath;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace MechatronicTest
@@ -4,24 +4,121 @@
  */
 
 #include "equipment_controller.h"
+#include "result_journal.h"
+#include "simulated_interface.h"
+#include "tcp_interface.h"
+#include "usb_interface.h"
+#include "serial_port_config.h"
+#include "binary_protocol.h"
+#include "limit_check.h"
+#include "calibration_cache.h"
+#include "retry_policy.h"
+#include "async_logger.h"
+#include "status_dispatcher.h"
+#include "spsc_ring.h"
 #include <iostream>
 #include <chrono>
 #include <ctime>
-#include <iomanip>
-#include <sstream>
 #include <algorithm>
 #include <thread>
+#include <atomic>
+#include <cstring>
+#include <cerrno>
+#include <deque>
+#include <condition_variable>
+#include <future>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
 
 #ifdef _WIN32
 #include <windows.h>
 #else
-#include <termios.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <poll.h>
 #endif
 
 namespace MechatronicTest {
 
+// HardwareInterface receive path shared by all implementations
+std::string HardwareInterface::receiveResponse(int timeout_ms) {
+    return std::string(receiveFrame(timeout_ms));
+}
+
+std::string_view HardwareInterface::receiveFrame(int timeout_ms) {
+    std::string_view frame;
+    if (receiveBuffer.nextFrame(frame)) {
+        // Arrived together with an earlier frame
+        frameTiming.first_byte = frameTiming.terminator = partialSince;
+        return frame;
+    }
+    if (!isConnected()) {
+        return {};
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) break;
+
+        size_t space = 0;
+        char* region = receiveBuffer.prepareWrite(space);
+        bool wasEmpty = receiveBuffer.buffered() == 0;
+        long bytesRead = readAvailable(region, space, static_cast<int>(remaining));
+        if (bytesRead < 0) break;
+        if (bytesRead == 0) continue;
+
+        auto arrived = std::chrono::steady_clock::now();
+        receivedBytes.fetch_add(static_cast<std::uint64_t>(bytesRead), std::memory_order_relaxed);
+        if (wasEmpty) {
+            partialSince = arrived;
+        }
+        receiveBuffer.commitWrite(static_cast<size_t>(bytesRead));
+        if (receiveBuffer.nextFrame(frame)) {
+            frameTiming.first_byte = partialSince;
+            frameTiming.terminator = arrived;
+            partialSince = arrived;  // Any leftover bytes came with this read
+            return frame;
+        }
+    }
+    return {};
+}
+
+size_t HardwareInterface::discardInput() {
+    size_t dropped = receiveBuffer.buffered();
+    receiveBuffer.clear();
+    if (!isConnected()) {
+        return dropped;
+    }
+
+    // Poll until the device has nothing more; a zero timeout never blocks
+    while (true) {
+        size_t space = 0;
+        char* region = receiveBuffer.prepareWrite(space);
+        long bytesRead = readAvailable(region, space, 0);
+        if (bytesRead <= 0) break;
+        receivedBytes.fetch_add(static_cast<std::uint64_t>(bytesRead), std::memory_order_relaxed);
+        dropped += static_cast<size_t>(bytesRead);
+        receiveBuffer.clear();
+    }
+    return dropped;
+}
+
+bool HardwareInterface::sendRaw(const char* data, size_t length) {
+    (void)data;
+    (void)length;
+    return false;
+}
+
+long HardwareInterface::readAvailable(char* buffer, size_t length, int timeout_ms) {
+    (void)buffer;
+    (void)length;
+    (void)timeout_ms;
+    return -1;
+}
+
 /**
  * @brief Serial hardware interface implementation
  */
@@ -32,7 +129,9 @@ private:
 #else
     int serial_fd;
 #endif
-    bool connected;
+    std::atomic<bool> connected;
+    std::string txBuffer;
+    SerialOptions options;
 
 public:
     SerialInterface() : connected(false) {
@@ -47,6 +146,10 @@ public:
         disconnect();
     }
 
+    void configure(const EquipmentConfig& config) override {
+        options = serialOptionsFrom(config);
+    }
+
     bool connect(const std::string& port, int baud_rate) override {
 #ifdef _WIN32
         std::string portName = "\\\\.\\" + port;
@@ -92,38 +195,18 @@ public:
             return false;
         }
 #else
-        serial_fd = open(port.c_str(), O_RDWR | O_NOCTTY | O_SYNC);
+        options.baud_rate = baud_rate > 0 ? baud_rate : options.baud_rate;
+        serial_fd = open(port.c_str(), serialOpenFlags(options));
         if (serial_fd < 0) {
             return false;
         }
-
-        struct termios tty;
-        if (tcgetattr(serial_fd, &tty) != 0) {
-            close(serial_fd);
-            return false;
-        }
-
-        cfsetospeed(&tty, B115200);
-        cfsetispeed(&tty, B115200);
-
-        tty.c_cflag = (tty.c_cflag & ~CSIZE) | CS8;
-        tty.c_iflag &= ~IGNBRK;
-        tty.c_lflag = 0;
-        tty.c_oflag = 0;
-        tty.c_cc[VMIN] = 0;
-        tty.c_cc[VTIME] = 5;
-
-        tty.c_iflag &= ~(IXON | IXOFF | IXANY);
-        tty.c_cflag |= (CLOCAL | CREAD);
-        tty.c_cflag &= ~(PARENB | PARODD);
-        tty.c_cflag &= ~CSTOPB;
-        tty.c_cflag &= ~CRTSCTS;
-
-        if (tcsetattr(serial_fd, TCSANOW, &tty) != 0) {
+        if (!configureSerialPort(serial_fd, options)) {
             close(serial_fd);
+            serial_fd = -1;
             return false;
         }
 #endif
+        resetReceiveBuffer();
         connected = true;
         return true;
     }
@@ -149,54 +232,89 @@ public:
     bool sendCommand(const std::string& command) override {
         if (!connected) return false;
 
-        std::string cmd = command + "\r\n";
+        // Reuse one buffer so steady-state sends do not allocate
+        std::string& cmd = txBuffer;
+        cmd.assign(command);
+        cmd += "\r\n";
 #ifdef _WIN32
         DWORD bytesWritten;
-        return WriteFile(hSerial, cmd.c_str(), cmd.length(), &bytesWritten, NULL) && 
-               bytesWritten == cmd.length();
+        bool written = WriteFile(hSerial, cmd.c_str(), cmd.length(), &bytesWritten, NULL) &&
+                       bytesWritten == cmd.length();
 #else
-        return write(serial_fd, cmd.c_str(), cmd.length()) == static_cast<ssize_t>(cmd.length());
+        bool written = write(serial_fd, cmd.c_str(), cmd.length()) == static_cast<ssize_t>(cmd.length());
 #endif
+        if (written) {
+            countSent(cmd.length());
+        }
+        return written;
     }
 
-    std::string receiveResponse(int timeout_ms) override {
-        if (!connected) return "";
-
-        std::string response;
-        char buffer[256];
-        auto start = std::chrono::steady_clock::now();
-
-        while (std::chrono::duration_cast<std::chrono::milliseconds>(
-                   std::chrono::steady_clock::now() - start).count() < timeout_ms) {
+    bool sendRaw(const char* data, size_t length) override {
+        if (!connected) return false;
 #ifdef _WIN32
-            DWORD bytesRead;
-            if (ReadFile(hSerial, buffer, sizeof(buffer) - 1, &bytesRead, NULL) && bytesRead > 0) {
-                buffer[bytesRead] = '\0';
-                response += buffer;
-                if (response.find('\n') != std::string::npos) break;
-            }
+        DWORD bytesWritten;
+        bool written = WriteFile(hSerial, data, static_cast<DWORD>(length), &bytesWritten, NULL) &&
+                       bytesWritten == length;
 #else
-            int bytesRead = read(serial_fd, buffer, sizeof(buffer) - 1);
-            if (bytesRead > 0) {
-                buffer[bytesRead] = '\0';
-                response += buffer;
-                if (response.find('\n') != std::string::npos) break;
-            }
+        bool written = write(serial_fd, data, length) == static_cast<ssize_t>(length);
 #endif
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (written) {
+            countSent(length);
         }
-
-        // Remove trailing whitespace
-        response.erase(std::find_if(response.rbegin(), response.rend(),
-                      [](unsigned char ch) { return !std::isspace(ch); }).base(),
-                      response.end());
-
-        return response;
+        return written;
     }
 
     bool isConnected() const override {
         return connected;
     }
+
+protected:
+    long readAvailable(char* buffer, size_t length, int timeout_ms) override {
+#ifdef _WIN32
+        // MAXDWORD interval and multiplier make ReadFile return as soon as any
+        // byte is available, or after the constant timeout if none arrives
+        COMMTIMEOUTS timeouts = {0};
+        timeouts.ReadIntervalTimeout = MAXDWORD;
+        timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+        timeouts.ReadTotalTimeoutConstant = static_cast<DWORD>(timeout_ms);
+        timeouts.WriteTotalTimeoutConstant = 50;
+        timeouts.WriteTotalTimeoutMultiplier = 10;
+        if (!SetCommTimeouts(hSerial, &timeouts)) {
+            return -1;
+        }
+
+        DWORD bytesRead = 0;
+        if (!ReadFile(hSerial, buffer, static_cast<DWORD>(length), &bytesRead, NULL)) {
+            return -1;
+        }
+        return static_cast<long>(bytesRead);
+#else
+        struct pollfd pfd;
+        pfd.fd = serial_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int ready = poll(&pfd, 1, timeout_ms);
+        if (ready < 0) {
+            return errno == EINTR ? 0 : -1;
+        }
+        if (ready == 0) {
+            return 0;
+        }
+        if (pfd.revents & (POLLERR | POLLNVAL)) {
+            return -1;
+        }
+
+        ssize_t bytesRead = read(serial_fd, buffer, length);
+        if (bytesRead < 0) {
+            return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+        }
+        if (bytesRead == 0 && (pfd.revents & POLLHUP)) {
+            return -1;
+        }
+        return static_cast<long>(bytesRead);
+#endif
+    }
 };
 
 /**
@@ -204,69 +322,1234 @@ public:
  */
 class EquipmentController::Impl {
 public:
-    EquipmentStatus status;
+    std::atomic<EquipmentStatus> status;
     EquipmentConfig config;
-    std::string lastError;
-    StatusCallback statusCallback;
+    mutable std::mutex errorMutex;
+    std::string lastError;  ///< Guarded by errorMutex; set from the worker, stream and calling threads
     std::unique_ptr<HardwareInterface> hardware;
-    mutable std::mutex statusMutex;
+
+    // Status listeners run on the dispatcher's thread, never under a controller lock
+    StatusDispatcher statusDispatcher;
+    StatusListenerId statusCallbackId;
+
     std::thread workerThread;
     bool shouldStop;
 
-    Impl() : status(EquipmentStatus::IDLE), shouldStop(false) {}
+    // Work queue drained by workerThread; guarded by workMutex
+    std::mutex workMutex;
+    std::condition_variable workCondition;
+    std::deque<std::function<void()>> workQueue;
+
+    // Serializes use of the hardware link and the pipeline state below
+    mutable std::mutex ioMutex;
+
+    /**
+     * @brief A test command that has been sent but not yet answered
+     */
+    struct PendingTest {
+        TestTicket ticket;
+        std::string device_id;
+    };
+    std::deque<PendingTest> pendingTests;
+    std::atomic<size_t> pendingCount{0};  ///< pendingTests.size(), readable without ioMutex
+    std::vector<std::pair<TestTicket, TestResult>> completedTests;
+    TestTicket nextTicket;
+    std::string commandBuffer;
+    std::string lastInvalidResponse;
+    bool binaryProtocol;  ///< Negotiated at initialize(); commands and responses use binary frames
+    BinaryFrame replyFrame;            ///< Binary reply last returned by receiveReply(), already decoded
+    BinaryDecodeStatus replyStatus;
+    std::vector<double> readings;      ///< Channel readings of the last decoded reply
+    std::uint16_t stagedSequence;      ///< Sequence of CHANNELS frames gathered in readings
+    bool readingsStaged;
+    ChannelLimits limits;              ///< Host-side limits; empty leaves the verdict to the device
+    RetryPolicy retryPolicy;
+    std::uint64_t retryRandom;         ///< Backoff jitter state; only used under ioMutex
+    ResponseTimeoutEstimator timeouts;
+    SpcMonitor spc;
+    std::mutex spcCallbackMutex;
+    SpcAlarmCallback spcCallback;  ///< Guarded by spcCallbackMutex
+    bool replyOverdue;                 ///< The last synchronous command timed out; its reply may still arrive
+    std::chrono::steady_clock::time_point overdueUntil;  ///< When that reply is given up for lost
+    bool awaitLateReplies;             ///< The device has answered since a reply was last lost, so overdue ones are waited for
+    std::vector<std::uint64_t> failMask;  ///< Failed channels of the last decoded reply
+    std::unique_ptr<ResultJournal> journal;
+    std::shared_ptr<AsyncLogger> logger;
+    std::shared_ptr<CalibrationCache> calibrationCache;
+
+    // Last successful calibration; guarded by calibrationMutex, not ioMutex,
+    // so it can be queried while the device calibrates
+    mutable std::mutex calibrationMutex;
+    CalibrationProfile calibration;
+    bool calibrated;
+
+    // Per-stage timings of synchronous tests; written lock-free from any thread
+    LatencyHistogram latency[LATENCY_STAGE_COUNT];
+
+    /**
+     * @brief Streaming acquisition; the reader thread holds ioMutex while it runs, so
+     *        commands check active and fail fast instead of waiting for the lock
+     */
+    struct Stream {
+        std::mutex control;                ///< Serializes startStream() and stopStream()
+        std::unique_ptr<SpscRing<SampleBlock>> ring;
+        SampleBlock overflow;              ///< Filled instead of a ring block while the ring is full
+        std::vector<double> frameSamples;  ///< Samples of the DATA frame being split into blocks
+        std::thread reader;
+        std::atomic<bool> active{false};
+        std::atomic<bool> stopRequested{false};
+        std::mutex readyMutex;
+        std::condition_variable ready;
+        std::atomic<std::uint64_t> blocks{0};
+        std::atomic<std::uint64_t> samples{0};
+        std::atomic<std::uint64_t> droppedBlocks{0};
+        std::atomic<std::uint64_t> droppedSamples{0};
+        std::atomic<std::uint64_t> missedFrames{0};
+        std::atomic<std::uint64_t> malformedFrames{0};
+        std::atomic<bool> deviceEnded{false};
+        std::atomic<bool> linkLost{false};
+    } stream;
+
+    /**
+     * @brief Health counters, updated with relaxed atomics on the test path
+     */
+    struct HealthCounters {
+        std::atomic<std::uint64_t> tests{0};
+        std::atomic<std::uint64_t> passed{0};
+        std::atomic<std::uint64_t> failed{0};
+        std::atomic<std::uint64_t> errors{0};
+        std::atomic<std::uint64_t> timeouts{0};
+        std::atomic<std::uint64_t> retries{0};
+        std::atomic<std::uint64_t> recovered{0};
+        std::atomic<std::uint64_t> responseNanos{0};
+        std::atomic<std::uint64_t> responses{0};
+        std::atomic<std::chrono::steady_clock::rep> initializedAt{0};  ///< steady_clock ticks; 0 before initialize()
+    } health;
+
+    Impl() : status(EquipmentStatus::IDLE), statusCallbackId(0), shouldStop(false), nextTicket(1),
+             binaryProtocol(false), replyStatus(BinaryDecodeStatus::MALFORMED), stagedSequence(0),
+             readingsStaged(false),
+             retryRandom(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(this)) ^
+                         static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())),
+             replyOverdue(false), awaitLateReplies(false), calibrated(false) {
+        spc.setAlarmCallback([this](const SpcAlarm& alarm) { reportSpcAlarm(alarm); });
+    }
 
     ~Impl() {
-        if (workerThread.joinable()) {
+        stopStream();
+        stopWorker();
+    }
+
+    /**
+     * @brief Queue a task for the worker thread, starting it on first use
+     */
+    void post(std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(workMutex);
+        workQueue.push_back(std::move(task));
+        if (!workerThread.joinable()) {
+            shouldStop = false;
+            workerThread = std::thread([this]() { workerLoop(); });
+        }
+        workCondition.notify_one();
+    }
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(workMutex);
+        while (true) {
+            if (shouldStop) break;
+            if (workQueue.empty()) {
+                workCondition.wait_for(lock, std::chrono::milliseconds(100));
+                continue;
+            }
+
+            std::function<void()> task = std::move(workQueue.front());
+            workQueue.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    /**
+     * @brief Stop the worker after its current task; queued tasks are discarded
+     */
+    void stopWorker() {
+        {
+            std::lock_guard<std::mutex> lock(workMutex);
             shouldStop = true;
+        }
+        workCondition.notify_all();
+        if (workerThread.joinable()) {
             workerThread.join();
         }
+
+        std::lock_guard<std::mutex> lock(workMutex);
+        workQueue.clear();
     }
 
     void setStatus(EquipmentStatus newStatus, const std::string& message = "") {
-        std::lock_guard<std::mutex> lock(statusMutex);
-        status = newStatus;
-        if (statusCallback) {
-            statusCallback(status, message);
+        if (logger && !message.empty()) {
+            logger->log(newStatus == EquipmentStatus::ERROR ? LogLevel::ERROR : LogLevel::INFO,
+                        config.device_port, message);
+        }
+
+        status.store(newStatus);
+        statusDispatcher.publish(newStatus, message);
+    }
+
+    void setError(std::string_view message) {
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            lastError.assign(message.data(), message.size());
+        }
+        if (logger) {
+            logger->log(LogLevel::ERROR, config.device_port, message);
         }
     }
 
-    std::string getCurrentTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        return ss.str();
+    TestResult makeResult(const std::string& device_id,
+                          std::chrono::system_clock::time_point when = std::chrono::system_clock::now()) {
+        char stamp[32];
+        formatTimestamp(when, stamp, sizeof(stamp));
+
+        TestResult result;
+        result.device_id = device_id;
+        result.test_id = "TEST_";
+        result.test_id += stamp;
+        result.timestamp = stamp;
+        result.completed_at = when;
+        result.passed = false;
+        result.measurement_value = 0.0;
+        return result;
+    }
+
+    /**
+     * @brief Record how a test ended without a verdict
+     */
+    static void setOutcome(TestResult& result, OutcomeCode code) {
+        result.passed = false;
+        result.outcome = code;
+        result.notes = outcomeNote(code);
+    }
+
+    /**
+     * @brief Expand an allocation-free outcome into a full TestResult for reporting
+     */
+    TestResult toTestResult(const std::string& device_id, const TestOutcome& outcome) {
+        TestResult result = makeResult(device_id, outcome.timestamp);
+        result.passed = outcome.passed;
+        result.measurement_value = outcome.measurement_value;
+        result.units = outcome.units;
+        result.outcome = outcome.code;
+        result.notes = outcomeNote(outcome.code);
+        if (outcome.code == OutcomeCode::INVALID_RESPONSE) {
+            std::lock_guard<std::mutex> ioLock(ioMutex);
+            result.notes += lastInvalidResponse;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Copy the last decoded reply's channel readings and failed channels
+     */
+    void exportReadings(std::vector<double>* values, std::vector<std::uint32_t>* failed) const {
+        if (values) values->assign(readings.begin(), readings.end());
+        if (!failed) return;
+        failed->clear();
+        for (size_t word = 0; word < failMask.size(); ++word) {
+            std::uint64_t bits = failMask[word];
+            for (std::uint32_t bit = 0; bits != 0; ++bit, bits >>= 1) {
+                if (bits & 1) failed->push_back(static_cast<std::uint32_t>(word * 64 + bit));
+            }
+        }
+    }
+
+    static void resetOutcome(TestOutcome& outcome, std::chrono::system_clock::time_point when) {
+        outcome.code = OutcomeCode::COMPLETED;
+        outcome.passed = false;
+        outcome.unit = UnitCode::NONE;
+        outcome.units[0] = '\0';
+        outcome.measurement_value = 0.0;
+        outcome.channel_count = 0;
+        outcome.failed_channels = 0;
+        outcome.timestamp = when;
+    }
+
+    /**
+     * @brief Format "[#tag:]TEST:device[:param...]" into the reusable command buffer
+     */
+    const std::string& buildTestCommand(TestTicket tag, const std::string& device_id,
+                                        const std::vector<std::string>& test_parameters) {
+        if (!binaryProtocol) {
+            formatTestCommand(commandBuffer, tag, device_id, test_parameters);
+        } else if (!encodeTestCommand(commandBuffer, sequenceFor(tag), device_id, test_parameters)) {
+            commandBuffer.clear();  // Too long for one frame; transmit() refuses it
+        }
+        return commandBuffer;
+    }
+
+    /**
+     * @brief Send a built command in the negotiated protocol
+     */
+    bool transmit(const std::string& command) {
+        if (!binaryProtocol) return hardware->sendCommand(command);
+        return !command.empty() && hardware->sendRaw(command.data(), command.size());
+    }
+
+    /**
+     * @brief 16-bit binary sequence number for a ticket; never 0, which means untagged
+     */
+    static std::uint16_t sequenceFor(TestTicket tag) {
+        return tag == 0 ? 0 : static_cast<std::uint16_t>((tag - 1) % 0xFFFF + 1);
+    }
+
+    bool matchesTag(TestTicket ticket, TestTicket tag) const {
+        return binaryProtocol ? sequenceFor(ticket) == tag : ticket == tag;
+    }
+
+    /**
+     * @brief Check whether the device echoes tags: binary frames always carry one, ASCII needs pipelining firmware
+     */
+    bool echoesTags() const {
+        return binaryProtocol || config.pipeline_depth > 1;
+    }
+
+    /**
+     * @brief Ask the device for the binary protocol; stays on ASCII unless it agrees
+     */
+    void negotiateProtocol() {
+        binaryProtocol = false;
+        hardware->setBinaryFraming(false);
+        if (!config.binary_protocol) return;
+
+        if (hardware->sendCommand(std::string(BINARY_PROTOCOL_REQUEST)) &&
+            hardware->receiveFrame(500) == BINARY_PROTOCOL_ACK) {
+            hardware->setBinaryFraming(true);
+            binaryProtocol = true;
+        }
+        if (logger) {
+            logger->log(LogLevel::INFO, config.device_port,
+                        binaryProtocol ? "Binary protocol enabled" : "Binary protocol not supported by device; using ASCII");
+        }
+    }
+
+    /**
+     * @brief Receive the frame that answers a command
+     *
+     * In binary mode the frame is decoded into replyFrame for decodeResponse(),
+     * and the CHANNELS frames of a multi-channel reply are gathered into
+     * readings until its RESULT frame arrives.
+     */
+    std::string_view receiveReply(int timeout_ms) {
+        if (!binaryProtocol) return hardware->receiveFrame(timeout_ms);
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (true) {
+            auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            std::string_view frame = hardware->receiveFrame(static_cast<int>(std::max<decltype(remaining)>(remaining, 0)));
+            if (frame.empty()) {
+                readingsStaged = false;  // The reply's RESULT never came
+                return frame;
+            }
+
+            replyStatus = decodeBinaryFrame(frame, replyFrame);
+            if (replyStatus != BinaryDecodeStatus::OK || replyFrame.opcode != BinaryOpcode::CHANNELS) {
+                return frame;
+            }
+            if (!readingsStaged || stagedSequence != replyFrame.sequence) {
+                readings.clear();
+                stagedSequence = replyFrame.sequence;
+                readingsStaged = true;
+            }
+            parseBinaryChannels(replyFrame, readings);
+        }
+    }
+
+    /**
+     * @brief Decode a reply from receiveReply() in the negotiated protocol
+     *
+     * Completed replies are then judged against the host-side limits, if any.
+     *
+     * @param tag Set to the frame's sequence tag, 0 if untagged
+     * @return true if outcome holds a result; otherwise outcome.code says why not
+     */
+    bool decodeResponse(std::string_view frame, TestOutcome& outcome, TestTicket& tag) {
+        failMask.clear();
+        if (!binaryProtocol) {
+            tag = takeSequenceTag(frame);
+            if (parseResultFrame(frame, outcome, &readings)) return judge(outcome);
+            readings.clear();
+            outcome.code = OutcomeCode::INVALID_RESPONSE;
+            lastInvalidResponse.assign(frame.data(), frame.size());
+            return false;
+        }
+
+        bool staged = readingsStaged;
+        readingsStaged = false;
+        if (replyStatus != BinaryDecodeStatus::OK) {
+            tag = 0;
+            readings.clear();
+            outcome.code = OutcomeCode::CORRUPT_RESPONSE;
+            return false;
+        }
+        tag = replyFrame.sequence;
+        if (parseBinaryResult(replyFrame, outcome)) {
+            if (!staged || stagedSequence != replyFrame.sequence) {
+                readings.assign(1, outcome.measurement_value);
+            }
+            outcome.channel_count = static_cast<std::uint32_t>(readings.size());
+            return judge(outcome);
+        }
+        readings.clear();
+        outcome.code = OutcomeCode::INVALID_RESPONSE;
+        char description[32];
+        std::snprintf(description, sizeof(description), "binary opcode 0x%02X",
+                      static_cast<unsigned>(replyFrame.opcode));
+        lastInvalidResponse = description;
+        return false;
+    }
+
+    /**
+     * @brief Replace the device's verdict with the host's when limits are configured
+     * @return true
+     */
+    bool judge(TestOutcome& outcome) {
+        if (limits.empty()) return true;
+        size_t failed = checkChannelLimits(limits, readings.data(), readings.size(), failMask);
+        outcome.failed_channels = static_cast<std::uint32_t>(failed);
+        outcome.passed = failed == 0;
+        return true;
+    }
+
+    /**
+     * @brief Strip a leading "#<seq>:" tag from a response frame
+     * @return Sequence tag, or 0 if the frame is untagged
+     */
+    static TestTicket takeSequenceTag(std::string_view& frame) {
+        if (frame.empty() || frame[0] != '#') return 0;
+
+        TestTicket tag = 0;
+        size_t pos = 1;
+        while (pos < frame.size() && frame[pos] >= '0' && frame[pos] <= '9') {
+            tag = tag * 10 + static_cast<TestTicket>(frame[pos] - '0');
+            ++pos;
+        }
+        if (pos == 1 || pos >= frame.size() || frame[pos] != ':') return 0;
+
+        frame.remove_prefix(pos + 1);
+        return tag;
+    }
+
+    /**
+     * @brief Copy a decoded response into a result
+     */
+    void applyOutcome(const TestOutcome& outcome, bool decoded, TestResult& result) {
+        if (decoded) {
+            result.measurement_value = outcome.measurement_value;
+            result.units = outcome.units;
+            result.passed = outcome.passed;
+            result.outcome = OutcomeCode::COMPLETED;
+            result.notes = outcomeNote(OutcomeCode::COMPLETED);
+            exportReadings(&result.measurements, &result.failed_channels);
+        } else {
+            setOutcome(result, outcome.code);
+            if (outcome.code == OutcomeCode::INVALID_RESPONSE) {
+                result.notes += lastInvalidResponse;
+            }
+        }
+    }
+
+    void parseResponse(std::string_view response, TestResult& result) {
+        TestOutcome outcome;
+        TestTicket tag;
+        resetOutcome(outcome, result.completed_at);
+        bool decoded = decodeResponse(response, outcome, tag);
+        applyOutcome(outcome, decoded, result);
+    }
+
+    /**
+     * @brief Receive one pipelined response and file it under its ticket
+     * @return false if nothing arrived before the timeout
+     */
+    bool receivePipelined(int timeout_ms, const TestResult* base = nullptr) {
+        std::string_view frame = receiveReply(timeout_ms);
+        if (frame.empty()) return false;
+
+        TestOutcome outcome;
+        TestTicket tag;
+        resetOutcome(outcome, std::chrono::system_clock::now());
+        bool decoded = decodeResponse(frame, outcome, tag);
+
+        // Tagged responses match their request; untagged (and corrupted) ones answer the oldest
+        auto it = pendingTests.begin();
+        if (tag != 0) {
+            it = std::find_if(pendingTests.begin(), pendingTests.end(),
+                              [this, tag](const PendingTest& p) { return matchesTag(p.ticket, tag); });
+            if (it == pendingTests.end()) return true;  // Stale or unknown tag
+        }
+
+        TestResult result = resultFor(it->device_id, base);
+        applyOutcome(outcome, decoded, result);
+        completedTests.emplace_back(it->ticket, std::move(result));
+        pendingTests.erase(it);
+        pendingCount.store(pendingTests.size(), std::memory_order_relaxed);
+        return true;
+    }
+
+    void failOldestPending(OutcomeCode code, const TestResult* base = nullptr) {
+        TestResult result = resultFor(pendingTests.front().device_id, base);
+        setOutcome(result, code);
+        completedTests.emplace_back(pendingTests.front().ticket, std::move(result));
+        pendingTests.pop_front();
+        pendingCount.store(pendingTests.size(), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Start a result from a shared batch template, or from scratch
+     */
+    TestResult resultFor(const std::string& device_id, const TestResult* base) {
+        if (!base) return makeResult(device_id);
+        TestResult result = *base;
+        result.device_id = device_id;
+        return result;
+    }
+
+    /**
+     * @brief Format "BATCH:dev1,dev2,...[:param...]" for devices [first, last)
+     */
+    const std::string& buildBatchCommand(const std::vector<std::string>& device_ids, size_t first, size_t last,
+                                         const std::vector<std::string>& test_parameters) {
+        if (binaryProtocol) {
+            if (!encodeBatchCommand(commandBuffer, 0, device_ids, first, last, test_parameters)) {
+                commandBuffer.clear();
+            }
+            return commandBuffer;
+        }
+        commandBuffer.clear();
+        commandBuffer += "BATCH:";
+        for (size_t i = first; i < last; ++i) {
+            if (i != first) commandBuffer += ',';
+            commandBuffer += device_ids[i];
+        }
+        for (const auto& param : test_parameters) {
+            commandBuffer += ':';
+            commandBuffer += param;
+        }
+        return commandBuffer;
+    }
+
+    /**
+     * @brief Run one test over the link; body of runTestInto()
+     */
+    bool executeTest(const std::string& device_id, const std::vector<std::string>& test_parameters,
+                     TestOutcome& outcome, std::vector<double>* values = nullptr,
+                     std::vector<std::uint32_t>* failed = nullptr) {
+        resetOutcome(outcome, std::chrono::system_clock::now());
+        if (values) values->clear();
+        if (failed) failed->clear();
+
+        if (status != EquipmentStatus::RUNNING) {
+            outcome.code = OutcomeCode::NOT_RUNNING;
+            return false;
+        }
+        if (stream.active.load(std::memory_order_acquire)) {
+            outcome.code = OutcomeCode::STREAMING;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> ioLock(ioMutex);
+        if (!hardware || !hardware->isConnected()) {
+            outcome.code = OutcomeCode::NOT_CONNECTED;
+            return false;
+        }
+
+        if (!pendingTests.empty()) {
+            outcome.code = OutcomeCode::PIPELINE_BUSY;
+            return false;
+        }
+
+        if (replyOverdue) {
+            discardStaleInput();
+        }
+        using Clock = std::chrono::steady_clock;
+        auto started = Clock::now();
+        bool tagged = echoesTags();
+        TestTicket tag = tagged ? nextTicket++ : 0;
+        const std::string& command = buildTestCommand(tag, device_id, test_parameters);
+        auto built = Clock::now();
+        auto attempted = built;
+
+        // Each retry gets a fresh tag where the device echoes them; otherwise it resends the same command
+        TimeoutKey key{deviceTypeOf(device_id), test_parameters.empty() ? std::string_view("TEST")
+                                                                         : std::string_view(test_parameters[0])};
+        Clock::time_point sent, received;
+        bool completed = attemptTest(command, tag, key, outcome, sent, received);
+        for (int retry = 1; !completed && retry <= retryPolicy.max_retries && !command.empty() &&
+                            isRetryable(retryPolicy, outcome.code); ++retry) {
+            health.retries.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::sleep_for(retryDelay(retryPolicy, retry, retryRandom));
+            discardStaleInput();
+            resetOutcome(outcome, outcome.timestamp);
+            if (tagged) {
+                tag = nextTicket++;
+                buildTestCommand(tag, device_id, test_parameters);
+            }
+            attempted = Clock::now();
+            completed = attemptTest(command, tag, key, outcome, sent, received);
+            if (completed) health.recovered.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (!completed) {
+            return false;
+        }
+        auto parsed = Clock::now();
+        exportReadings(values, failed);
+
+        const auto& frame = hardware->lastFrameTiming();
+        stageLatency(LatencyStage::BUILD).record(started, built);
+        stageLatency(LatencyStage::SEND).record(attempted, sent);
+        stageLatency(LatencyStage::FIRST_BYTE).record(sent, frame.first_byte);
+        stageLatency(LatencyStage::TERMINATOR).record(std::max(sent, frame.first_byte), frame.terminator);
+        stageLatency(LatencyStage::PARSE).record(received, parsed);
+        stageLatency(LatencyStage::TOTAL).record(started, parsed);
+        return true;
+    }
+
+    /**
+     * @brief Device type and command a response timeout is learned for
+     */
+    struct TimeoutKey {
+        std::string_view device_type;
+        std::string_view command;
+    };
+
+    /**
+     * @brief Send an encoded test command once and decode its reply
+     * @param tag Tag the command was built with, 0 if untagged; replies tagged otherwise are dropped
+     * @param key Selects the learned response timeout
+     * @param sent Set to when the command was written
+     * @param received Set to when the reply was complete
+     */
+    bool attemptTest(const std::string& command, TestTicket tag, const TimeoutKey& key, TestOutcome& outcome,
+                     std::chrono::steady_clock::time_point& sent, std::chrono::steady_clock::time_point& received) {
+        using Clock = std::chrono::steady_clock;
+        if (!transmit(command)) {
+            outcome.code = OutcomeCode::SEND_FAILED;
+            return false;
+        }
+        sent = Clock::now();
+
+        // Receive response; the frame is a view into the interface's receive buffer
+        int timeout_ms = timeouts.timeoutMs(key.device_type, key.command);
+        auto deadline = sent + std::chrono::milliseconds(timeout_ms);
+        while (true) {
+            auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now()).count();
+            std::string_view response = receiveReply(static_cast<int>(std::max<decltype(remaining)>(remaining, 0)));
+            if (response.empty()) {
+                timeouts.recordTimeout(key.device_type, key.command);
+                // A tagged reply that turns up later is recognized and dropped, so only untagged ones are waited out
+                if (tag == 0) markOverdue(sent, 2 * timeout_ms);
+                outcome.code = OutcomeCode::NO_RESPONSE;
+                return false;
+            }
+            received = Clock::now();
+
+            TestTicket replyTag;
+            bool decoded = decodeResponse(response, outcome, replyTag);
+            if (tag != 0 && replyTag != 0 && !matchesTag(tag, replyTag)) {
+                // The late reply to an earlier attempt or test
+                resetOutcome(outcome, outcome.timestamp);
+                awaitLateReplies = true;
+                continue;
+            }
+
+            replyOverdue = false;
+            awaitLateReplies = true;
+            timeouts.recordResponse(key.device_type, key.command, received - sent);
+            health.responseNanos.fetch_add(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(received - sent).count()), std::memory_order_relaxed);
+            health.responses.fetch_add(1, std::memory_order_relaxed);
+            return decoded;
+        }
+    }
+
+    /**
+     * @brief Note that a command timed out; its reply is waited out before the next command is sent
+     * @param sent When the command was written
+     * @param patience_ms How long after sending a reply may still arrive
+     */
+    void markOverdue(std::chrono::steady_clock::time_point sent, int patience_ms) {
+        replyOverdue = true;
+        overdueUntil = sent + std::chrono::milliseconds(patience_ms);
+    }
+
+    /**
+     * @brief Drop replies that arrived late for an earlier attempt, so they cannot answer the retry
+     *
+     * An overdue untagged reply that has not arrived yet is waited for until
+     * overdueUntil, twice the timeout it missed, as it would otherwise answer
+     * the next command; tagged replies are told apart instead. A device that
+     * let a reply go unanswered is not waited for again until it answers
+     * something, so an unplugged fixture costs no more than its timeouts.
+     */
+    void discardStaleInput() {
+        if (hardware->discardInput() > 0) {
+            awaitLateReplies = true;
+        } else if (replyOverdue && awaitLateReplies) {
+            auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+                overdueUntil - std::chrono::steady_clock::now()).count();
+            if (wait > 0 && !hardware->receiveFrame(static_cast<int>(wait)).empty()) {
+                hardware->discardInput();
+            } else {
+                awaitLateReplies = false;
+            }
+        }
+        readingsStaged = false;
+        replyOverdue = false;
+    }
+
+    const std::string& fixtureId() const {
+        if (!config.fixture_id.empty()) return config.fixture_id;
+        return config.station_id.empty() ? config.device_port : config.station_id;
+    }
+
+    bool calibrationValid() const {
+        std::lock_guard<std::mutex> lock(calibrationMutex);
+        return calibrated && MechatronicTest::calibrationValid(
+            calibration, std::chrono::seconds(std::max(0, config.calibration_validity_s)));
+    }
+
+    /**
+     * @brief Take the fixture's last calibration from the cache, if configured
+     */
+    void loadCalibration() {
+        std::lock_guard<std::mutex> lock(calibrationMutex);
+        calibrated = false;
+        calibrationCache.reset();
+        if (config.calibration_cache_path.empty()) return;
+
+        calibrationCache = CalibrationCache::forPath(config.calibration_cache_path);
+        calibrated = calibrationCache->find(fixtureId(), calibration);
+    }
+
+    /**
+     * @brief Record a successful calibration and persist it to the cache
+     */
+    void saveCalibration(std::string data) {
+        std::lock_guard<std::mutex> lock(calibrationMutex);
+        calibration.fixture_id = fixtureId();
+        calibration.calibrated_at = std::chrono::system_clock::now();
+        calibration.data = std::move(data);
+        calibrated = true;
+        if (calibrationCache && !calibrationCache->store(calibration)) {
+            // The calibration itself succeeded; it just will not survive a restart
+            setError(calibrationCache->getLastError());
+        }
+    }
+
+    /**
+     * @brief Forget the last calibration after a failed one, also in the cache
+     */
+    void discardCalibration() {
+        std::lock_guard<std::mutex> lock(calibrationMutex);
+        calibrated = false;
+        if (calibrationCache && !calibrationCache->erase(fixtureId())) {
+            setError(calibrationCache->getLastError());
+        }
+    }
+
+    /**
+     * @brief Send CALIBRATE and wait for the acknowledgement; ioMutex must be held
+     * @param data Receives the device's reply
+     */
+    bool requestCalibration(std::string& data) {
+        constexpr std::string_view station = "STATION", calibrate = "CALIBRATE";
+        int ceiling_ms = std::max(1, config.calibration_timeout_seconds) * 1000;
+        int timeout_ms = timeouts.timeoutMs(station, calibrate, ceiling_ms);
+        if (replyOverdue) {
+            discardStaleInput();
+        }
+
+        std::string_view response;
+        auto sent = std::chrono::steady_clock::now();
+        if (!binaryProtocol) {
+            if (!hardware->sendCommand("CALIBRATE")) return false;
+            sent = std::chrono::steady_clock::now();
+            response = hardware->receiveFrame(timeout_ms);
+        } else {
+            std::string& command = commandBuffer;
+            command.clear();
+            appendBinaryFrame(command, BinaryOpcode::CALIBRATE, 0, nullptr, 0);
+            if (!transmit(command)) return false;
+            sent = std::chrono::steady_clock::now();
+            response = hardware->receiveFrame(timeout_ms);
+        }
+        if (response.empty()) {
+            timeouts.recordTimeout(station, calibrate, ceiling_ms);
+            markOverdue(sent, 2 * timeout_ms);
+            return false;
+        }
+        awaitLateReplies = true;
+        timeouts.recordResponse(station, calibrate, std::chrono::steady_clock::now() - sent);
+
+        if (!binaryProtocol) {
+            data.assign(response.data(), response.size());
+            return response.find("CAL_OK") != std::string_view::npos;
+        }
+        BinaryFrame reply;
+        if (decodeBinaryFrame(response, reply) != BinaryDecodeStatus::OK ||
+            reply.opcode != BinaryOpcode::CALIBRATED) {
+            return false;
+        }
+        static const char hex[] = "0123456789ABCDEF";
+        data = "CALIBRATED:";
+        for (size_t i = 0; i < reply.length; ++i) {
+            data += hex[reply.payload[i] >> 4];
+            data += hex[reply.payload[i] & 0xF];
+        }
+        return true;
+    }
+
+    bool startStream(const std::string& device_id, const std::vector<std::string>& stream_parameters,
+                     const StreamOptions& options) {
+        std::lock_guard<std::mutex> control(stream.control);
+        if (status != EquipmentStatus::RUNNING) {
+            setError("Equipment not in running state");
+            return false;
+        }
+        if (stream.reader.joinable()) {
+            if (stream.active) {
+                setError("Already streaming");
+                return false;
+            }
+            stream.reader.join();  // Ended by itself, e.g. the link was lost
+        }
+        if (binaryProtocol) {
+            setError("Streaming needs the ASCII protocol");
+            return false;
+        }
+
+        // Every block the stream will use is allocated here
+        size_t blockSamples = std::max<size_t>(1, options.block_samples);
+        stream.ring = std::make_unique<SpscRing<SampleBlock>>(
+            std::max<size_t>(1, options.ring_blocks), [blockSamples](SampleBlock& block) {
+                block.samples.reserve(blockSamples);
+            });
+        stream.overflow.samples.reserve(blockSamples);
+        for (auto* counter : {&stream.blocks, &stream.samples, &stream.droppedBlocks, &stream.droppedSamples,
+                              &stream.missedFrames, &stream.malformedFrames}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+        stream.deviceEnded = false;
+        stream.linkLost = false;
+        stream.stopRequested = false;
+        stream.active = true;
+
+        std::string command = "STREAM:" + device_id;
+        for (const auto& param : stream_parameters) {
+            command += ':';
+            command += param;
+        }
+        std::promise<std::string> started;
+        std::future<std::string> error = started.get_future();
+        stream.reader = std::thread([this, command, options, blockSamples, started = std::move(started)]() mutable {
+            streamLoop(command, options, blockSamples, started);
+        });
+
+        // The reader answers within the response timeout ceiling
+        std::string reason = error.get();
+        if (!reason.empty()) {
+            stream.reader.join();
+            setError(reason);
+            return false;
+        }
+        return true;
+    }
+
+    StreamStats stopStream() {
+        std::lock_guard<std::mutex> control(stream.control);
+        if (stream.reader.joinable()) {
+            stream.stopRequested = true;
+            stream.reader.join();
+        }
+        return streamStats();
+    }
+
+    StreamStats streamStats() const {
+        StreamStats stats;
+        stats.blocks = stream.blocks.load(std::memory_order_relaxed);
+        stats.samples = stream.samples.load(std::memory_order_relaxed);
+        stats.dropped_blocks = stream.droppedBlocks.load(std::memory_order_relaxed);
+        stats.dropped_samples = stream.droppedSamples.load(std::memory_order_relaxed);
+        stats.missed_frames = stream.missedFrames.load(std::memory_order_relaxed);
+        stats.malformed_frames = stream.malformedFrames.load(std::memory_order_relaxed);
+        stats.device_ended = stream.deviceEnded;
+        stats.link_lost = stream.linkLost;
+        return stats;
+    }
+
+    size_t readStream(const std::function<void(const SampleBlock&)>& handler, int timeout_ms) {
+        if (!stream.ring) return 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (true) {
+            // Read before draining: blocks are published before the reader clears active
+            bool active = stream.active.load(std::memory_order_acquire);
+            size_t handled = 0;
+            while (SampleBlock* block = stream.ring->front()) {
+                handler(*block);
+                stream.ring->release();
+                ++handled;
+            }
+            if (handled != 0 || !active || std::chrono::steady_clock::now() >= deadline) {
+                return handled;
+            }
+            std::unique_lock<std::mutex> lock(stream.readyMutex);
+            stream.ready.wait_until(lock, deadline, [this]() {
+                return stream.ring->size() != 0 || !stream.active.load(std::memory_order_acquire);
+            });
+        }
+    }
+
+    /**
+     * @brief Reader thread: own the link, split DATA frames into blocks until stopped
+     */
+    void streamLoop(const std::string& command, const StreamOptions& options, size_t blockSamples,
+                    std::promise<std::string>& started) {
+        std::lock_guard<std::mutex> ioLock(ioMutex);
+        auto refuse = [&](std::string reason) {
+            stream.active.store(false, std::memory_order_release);
+            started.set_value(std::move(reason));
+        };
+        if (!hardware || !hardware->isConnected()) {
+            refuse("Hardware not connected");
+            return;
+        }
+        if (!pendingTests.empty()) {
+            refuse(outcomeNote(OutcomeCode::PIPELINE_BUSY));
+            return;
+        }
+        if (replyOverdue) {
+            discardStaleInput();
+        }
+
+        int ceiling_ms = std::max(1, config.response_timeout_ceiling_ms);
+        if (!hardware->sendCommand(command)) {
+            refuse("Failed to send stream command");
+            return;
+        }
+        auto sent = std::chrono::steady_clock::now();
+        std::string_view reply = hardware->receiveFrame(ceiling_ms);
+        if (!reply.empty()) {
+            awaitLateReplies = true;
+        }
+        if (reply != "STREAM:OK") {
+            if (reply.empty()) markOverdue(sent, 2 * ceiling_ms);
+            refuse(reply.empty() ? std::string("No response to stream command")
+                                 : "Device refused stream: " + std::string(reply));
+            return;
+        }
+        started.set_value(std::string());
+
+        using Clock = std::chrono::steady_clock;
+        const auto maxAge = std::chrono::milliseconds(std::max(1, options.max_block_age_ms));
+        SampleBlock* block = nullptr;
+        Clock::time_point openedAt;
+        std::uint64_t nextBlock = 0;
+        std::uint64_t position = 0;
+        std::uint64_t expectedFrame = 0;
+
+        auto handOver = [&](Clock::time_point now) {
+            block->received = now;
+            size_t count = block->samples.size();
+            if (block == &stream.overflow) {
+                stream.droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+                stream.droppedSamples.fetch_add(count, std::memory_order_relaxed);
+            } else {
+                stream.ring->publish();
+                stream.blocks.fetch_add(1, std::memory_order_relaxed);
+                stream.samples.fetch_add(count, std::memory_order_relaxed);
+                { std::lock_guard<std::mutex> lock(stream.readyMutex); }
+                stream.ready.notify_one();
+            }
+            block = nullptr;
+        };
+
+        bool stopSent = false;
+        Clock::time_point stopDeadline;
+        while (true) {
+            if (!stopSent && stream.stopRequested.load(std::memory_order_acquire)) {
+                stopSent = true;
+                stopDeadline = Clock::now() + std::chrono::milliseconds(ceiling_ms);
+                if (!hardware->sendCommand("STREAM:STOP")) {
+                    stream.linkLost = true;
+                    break;
+                }
+            }
+
+            std::string_view frame = hardware->receiveFrame(10);  // Bounds the reaction to stopStream()
+            auto now = Clock::now();
+            if (frame.empty()) {
+                if (block && now - openedAt >= maxAge) handOver(now);
+                if (!hardware->isConnected()) {
+                    stream.linkLost = true;
+                    break;
+                }
+                if (stopSent && now >= stopDeadline) break;
+                continue;
+            }
+            if (frame.rfind("STREAM:END", 0) == 0) {
+                stream.deviceEnded = true;
+                break;
+            }
+
+            std::uint64_t frameSequence = 0;
+            if (!parseSampleFrame(frame, frameSequence, stream.frameSamples)) {
+                stream.malformedFrames.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (frameSequence > expectedFrame) {
+                stream.missedFrames.fetch_add(frameSequence - expectedFrame, std::memory_order_relaxed);
+            }
+            expectedFrame = frameSequence + 1;
+
+            for (double sample : stream.frameSamples) {
+                if (!block) {
+                    // A full ring means the consumer is behind: fill the spare block and drop it
+                    block = stream.ring->claim();
+                    if (!block) block = &stream.overflow;
+                    block->sequence = nextBlock++;
+                    block->first_sample = position;
+                    block->samples.clear();
+                    openedAt = now;
+                }
+                block->samples.push_back(sample);
+                ++position;
+                if (block->samples.size() >= blockSamples) handOver(now);
+            }
+            if (block && now - openedAt >= maxAge) handOver(now);
+        }
+        if (block) handOver(Clock::now());
+
+        readingsStaged = false;
+        {
+            std::lock_guard<std::mutex> lock(stream.readyMutex);
+            stream.active.store(false, std::memory_order_release);
+        }
+        stream.ready.notify_all();
+    }
+
+    /**
+     * @brief Feed a completed measurement to the SPC monitor, keyed like the response timeouts
+     */
+    void recordSpc(const std::string& device_id, const std::vector<std::string>& test_parameters, double value) {
+        spc.record(deviceTypeOf(device_id),
+                   test_parameters.empty() ? std::string_view("TEST") : std::string_view(test_parameters[0]), value);
+    }
+
+    void reportSpcAlarm(const SpcAlarm& alarm) {
+        if (logger) {
+            char message[160];
+            std::snprintf(message, sizeof(message), "SPC alarm %s/%s: %s (value %g, z %.2f, sample %llu)",
+                          alarm.device_type.c_str(), alarm.test.c_str(), spcRuleName(alarm.rule), alarm.value,
+                          alarm.z, static_cast<unsigned long long>(alarm.sample));
+            logger->log(LogLevel::WARNING, config.device_port, message);
+        }
+        SpcAlarmCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(spcCallbackMutex);
+            callback = spcCallback;
+        }
+        if (callback) callback(alarm);
+    }
+
+    /**
+     * @brief Run one test and count, journal and log its outcome
+     */
+    bool runAndRecord(const std::string& device_id, const std::vector<std::string>& test_parameters,
+                      TestOutcome& outcome, std::vector<double>* values, std::vector<std::uint32_t>* failed) {
+        bool completed = executeTest(device_id, test_parameters, outcome, values, failed);
+        countOutcome(outcome.code, outcome.passed);
+        if (completed) {
+            recordSpc(device_id, test_parameters, outcome.measurement_value);
+        }
+        if (journal && !isRejection(outcome.code)) {
+            journal->append(device_id, outcome);
+        }
+        if (logger) {
+            logger->logResult(config.device_port, device_id, outcome);
+        }
+        return completed;
+    }
+
+    LatencyHistogram& stageLatency(LatencyStage stage) {
+        return latency[static_cast<size_t>(stage)];
+    }
+
+    /**
+     * @brief Check whether a test was refused before anything reached the device
+     */
+    static bool isRejection(OutcomeCode code) {
+        return code == OutcomeCode::NOT_RUNNING || code == OutcomeCode::PIPELINE_BUSY ||
+               code == OutcomeCode::STREAMING;
+    }
+
+    void countOutcome(OutcomeCode code, bool passed) {
+        if (code == OutcomeCode::NOT_RUNNING) return;
+        health.tests.fetch_add(1, std::memory_order_relaxed);
+        if (code != OutcomeCode::COMPLETED) {
+            health.errors.fetch_add(1, std::memory_order_relaxed);
+            if (code == OutcomeCode::NO_RESPONSE) {
+                health.timeouts.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else if (passed) {
+            health.passed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            health.failed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Count a result and append it to the journal and log, where enabled
+     *
+     * Rejected tests are logged but not journaled.
+     */
+    void recordResult(const TestResult& result) {
+        countOutcome(result.outcome, result.passed);
+        if (journal && !isRejection(result.outcome)) journal->append(result);
+        if (logger) logger->logResult(config.device_port, result);
+    }
+
+    /**
+     * @brief Test devices [first, last) with one BATCH command, one RESULT line back per device
+     */
+    void runBatchCommand(const std::vector<std::string>& device_ids, size_t first, size_t last,
+                         const std::vector<std::string>& test_parameters, const TestResult& base,
+                         std::vector<TestResult>& results) {
+        bool sent = transmit(buildBatchCommand(device_ids, first, last, test_parameters));
+        bool responding = sent;
+
+        for (size_t i = first; i < last; ++i) {
+            results.push_back(base);
+            TestResult& result = results.back();
+            result.device_id = device_ids[i];
+
+            if (!sent) {
+                setOutcome(result, OutcomeCode::SEND_FAILED);
+                continue;
+            }
+            std::string_view response = responding ? receiveReply(config.response_timeout_ceiling_ms) : std::string_view();
+            if (response.empty()) {
+                responding = false;
+                setOutcome(result, OutcomeCode::NO_RESPONSE);
+                continue;
+            }
+            parseResponse(response, result);
+        }
+    }
+
+    /**
+     * @brief Test devices one command each, keeping up to window commands in flight
+     */
+    void runBatchPipelined(const std::vector<std::string>& device_ids,
+                           const std::vector<std::string>& test_parameters, size_t window,
+                           const TestResult& base, std::vector<TestResult>& results) {
+        TestTicket firstTicket = nextTicket;
+        size_t next = 0;
+
+        while (next < device_ids.size() || !pendingTests.empty()) {
+            while (next < device_ids.size() && pendingTests.size() < window) {
+                TestTicket ticket = nextTicket++;
+                TestTicket tag = window > 1 ? ticket : 0;
+                if (transmit(buildTestCommand(tag, device_ids[next], test_parameters))) {
+                    pendingTests.push_back({ticket, device_ids[next]});
+                    pendingCount.store(pendingTests.size(), std::memory_order_relaxed);
+                } else {
+                    TestResult result = resultFor(device_ids[next], &base);
+                    setOutcome(result, OutcomeCode::SEND_FAILED);
+                    completedTests.emplace_back(ticket, std::move(result));
+                }
+                ++next;
+            }
+            if (!pendingTests.empty() && !receivePipelined(config.response_timeout_ceiling_ms, &base)) {
+                failOldestPending(OutcomeCode::NO_RESPONSE, &base);
+            }
+        }
+
+        // Hand over this batch's results; earlier uncollected submitTest() results stay
+        auto batchBegin = std::stable_partition(completedTests.begin(), completedTests.end(),
+            [firstTicket](const auto& entry) { return entry.first < firstTicket; });
+        std::sort(batchBegin, completedTests.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (auto it = batchBegin; it != completedTests.end(); ++it) {
+            results.push_back(std::move(it->second));
+        }
+        completedTests.erase(batchBegin, completedTests.end());
     }
 };
 
 // EquipmentController implementation
 EquipmentController::EquipmentController() : pImpl(std::make_unique<Impl>()) {}
 
-EquipmentController::~EquipmentController() = default;
+EquipmentController::~EquipmentController() {
+    // Join the worker and the dispatcher while the controller they call into is still intact
+    pImpl->stopWorker();
+    pImpl->statusDispatcher.stop();
+}
 
 bool EquipmentController::initialize(const EquipmentConfig& config) {
     pImpl->config = config;
-    pImpl->hardware = createHardwareInterface("serial");
+    pImpl->limits = channelLimitsFrom(config);
+    pImpl->retryPolicy = retryPolicyFrom(config);
+    pImpl->timeouts.reset(timeoutOptionsFrom(config));
+    pImpl->spc.reset(spcOptionsFrom(config));
+    pImpl->replyOverdue = false;
+    pImpl->awaitLateReplies = false;
+    pImpl->loadCalibration();
+    pImpl->health.initializedAt = std::chrono::steady_clock::now().time_since_epoch().count();
+    pImpl->hardware = createHardwareInterface(config.interface_type);
+
+    pImpl->logger.reset();
+    if (config.enable_logging && !config.log_file_path.empty()) {
+        pImpl->logger = AsyncLogger::forPath(config.log_file_path);
+        if (!pImpl->logger->isOpen()) {
+            pImpl->logger.reset();
+            pImpl->setError("Failed to open log file " + config.log_file_path);
+        }
+    }
+
+    pImpl->journal.reset();
+    if (config.enable_logging && !config.journal_file_path.empty()) {
+        pImpl->journal = std::make_unique<ResultJournal>();
+        const std::string& station = config.station_id.empty() ? config.device_port : config.station_id;
+        if (!pImpl->journal->open(config.journal_file_path, station)) {
+            // Testing can proceed without a journal
+            pImpl->setError(pImpl->journal->getLastError());
+            pImpl->journal.reset();
+        }
+    }
     
     if (!pImpl->hardware) {
-        pImpl->lastError = "Failed to create hardware interface";
+        pImpl->setError("Failed to create hardware interface");
         pImpl->setStatus(EquipmentStatus::ERROR, "Failed to create hardware interface");
         return false;
     }
 
+    pImpl->hardware->configure(config);
     if (!pImpl->hardware->connect(config.device_port, config.baud_rate)) {
-        pImpl->lastError = "Failed to connect to device on port " + config.device_port;
+        pImpl->setError("Failed to connect to device on port " + config.device_port);
         pImpl->setStatus(EquipmentStatus::IDLE, "Equipment initialized (simulation mode)");
         return false;  // Return false but still set status for callback
     }
 
+    pImpl->negotiateProtocol();
     pImpl->setStatus(EquipmentStatus::IDLE, "Equipment initialized successfully");
     return true;
 }
 
 bool EquipmentController::start() {
-    if (pImpl->status != EquipmentStatus::IDLE && pImpl->status != EquipmentStatus::PAUSED) {
-        pImpl->lastError = "Equipment must be in IDLE or PAUSED state to start";
+    EquipmentStatus current = pImpl->status;
+    if (current != EquipmentStatus::IDLE && current != EquipmentStatus::PAUSED) {
+        pImpl->setError("Equipment must be in IDLE or PAUSED state to start");
         return false;
     }
 
@@ -279,13 +1562,14 @@ bool EquipmentController::stop() {
         return true;
     }
 
+    pImpl->stopStream();
     pImpl->setStatus(EquipmentStatus::IDLE, "Equipment stopped");
     return true;
 }
 
 bool EquipmentController::pause() {
     if (pImpl->status != EquipmentStatus::RUNNING) {
-        pImpl->lastError = "Equipment must be running to pause";
+        pImpl->setError("Equipment must be running to pause");
         return false;
     }
 
@@ -295,7 +1579,7 @@ bool EquipmentController::pause() {
 
 bool EquipmentController::resume() {
     if (pImpl->status != EquipmentStatus::PAUSED) {
-        pImpl->lastError = "Equipment must be paused to resume";
+        pImpl->setError("Equipment must be paused to resume");
         return false;
     }
 
@@ -305,127 +1589,556 @@ bool EquipmentController::resume() {
 
 TestResult EquipmentController::runTest(const std::string& device_id, 
                                        const std::vector<std::string>& test_parameters) {
-    TestResult result;
-    result.device_id = device_id;
-    result.test_id = "TEST_" + pImpl->getCurrentTimestamp();
-    result.timestamp = pImpl->getCurrentTimestamp();
+    TestOutcome outcome;
+    std::vector<double> measurements;
+    std::vector<std::uint32_t> failedChannels;
+    pImpl->runAndRecord(device_id, test_parameters, outcome, &measurements, &failedChannels);
+    TestResult result = pImpl->toTestResult(device_id, outcome);
+    result.measurements = std::move(measurements);
+    result.failed_channels = std::move(failedChannels);
+    return result;
+}
+
+bool EquipmentController::runTestInto(const std::string& device_id,
+                                      const std::vector<std::string>& test_parameters,
+                                      TestOutcome& outcome, std::vector<double>* readings) {
+    return pImpl->runAndRecord(device_id, test_parameters, outcome, readings, nullptr);
+}
+
+void EquipmentController::runTestAsync(const std::string& device_id,
+                                       const std::vector<std::string>& test_parameters,
+                                       TestCallback callback) {
+    pImpl->post([this, device_id, test_parameters, callback = std::move(callback)]() {
+        TestResult result = runTest(device_id, test_parameters);
+        if (callback) {
+            callback(result);
+        }
+    });
+}
+
+std::future<TestResult> EquipmentController::runTestAsync(const std::string& device_id,
+                                                          const std::vector<std::string>& test_parameters) {
+    auto promise = std::make_shared<std::promise<TestResult>>();
+    std::future<TestResult> future = promise->get_future();
+    pImpl->post([this, device_id, test_parameters, promise]() {
+        promise->set_value(runTest(device_id, test_parameters));
+    });
+    return future;
+}
 
+TestTicket EquipmentController::submitTest(const std::string& device_id,
+                                           const std::vector<std::string>& test_parameters) {
     if (pImpl->status != EquipmentStatus::RUNNING) {
-        result.passed = false;
-        result.notes = "Equipment not in running state";
-        return result;
+        pImpl->setError("Equipment not in running state");
+        return 0;
+    }
+    if (pImpl->stream.active.load(std::memory_order_acquire)) {
+        pImpl->setError(outcomeNote(OutcomeCode::STREAMING));
+        return 0;
     }
 
+    std::lock_guard<std::mutex> ioLock(pImpl->ioMutex);
     if (!pImpl->hardware || !pImpl->hardware->isConnected()) {
-        result.passed = false;
-        result.notes = "Hardware not connected";
-        return result;
+        pImpl->setError("Hardware not connected");
+        return 0;
     }
 
-    try {
-        // Send test command
-        std::string command = "TEST:" + device_id;
-        for (const auto& param : test_parameters) {
-            command += ":" + param;
+    // Wait for the oldest command to complete before exceeding the window
+    size_t window = static_cast<size_t>(std::max(1, pImpl->config.pipeline_depth));
+    while (pImpl->pendingTests.size() >= window) {
+        if (!pImpl->receivePipelined(pImpl->config.response_timeout_ceiling_ms)) {
+            pImpl->failOldestPending(OutcomeCode::NO_RESPONSE);
         }
+    }
 
-        if (!pImpl->hardware->sendCommand(command)) {
-            result.passed = false;
-            result.notes = "Failed to send test command";
-            return result;
-        }
+    TestTicket ticket = pImpl->nextTicket++;
+    TestTicket tag = window > 1 ? ticket : 0;
+    if (!pImpl->transmit(pImpl->buildTestCommand(tag, device_id, test_parameters))) {
+        pImpl->setError("Failed to send test command");
+        return 0;
+    }
 
-        // Receive response
-        std::string response = pImpl->hardware->receiveResponse(5000);
-        if (response.empty()) {
-            result.passed = false;
-            result.notes = "No response from device";
-            return result;
-        }
+    pImpl->pendingTests.push_back({ticket, device_id});
+    pImpl->pendingCount.store(pImpl->pendingTests.size(), std::memory_order_relaxed);
+    return ticket;
+}
 
-        // Parse response (simplified format: "RESULT:value:units:status")
-        std::istringstream iss(response);
-        std::string token;
-        std::vector<std::string> tokens;
-        
-        while (std::getline(iss, token, ':')) {
-            tokens.push_back(token);
+std::vector<TestResult> EquipmentController::collectResults(int timeout_ms) {
+    if (pImpl->stream.active.load(std::memory_order_acquire)) {
+        return {};  // Nothing can be outstanding; earlier results wait for the stream to end
+    }
+    std::lock_guard<std::mutex> ioLock(pImpl->ioMutex);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!pImpl->pendingTests.empty() && pImpl->hardware) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0 || !pImpl->receivePipelined(static_cast<int>(remaining))) break;
+    }
+    while (!pImpl->pendingTests.empty()) {
+        pImpl->failOldestPending(OutcomeCode::NO_RESPONSE);
+    }
+
+    // Report in submission order regardless of completion order
+    auto& completed = pImpl->completedTests;
+    std::sort(completed.begin(), completed.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<TestResult> results;
+    results.reserve(completed.size());
+    for (auto& entry : completed) {
+        pImpl->recordResult(entry.second);
+        results.push_back(std::move(entry.second));
+    }
+    completed.clear();
+    return results;
+}
+
+std::vector<TestResult> EquipmentController::runTestBatch(const std::vector<std::string>& device_ids,
+                                                         const std::vector<std::string>& test_parameters) {
+    std::vector<TestResult> results;
+    results.reserve(device_ids.size());
+
+    // One state check and one pair of timestamps for the whole batch
+    TestResult base = pImpl->makeResult("");
+    auto failAll = [&](OutcomeCode code) {
+        Impl::setOutcome(base, code);
+        for (const auto& device_id : device_ids) {
+            results.push_back(base);
+            results.back().device_id = device_id;
+            pImpl->recordResult(results.back());
         }
+        return results;
+    };
 
-        if (tokens.size() >= 4 && tokens[0] == "RESULT") {
-            result.measurement_value = std::stod(tokens[1]);
-            result.units = tokens[2];
-            result.passed = (tokens[3] == "PASS");
-            result.notes = "Test completed successfully";
-        } else {
-            result.passed = false;
-            result.notes = "Invalid response format: " + response;
+    if (pImpl->status != EquipmentStatus::RUNNING) {
+        return failAll(OutcomeCode::NOT_RUNNING);
+    }
+    if (pImpl->stream.active.load(std::memory_order_acquire)) {
+        return failAll(OutcomeCode::STREAMING);
+    }
+
+    std::lock_guard<std::mutex> ioLock(pImpl->ioMutex);
+    if (!pImpl->hardware || !pImpl->hardware->isConnected()) {
+        return failAll(OutcomeCode::NOT_CONNECTED);
+    }
+    if (!pImpl->pendingTests.empty()) {
+        return failAll(OutcomeCode::PIPELINE_BUSY);
+    }
+
+    if (pImpl->config.batch_commands) {
+        size_t chunk = static_cast<size_t>(std::max(1, pImpl->config.max_batch_size));
+        for (size_t first = 0; first < device_ids.size(); first += chunk) {
+            size_t last = std::min(device_ids.size(), first + chunk);
+            pImpl->runBatchCommand(device_ids, first, last, test_parameters, base, results);
         }
+    } else {
+        size_t window = static_cast<size_t>(std::max(1, pImpl->config.pipeline_depth));
+        pImpl->runBatchPipelined(device_ids, test_parameters, window, base, results);
+    }
 
-    } catch (const std::exception& e) {
-        result.passed = false;
-        result.notes = "Test execution error: " + std::string(e.what());
+    for (const auto& result : results) {
+        pImpl->recordResult(result);
+        if (result.outcome == OutcomeCode::COMPLETED) {
+            pImpl->recordSpc(result.device_id, test_parameters, result.measurement_value);
+        }
     }
+    return results;
+}
 
-    return result;
+bool EquipmentController::startStream(const std::string& device_id, const std::vector<std::string>& stream_parameters,
+                                      const StreamOptions& options) {
+    return pImpl->startStream(device_id, stream_parameters, options);
+}
+
+size_t EquipmentController::readStream(const std::function<void(const SampleBlock&)>& handler, int timeout_ms) {
+    return pImpl->readStream(handler, timeout_ms);
+}
+
+StreamStats EquipmentController::stopStream() {
+    return pImpl->stopStream();
+}
+
+bool EquipmentController::isStreaming() const {
+    return pImpl->stream.active.load(std::memory_order_acquire);
+}
+
+StreamStats EquipmentController::getStreamStats() const {
+    return pImpl->streamStats();
+}
+
+size_t EquipmentController::pendingTests() const {
+    return pImpl->pendingCount.load(std::memory_order_relaxed);
 }
 
 EquipmentStatus EquipmentController::getStatus() const {
-    std::lock_guard<std::mutex> lock(pImpl->statusMutex);
-    return pImpl->status;
+    return pImpl->status.load();
+}
+
+bool EquipmentController::usingBinaryProtocol() const {
+    return pImpl->binaryProtocol;
+}
+
+bool EquipmentController::isConnected() const {
+    return pImpl->hardware && pImpl->hardware->isConnected();
 }
 
 std::string EquipmentController::getLastError() const {
+    std::lock_guard<std::mutex> lock(pImpl->errorMutex);
     return pImpl->lastError;
 }
 
 void EquipmentController::setStatusCallback(StatusCallback callback) {
-    pImpl->statusCallback = callback;
+    if (pImpl->statusCallbackId != 0) {
+        pImpl->statusDispatcher.removeListener(pImpl->statusCallbackId);
+    }
+    pImpl->statusCallbackId = pImpl->statusDispatcher.addListener(std::move(callback));
+}
+
+StatusListenerId EquipmentController::addStatusListener(StatusCallback callback) {
+    return pImpl->statusDispatcher.addListener(std::move(callback));
 }
 
-bool EquipmentController::calibrate() {
-    if (pImpl->status != EquipmentStatus::IDLE) {
-        pImpl->lastError = "Equipment must be idle for calibration";
+bool EquipmentController::removeStatusListener(StatusListenerId id) {
+    return pImpl->statusDispatcher.removeListener(id);
+}
+
+bool EquipmentController::waitForStatusEvents(int timeout_ms) {
+    return pImpl->statusDispatcher.waitDelivered(timeout_ms);
+}
+
+bool EquipmentController::calibrate(bool force) {
+    EquipmentStatus previous = pImpl->status;
+    if (previous != EquipmentStatus::IDLE && previous != EquipmentStatus::RUNNING) {
+        pImpl->setError("Equipment must be idle or running for calibration");
+        return false;
+    }
+    if (pImpl->stream.active.load(std::memory_order_acquire)) {
+        pImpl->setError(outcomeNote(OutcomeCode::STREAMING));
         return false;
     }
 
-    pImpl->setStatus(EquipmentStatus::MAINTENANCE, "Calibration in progress");
-
-    // Simulate calibration process
-    std::this_thread::sleep_for(std::chrono::seconds(2));
+    if (!force && pImpl->calibrationValid()) {
+        if (pImpl->logger) {
+            pImpl->logger->log(LogLevel::INFO, pImpl->config.device_port, "Calibration still valid; skipped");
+        }
+        return true;
+    }
 
-    if (pImpl->hardware && pImpl->hardware->isConnected()) {
-        pImpl->hardware->sendCommand("CALIBRATE");
-        std::string response = pImpl->hardware->receiveResponse(10000);
-        
-        if (response.find("CAL_OK") != std::string::npos) {
-            pImpl->setStatus(EquipmentStatus::IDLE, "Calibration completed successfully");
-            return true;
+    bool calibrated = false;
+    std::string data;
+    {
+        std::lock_guard<std::mutex> ioLock(pImpl->ioMutex);
+        if (!pImpl->pendingTests.empty()) {
+            pImpl->setError("Pipelined tests still outstanding");
+            return false;
+        }
+        pImpl->setStatus(EquipmentStatus::MAINTENANCE, "Calibration in progress");
+        if (pImpl->hardware && pImpl->hardware->isConnected()) {
+            calibrated = pImpl->requestCalibration(data);
         }
     }
 
+    if (calibrated) {
+        pImpl->saveCalibration(std::move(data));
+        pImpl->setStatus(previous, "Calibration completed successfully");
+        return true;
+    }
+
+    pImpl->discardCalibration();
     pImpl->setStatus(EquipmentStatus::ERROR, "Calibration failed");
     return false;
 }
 
+std::future<bool> EquipmentController::calibrateAsync(bool force) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+    pImpl->post([this, force, promise]() {
+        promise->set_value(calibrate(force));
+    });
+    return future;
+}
+
+bool EquipmentController::calibrationValid() const {
+    return pImpl->calibrationValid();
+}
+
+std::chrono::system_clock::time_point EquipmentController::lastCalibration() const {
+    std::lock_guard<std::mutex> lock(pImpl->calibrationMutex);
+    return pImpl->calibrated ? pImpl->calibration.calibrated_at : std::chrono::system_clock::time_point();
+}
+
+LatencyReport EquipmentController::getLatencyReport() const {
+    LatencyReport report;
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        report.stages[i] = pImpl->latency[i].summary();
+    }
+    return report;
+}
+
+void EquipmentController::resetLatencyStats() {
+    for (auto& histogram : pImpl->latency) {
+        histogram.reset();
+    }
+}
+
 std::vector<std::pair<std::string, double>> EquipmentController::getHealthMetrics() const {
+    HealthSnapshot snapshot = getHealthSnapshot();
+
     std::vector<std::pair<std::string, double>> metrics;
-    
-    // Simulate health metrics
-    metrics.push_back({"Temperature", 23.5});
-    metrics.push_back({"Vibration", 0.02});
-    metrics.push_back({"Power_Consumption", 125.3});
-    metrics.push_back({"Uptime_Hours", 1234.5});
-    metrics.push_back({"Error_Rate", 0.001});
+    metrics.reserve(12);
+    metrics.push_back({"Tests_Run", static_cast<double>(snapshot.tests_run)});
+    metrics.push_back({"Tests_Passed", static_cast<double>(snapshot.tests_passed)});
+    metrics.push_back({"Tests_Failed", static_cast<double>(snapshot.tests_failed)});
+    metrics.push_back({"Failure_Rate", snapshot.failure_rate});
+    metrics.push_back({"Error_Rate", snapshot.error_rate});
+    metrics.push_back({"Timeouts", static_cast<double>(snapshot.timeouts)});
+    metrics.push_back({"Retries", static_cast<double>(snapshot.retries)});
+    metrics.push_back({"Recovered_By_Retry", static_cast<double>(snapshot.recovered_by_retry)});
+    metrics.push_back({"Mean_Response_Ms", snapshot.mean_response_ms});
+    metrics.push_back({"Bytes_Sent", static_cast<double>(snapshot.bytes_sent)});
+    metrics.push_back({"Bytes_Received", static_cast<double>(snapshot.bytes_received)});
+    metrics.push_back({"Uptime_Hours", snapshot.uptime_s / 3600.0});
+    for (const auto& timeout : pImpl->timeouts.snapshot()) {
+        std::string key = timeout.device_type + "/" + timeout.command;
+        metrics.push_back({"Response_Timeout_Ms:" + key, timeout.timeout_ms});
+        metrics.push_back({"Smoothed_Response_Ms:" + key, timeout.smoothed_ms});
+    }
+    for (const auto& stats : pImpl->spc.snapshot()) {
+        std::string key = stats.device_type + "/" + stats.test;
+        if (!std::isnan(stats.cpk)) metrics.push_back({"Cpk:" + key, stats.cpk});
+        metrics.push_back({"SPC_Alarms:" + key, static_cast<double>(stats.alarms)});
+    }
 
     return metrics;
 }
 
+std::vector<ResponseTimeoutStats> EquipmentController::getResponseTimeouts() const {
+    return pImpl->timeouts.snapshot();
+}
+
+std::vector<SpcStats> EquipmentController::getSpcStats() const {
+    return pImpl->spc.snapshot();
+}
+
+void EquipmentController::setSpcAlarmCallback(SpcAlarmCallback callback) {
+    std::lock_guard<std::mutex> lock(pImpl->spcCallbackMutex);
+    pImpl->spcCallback = std::move(callback);
+}
+
+HealthSnapshot EquipmentController::getHealthSnapshot() const {
+    const auto& health = pImpl->health;
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    HealthSnapshot snapshot{};
+    snapshot.tests_run = health.tests.load(relaxed);
+    snapshot.tests_passed = health.passed.load(relaxed);
+    snapshot.tests_failed = health.failed.load(relaxed);
+    snapshot.errors = health.errors.load(relaxed);
+    snapshot.timeouts = health.timeouts.load(relaxed);
+    snapshot.retries = health.retries.load(relaxed);
+    snapshot.recovered_by_retry = health.recovered.load(relaxed);
+    if (pImpl->hardware) {
+        snapshot.bytes_sent = pImpl->hardware->bytesSent();
+        snapshot.bytes_received = pImpl->hardware->bytesReceived();
+    }
+    if (snapshot.tests_run > 0) {
+        snapshot.failure_rate = static_cast<double>(snapshot.tests_failed) / snapshot.tests_run;
+        snapshot.error_rate = static_cast<double>(snapshot.errors) / snapshot.tests_run;
+    }
+    std::uint64_t responses = health.responses.load(relaxed);
+    if (responses > 0) {
+        snapshot.mean_response_ms = static_cast<double>(health.responseNanos.load(relaxed)) / responses / 1e6;
+    }
+    auto initializedAt = health.initializedAt.load(relaxed);
+    if (initializedAt != 0) {
+        auto since = std::chrono::steady_clock::now().time_since_epoch().count() - initializedAt;
+        snapshot.uptime_s = std::chrono::duration<double>(std::chrono::steady_clock::duration(since)).count();
+    }
+    return snapshot;
+}
+
+// Allocation-free parsing and formatting helpers
+void formatTestCommand(std::string& command, TestTicket tag, std::string_view device_id,
+                       const std::vector<std::string>& test_parameters) {
+    command.clear();
+    if (tag != 0) {
+        char digits[24];
+        auto end = std::to_chars(digits, digits + sizeof(digits), tag).ptr;
+        command += '#';
+        command.append(digits, static_cast<size_t>(end - digits));
+        command += ':';
+    }
+    command += "TEST:";
+    command += device_id;
+    for (const auto& param : test_parameters) {
+        command += ':';
+        command += param;
+    }
+}
+
+bool parseSampleFrame(std::string_view frame, std::uint64_t& sequence, std::vector<double>& samples) {
+    constexpr std::string_view prefix = "DATA:";
+    if (frame.substr(0, prefix.size()) != prefix) {
+        return false;
+    }
+    const char* next = frame.data() + prefix.size();
+    const char* last = frame.data() + frame.size();
+    auto counter = std::from_chars(next, last, sequence);
+    if (counter.ec != std::errc() || counter.ptr == last || *counter.ptr != ':') {
+        return false;
+    }
+
+    next = counter.ptr + 1;
+    samples.clear();
+    while (true) {
+        double sample = 0.0;
+        auto parsed = std::from_chars(next, last, sample);
+        if (parsed.ec != std::errc() || (parsed.ptr != last && *parsed.ptr != ',')) {
+            return false;
+        }
+        samples.push_back(sample);
+        if (parsed.ptr == last) break;
+        next = parsed.ptr + 1;
+    }
+    return true;
+}
+
+UnitCode unitCodeFromString(std::string_view units) {
+    static constexpr std::pair<std::string_view, UnitCode> table[] = {
+        {"V", UnitCode::VOLT},          {"mV", UnitCode::MILLIVOLT},
+        {"A", UnitCode::AMPERE},        {"mA", UnitCode::MILLIAMPERE},
+        {"Ohm", UnitCode::OHM},         {"kOhm", UnitCode::KILOOHM},
+        {"W", UnitCode::WATT},          {"Hz", UnitCode::HERTZ},
+        {"C", UnitCode::CELSIUS},       {"s", UnitCode::SECOND},
+        {"ms", UnitCode::MILLISECOND},  {"mm", UnitCode::MILLIMETER},
+        {"N", UnitCode::NEWTON},
+    };
+
+    if (units.empty()) return UnitCode::NONE;
+    for (const auto& entry : table) {
+        if (entry.first == units) return entry.second;
+    }
+    return UnitCode::OTHER;
+}
+
+const char* unitCodeToString(UnitCode unit) {
+    switch (unit) {
+        case UnitCode::NONE: return "";
+        case UnitCode::VOLT: return "V";
+        case UnitCode::MILLIVOLT: return "mV";
+        case UnitCode::AMPERE: return "A";
+        case UnitCode::MILLIAMPERE: return "mA";
+        case UnitCode::OHM: return "Ohm";
+        case UnitCode::KILOOHM: return "kOhm";
+        case UnitCode::WATT: return "W";
+        case UnitCode::HERTZ: return "Hz";
+        case UnitCode::CELSIUS: return "C";
+        case UnitCode::SECOND: return "s";
+        case UnitCode::MILLISECOND: return "ms";
+        case UnitCode::MILLIMETER: return "mm";
+        case UnitCode::NEWTON: return "N";
+        case UnitCode::OTHER: return "?";
+    }
+    return "?";
+}
+
+const char* outcomeNote(OutcomeCode code) {
+    switch (code) {
+        case OutcomeCode::COMPLETED: return "Test completed successfully";
+        case OutcomeCode::NOT_RUNNING: return "Equipment not in running state";
+        case OutcomeCode::NOT_CONNECTED: return "Hardware not connected";
+        case OutcomeCode::PIPELINE_BUSY: return "Pipelined tests still outstanding";
+        case OutcomeCode::SEND_FAILED: return "Failed to send test command";
+        case OutcomeCode::NO_RESPONSE: return "No response from device";
+        case OutcomeCode::INVALID_RESPONSE: return "Invalid response format: ";
+        case OutcomeCode::CORRUPT_RESPONSE: return "Corrupted response (CRC mismatch)";
+        case OutcomeCode::STREAMING: return "Device is streaming";
+    }
+    return "";
+}
+
+bool parseResultFrame(std::string_view frame, TestOutcome& outcome, std::vector<double>* readings) {
+    // Format: "RESULT:value[,value...]:units:status"
+    std::string_view tokens[4];
+    size_t tokenCount = 0;
+    size_t pos = 0;
+    while (tokenCount < 4) {
+        size_t colon = frame.find(':', pos);
+        tokens[tokenCount++] = frame.substr(pos, colon == std::string_view::npos ? colon : colon - pos);
+        if (colon == std::string_view::npos) break;
+        pos = colon + 1;
+    }
+    if (tokenCount < 4 || tokens[0] != "RESULT") {
+        return false;
+    }
+
+    double value = 0.0;
+    std::uint32_t channels = 0;
+    const char* next = tokens[1].data();
+    const char* last = next + tokens[1].size();
+    if (readings) readings->clear();
+    while (true) {
+        double reading = 0.0;
+        auto parsed = std::from_chars(next, last, reading);
+        if (parsed.ec != std::errc() || (parsed.ptr != last && *parsed.ptr != ',')) {
+            return false;
+        }
+        if (channels++ == 0) value = reading;
+        if (readings) readings->push_back(reading);
+        if (parsed.ptr == last) break;
+        next = parsed.ptr + 1;
+    }
+
+    size_t unitsLength = std::min(tokens[2].size(), sizeof(outcome.units) - 1);
+    std::memcpy(outcome.units, tokens[2].data(), unitsLength);
+    outcome.units[unitsLength] = '\0';
+
+    outcome.code = OutcomeCode::COMPLETED;
+    outcome.measurement_value = value;
+    outcome.channel_count = channels;
+    outcome.unit = unitCodeFromString(tokens[2]);
+    outcome.passed = (tokens[3] == "PASS");
+    return true;
+}
+
+size_t formatTimestamp(std::chrono::system_clock::time_point when, char* buffer, size_t length) {
+    std::time_t seconds = std::chrono::system_clock::to_time_t(when);
+    std::tm local;
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    size_t written = std::strftime(buffer, length, "%Y-%m-%d %H:%M:%S", &local);
+    if (written == 0 && length > 0) {
+        buffer[0] = '\0';
+    }
+    return written;
+}
+
+std::string formatTimestamp(std::chrono::system_clock::time_point when) {
+    char buffer[32];
+    size_t written = formatTimestamp(when, buffer, sizeof(buffer));
+    return std::string(buffer, written);
+}
+
 // Factory function implementation
 std::unique_ptr<HardwareInterface> createHardwareInterface(const std::string& interface_type) {
     if (interface_type == "serial") {
         return std::make_unique<SerialInterface>();
     }
+    if (interface_type == "tcp" || interface_type == "ethernet") {
+        return std::make_unique<TcpInterface>();
+    }
+#ifdef HAS_LIBUSB
+    if (interface_type == "usb") {
+        return std::make_unique<UsbInterface>();
+    }
+#endif
+    if (interface_type == "sim") {
+        return std::make_unique<SimulatedInterface>();
+    }
     // Add other interface types as needed
     return nullptr;
 }
@@ -0,0 +1,88 @@
+/**
+ * @file latency_histogram.cpp
+ * @brief Implementation of the latency histogram
+ */
+
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace MechatronicTest {
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < 2 * SUB_BUCKETS) {
+        return index;
+    }
+    size_t offset = index - 2 * SUB_BUCKETS;
+    unsigned group = static_cast<unsigned>(offset / SUB_BUCKETS) + 1;
+    std::uint64_t lower = (SUB_BUCKETS + offset % SUB_BUCKETS) << group;
+    return lower + (1ull << group) - 1;
+}
+
+std::uint64_t LatencyHistogram::valueAtPercentile(double percentile) const {
+    // Sum the buckets rather than trusting total, which writers update separately
+    std::uint64_t counts[BUCKET_COUNT];
+    std::uint64_t samples = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        samples += counts[i];
+    }
+    if (samples == 0) {
+        return 0;
+    }
+
+    double clamped = std::min(100.0, std::max(0.0, percentile));
+    auto rank = static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(samples)));
+    rank = std::max<std::uint64_t>(1, rank);
+
+    std::uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), maximum.load(std::memory_order_relaxed));
+        }
+    }
+    return maximum.load(std::memory_order_relaxed);
+}
+
+LatencySummary LatencyHistogram::summary() const {
+    LatencySummary result{};
+    result.count = count();
+    if (result.count == 0) {
+        return result;
+    }
+    result.mean_us = static_cast<double>(sum.load(std::memory_order_relaxed)) / result.count / 1000.0;
+    result.p50_us = valueAtPercentile(50.0) / 1000.0;
+    result.p99_us = valueAtPercentile(99.0) / 1000.0;
+    result.p999_us = valueAtPercentile(99.9) / 1000.0;
+    result.max_us = maximum.load(std::memory_order_relaxed) / 1000.0;
+    return result;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+}
+
+const char* latencyStageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::BUILD: return "build";
+        case LatencyStage::SEND: return "send";
+        case LatencyStage::FIRST_BYTE: return "first_byte";
+        case LatencyStage::TERMINATOR: return "terminator";
+        case LatencyStage::PARSE: return "parse";
+        case LatencyStage::TOTAL: return "total";
+        case LatencyStage::COUNT: break;
+    }
+    return "unknown";
+}
+
+} // namespace MechatronicTest
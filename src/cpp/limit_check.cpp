@@ -0,0 +1,171 @@
+/**
+ * @file limit_check.cpp
+ * @brief Implementation of host-side limit checking
+ */
+
+#include "limit_check.h"
+#include "equipment_controller.h"
+
+#include <algorithm>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LIMIT_CHECK_AVX2 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define LIMIT_CHECK_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace MechatronicTest {
+
+namespace {
+
+using CheckFunction = size_t (*)(const double*, const double*, const double*, size_t, std::uint64_t*);
+
+void clearMask(std::uint64_t* fail_mask, size_t count) {
+    if (fail_mask) {
+        std::fill(fail_mask, fail_mask + (count + 63) / 64, 0);
+    }
+}
+
+/**
+ * @brief Scalar check of readings [first, count); the mask must already be cleared
+ */
+size_t checkTail(const double* readings, const double* lower, const double* upper, size_t first, size_t count,
+                 std::uint64_t* fail_mask) {
+    size_t failures = 0;
+    for (size_t i = first; i < count; ++i) {
+        // Written so that NaN fails, like the ordered SIMD comparisons
+        if (!(readings[i] >= lower[i] && readings[i] <= upper[i])) {
+            ++failures;
+            if (fail_mask) fail_mask[i / 64] |= std::uint64_t{1} << (i % 64);
+        }
+    }
+    return failures;
+}
+
+#ifdef LIMIT_CHECK_AVX2
+
+__attribute__((target("avx2")))
+size_t checkAvx2(const double* readings, const double* lower, const double* upper, size_t count,
+                 std::uint64_t* fail_mask) {
+    clearMask(fail_mask, count);
+    size_t failures = 0;
+    size_t i = 0;
+    // 16 channels per step so each step fills an aligned 16-bit field of the mask
+    for (; i + 16 <= count; i += 16) {
+        unsigned bad = 0;
+        for (size_t lane = 0; lane < 16; lane += 4) {
+            __m256d value = _mm256_loadu_pd(readings + i + lane);
+            __m256d inside = _mm256_and_pd(_mm256_cmp_pd(value, _mm256_loadu_pd(lower + i + lane), _CMP_GE_OQ),
+                                           _mm256_cmp_pd(value, _mm256_loadu_pd(upper + i + lane), _CMP_LE_OQ));
+            bad |= static_cast<unsigned>(~_mm256_movemask_pd(inside) & 0xF) << lane;
+        }
+        if (bad != 0) {
+            failures += static_cast<size_t>(__builtin_popcount(bad));
+            if (fail_mask) fail_mask[i / 64] |= static_cast<std::uint64_t>(bad) << (i % 64);
+        }
+    }
+    return failures + checkTail(readings, lower, upper, i, count, fail_mask);
+}
+
+#endif // LIMIT_CHECK_AVX2
+
+#ifdef LIMIT_CHECK_NEON
+
+size_t checkNeon(const double* readings, const double* lower, const double* upper, size_t count,
+                 std::uint64_t* fail_mask) {
+    clearMask(fail_mask, count);
+    size_t failures = 0;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        float64x2_t value = vld1q_f64(readings + i);
+        uint64x2_t inside = vandq_u64(vcgeq_f64(value, vld1q_f64(lower + i)), vcleq_f64(value, vld1q_f64(upper + i)));
+        unsigned bad = (vgetq_lane_u64(inside, 0) ? 0u : 1u) | (vgetq_lane_u64(inside, 1) ? 0u : 2u);
+        if (bad != 0) {
+            failures += static_cast<size_t>(__builtin_popcount(bad));
+            if (fail_mask) fail_mask[i / 64] |= static_cast<std::uint64_t>(bad) << (i % 64);
+        }
+    }
+    return failures + checkTail(readings, lower, upper, i, count, fail_mask);
+}
+
+#endif // LIMIT_CHECK_NEON
+
+CheckFunction selectImplementation() {
+#ifdef LIMIT_CHECK_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return checkAvx2;
+#endif
+#ifdef LIMIT_CHECK_NEON
+    return checkNeon;
+#endif
+    return checkLimitsScalar;
+}
+
+CheckFunction implementation() {
+    static const CheckFunction selected = selectImplementation();
+    return selected;
+}
+
+} // namespace
+
+ChannelLimits channelLimitsFrom(const EquipmentConfig& config) {
+    const auto& nominal = config.channel_nominal;
+    const auto& lower = config.channel_lower_limit;
+    const auto& upper = config.channel_upper_limit;
+    size_t channels = std::max({nominal.size(), lower.size(), upper.size()});
+    constexpr double unbounded = std::numeric_limits<double>::infinity();
+
+    ChannelLimits limits;
+    limits.lower.resize(channels);
+    limits.upper.resize(channels);
+    for (size_t i = 0; i < channels; ++i) {
+        bool hasNominal = i < nominal.size();
+        limits.lower[i] = i < lower.size() ? lower[i]
+                        : hasNominal ? nominal[i] - config.measurement_tolerance : -unbounded;
+        limits.upper[i] = i < upper.size() ? upper[i]
+                        : hasNominal ? nominal[i] + config.measurement_tolerance : unbounded;
+    }
+    return limits;
+}
+
+size_t checkLimits(const double* readings, const double* lower, const double* upper, size_t count,
+                   std::uint64_t* fail_mask) {
+    return implementation()(readings, lower, upper, count, fail_mask);
+}
+
+size_t checkLimitsScalar(const double* readings, const double* lower, const double* upper, size_t count,
+                         std::uint64_t* fail_mask) {
+    clearMask(fail_mask, count);
+    return checkTail(readings, lower, upper, 0, count, fail_mask);
+}
+
+size_t checkChannelLimits(const ChannelLimits& limits, const double* readings, size_t count,
+                          std::vector<std::uint64_t>& fail_mask) {
+    size_t checked = std::min(count, limits.channels());
+    fail_mask.assign((std::max(count, limits.channels()) + 63) / 64, 0);
+    size_t failures = checkLimits(readings, limits.lower.data(), limits.upper.data(), checked, fail_mask.data());
+
+    // Channels missing from the reply fail
+    for (size_t i = checked; i < limits.channels(); ++i) {
+        fail_mask[i / 64] |= std::uint64_t{1} << (i % 64);
+        ++failures;
+    }
+    return failures;
+}
+
+const char* limitCheckImplementation() {
+    CheckFunction selected = implementation();
+#ifdef LIMIT_CHECK_AVX2
+    if (selected == checkAvx2) return "avx2";
+#endif
+#ifdef LIMIT_CHECK_NEON
+    if (selected == checkNeon) return "neon";
+#endif
+    (void)selected;
+    return "scalar";
+}
+
+} // namespace MechatronicTest
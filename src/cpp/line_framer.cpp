@@ -0,0 +1,80 @@
+/**
+ * @file line_framer.cpp
+ * @brief Implementation of the line framer
+ */
+
+#include "line_framer.h"
+#include <cctype>
+#include <cstring>
+
+namespace MechatronicTest {
+
+LineFramer::LineFramer(size_t capacity, char terminator)
+    : storage(capacity > 0 ? capacity : 1), terminator(terminator), trimWhitespace(true), head(0), scanned(0),
+      tail(0) {}
+
+char* LineFramer::prepareWrite(size_t& length) {
+    if (head == tail) {
+        head = scanned = tail = 0;
+    } else if (tail == storage.size() && head > 0) {
+        // Slide the partial frame to the front to reopen the tail
+        size_t pending = tail - head;
+        std::memmove(storage.data(), storage.data() + head, pending);
+        scanned -= head;
+        tail = pending;
+        head = 0;
+    }
+
+    length = storage.size() - tail;
+    return storage.data() + tail;
+}
+
+void LineFramer::commitWrite(size_t length) {
+    tail += length;
+    if (tail > storage.size()) {
+        tail = storage.size();
+    }
+}
+
+bool LineFramer::nextFrame(std::string_view& frame) {
+    while (head < tail) {
+        const char* base = storage.data();
+        const void* found = std::memchr(base + scanned, terminator, tail - scanned);
+
+        size_t end;
+        size_t next;
+        if (found != nullptr) {
+            end = static_cast<const char*>(found) - base;
+            next = end + 1;
+        } else if (head == 0 && tail == storage.size()) {
+            end = next = tail;
+        } else {
+            scanned = tail;
+            return false;
+        }
+
+        size_t start = head;
+        head = scanned = next;
+
+        while (trimWhitespace && end > start && std::isspace(static_cast<unsigned char>(base[end - 1]))) {
+            --end;
+        }
+        if (end > start) {
+            frame = std::string_view(base + start, end - start);
+            return true;
+        }
+    }
+    return false;
+}
+
+void LineFramer::clear() {
+    head = scanned = tail = 0;
+}
+
+void LineFramer::setFraming(char frame_terminator, bool trim_whitespace) {
+    terminator = frame_terminator;
+    trimWhitespace = trim_whitespace;
+    scanned = head;  // Rescan for the new terminator
+}
+
+} // namespace MechatronicTest
@@ -4,7 +4,14 @@
  */
 
 #include "equipment_controller.h"
+#include "result_export.h"
+#include "station_pool.h"
+#include "test_plan.h"
+#include "test_server.h"
+#include <atomic>
+#include <csignal>
 #include <iostream>
+#include <iomanip>
 #include <string>
 #include <thread>
 #include <chrono>
@@ -23,15 +30,83 @@ void statusCallback(EquipmentStatus status, const std::string& message) {
     std::cout << "[STATUS] " << statusStr << ": " << message << std::endl;
 }
 
+std::atomic<bool> stopRequested(false);
+
+void requestStop(int) {
+    stopRequested = true;
+}
+
+/**
+ * @brief Keep one controller per station resident and serve test requests until SIGINT/SIGTERM
+ */
+int runServer(const EquipmentConfig& config, const std::vector<std::string>& station_ports,
+              const std::string& address) {
+    StationPool pool;
+    for (const auto& port : station_ports) {
+        EquipmentConfig station = config;
+        station.device_port = port;
+        size_t index = pool.addStation(station);
+        if (!pool.station(index).isConnected()) {
+            std::cerr << "Warning: Station " << index << " (" << port << ") not connected: "
+                      << pool.station(index).getLastError() << std::endl;
+        }
+    }
+    if (!pool.start()) {
+        std::cerr << "Error: No station could be started" << std::endl;
+        return 1;
+    }
+
+    TestServer server(pool);
+    if (!server.start(address)) {
+        std::cerr << "Error: " << server.getLastError() << std::endl;
+        return 1;
+    }
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    std::cout << "Serving " << pool.stationCount() << " station(s) on " << server.boundAddress() << std::endl;
+
+    while (!stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    std::cout << "\nShutting down..." << std::endl;
+    server.stop();
+    pool.stop();
+    return 0;
+}
+
+void printPlanResult(const TestPlan& plan, const PlanResult& result) {
+    std::cout << "\nPlan " << (plan.name().empty() ? "(unnamed)" : plan.name()) << ": "
+              << (result.passed ? "PASS" : "FAIL") << " in "
+              << std::chrono::duration<double, std::milli>(result.elapsed).count() << " ms" << std::endl;
+    for (const auto& step : result.steps) {
+        std::cout << "  " << std::left << std::setw(16) << step.id << std::right
+                  << (!step.ran ? "SKIP" : step.passed ? "PASS" : "FAIL");
+        if (step.ran) {
+            std::cout << "  station " << step.station << "  " << step.result.measurement_value << " " << step.result.units;
+        }
+        std::cout << "  " << step.result.notes << std::endl;
+    }
+}
+
 void printUsage() {
     std::cout << "Automated Mechatronic Test Inspection System\n";
     std::cout << "Usage: mechatronic_test_system [options]\n";
     std::cout << "Options:\n";
-    std::cout << "  -p, --port <port>     Serial port (default: COM1 on Windows, /dev/ttyUSB0 on Linux)\n";
+    std::cout << "  -i, --interface <type> Hardware interface: serial, tcp, usb or sim (default: serial)\n";
+    std::cout << "  -p, --port <port>     Serial port (default: COM1 on Windows, /dev/ttyUSB0 on Linux);\n";
+    std::cout << "                        for tcp, host:port; for usb, vid:pid[:serial]\n";
+    std::cout << "                        for sim, an optional model such as latency_us=200,fail_rate=0.01\n";
     std::cout << "  -b, --baud <rate>     Baud rate (default: 115200)\n";
+    std::cout << "      --binary          Use the binary device protocol if the firmware supports it\n";
     std::cout << "  -t, --test <device>   Run test on specified device\n";
-    std::cout << "  -c, --calibrate       Perform equipment calibration\n";
+    std::cout << "      --plan <file>     With --test, run the test_plan from this YAML configuration\n";
+    std::cout << "  -c, --calibrate       Perform equipment calibration, unless the cached one is still valid\n";
+    std::cout << "      --recalibrate     Perform equipment calibration even if the cached one is valid\n";
+    std::cout << "      --calibration-cache <file>  Keep calibration profiles in this file\n";
     std::cout << "  -s, --status          Show equipment status\n";
+    std::cout << "      --serve <address> Keep the stations open and serve test requests on host:port or unix:<path>\n";
+    std::cout << "      --station <port>  Add a station for --serve or --plan (repeatable; default: the -p port)\n";
+    std::cout << "      --export <journal> <csv>  Write a result journal out as CSV and exit\n";
     std::cout << "  -h, --help            Show this help message\n";
 }
 
@@ -56,7 +131,13 @@ int main(int argc, char* argv[]) {
 
     std::string test_device;
     bool run_calibration = false;
+    bool force_calibration = false;
     bool show_status = false;
+    std::string serve_address;
+    std::string plan_file;
+    std::vector<std::string> station_ports;
+    std::string export_journal;
+    std::string export_csv;
 
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
@@ -65,6 +146,13 @@ int main(int argc, char* argv[]) {
         if (arg == "-h" || arg == "--help") {
             printUsage();
             return 0;
+        } else if (arg == "-i" || arg == "--interface") {
+            if (i + 1 < argc) {
+                config.interface_type = argv[++i];
+            } else {
+                std::cerr << "Error: Interface argument requires a value" << std::endl;
+                return 1;
+            }
         } else if (arg == "-p" || arg == "--port") {
             if (i + 1 < argc) {
                 config.device_port = argv[++i];
@@ -79,6 +167,8 @@ int main(int argc, char* argv[]) {
                 std::cerr << "Error: Baud rate argument requires a value" << std::endl;
                 return 1;
             }
+        } else if (arg == "--binary") {
+            config.binary_protocol = true;
         } else if (arg == "-t" || arg == "--test") {
             if (i + 1 < argc) {
                 test_device = argv[++i];
@@ -88,8 +178,47 @@ int main(int argc, char* argv[]) {
             }
         } else if (arg == "-c" || arg == "--calibrate") {
             run_calibration = true;
+        } else if (arg == "--recalibrate") {
+            run_calibration = true;
+            force_calibration = true;
+        } else if (arg == "--calibration-cache") {
+            if (i + 1 < argc) {
+                config.calibration_cache_path = argv[++i];
+            } else {
+                std::cerr << "Error: Calibration cache argument requires a value" << std::endl;
+                return 1;
+            }
         } else if (arg == "-s" || arg == "--status") {
             show_status = true;
+        } else if (arg == "--plan") {
+            if (i + 1 < argc) {
+                plan_file = argv[++i];
+            } else {
+                std::cerr << "Error: Plan argument requires a file" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--serve") {
+            if (i + 1 < argc) {
+                serve_address = argv[++i];
+            } else {
+                std::cerr << "Error: Serve argument requires an address" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--station") {
+            if (i + 1 < argc) {
+                station_ports.push_back(argv[++i]);
+            } else {
+                std::cerr << "Error: Station argument requires a port" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--export") {
+            if (i + 2 < argc) {
+                export_journal = argv[++i];
+                export_csv = argv[++i];
+            } else {
+                std::cerr << "Error: Export argument requires a journal and a CSV file" << std::endl;
+                return 1;
+            }
         } else {
             std::cerr << "Error: Unknown argument: " << arg << std::endl;
             printUsage();
@@ -97,11 +226,61 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (!export_journal.empty()) {
+        CsvExporter exporter;
+        if (!exporter.exportJournal(export_journal, export_csv)) {
+            std::cerr << "Error: " << exporter.getLastError() << std::endl;
+            return 1;
+        }
+        ExportStats stats = exporter.getStats();
+        std::cout << "Exported " << stats.rows << " results to " << export_csv << " in "
+                  << stats.elapsed_ms << " ms" << std::endl;
+        return 0;
+    }
+
+    TestPlan plan;
+    if (!plan_file.empty()) {
+        if (test_device.empty()) {
+            std::cerr << "Error: --plan needs a device to test (--test)" << std::endl;
+            return 1;
+        }
+        if (!loadTestPlan(plan_file, plan)) {
+            std::cerr << "Error: " << plan.getLastError() << std::endl;
+            return 1;
+        }
+    }
+
+    // A plan over several stations runs its independent steps in parallel
+    if (plan.isCompiled() && serve_address.empty() && !station_ports.empty()) {
+        StationPool pool;
+        for (const auto& port : station_ports) {
+            EquipmentConfig station = config;
+            station.device_port = port;
+            pool.addStation(station);
+        }
+        if (!pool.start()) {
+            std::cerr << "Error: No station could be started" << std::endl;
+            return 1;
+        }
+        PlanResult result = plan.run(pool, test_device);
+        pool.stop();
+        printPlanResult(plan, result);
+        return 0;
+    }
+
+    if (!serve_address.empty()) {
+        if (station_ports.empty()) {
+            station_ports.push_back(config.device_port);
+        }
+        return runServer(config, station_ports, serve_address);
+    }
+
     // Create and initialize equipment controller
     EquipmentController controller;
     controller.setStatusCallback(statusCallback);
 
     std::cout << "Initializing equipment controller..." << std::endl;
+    std::cout << "Interface: " << config.interface_type << std::endl;
     std::cout << "Port: " << config.device_port << std::endl;
     std::cout << "Baud Rate: " << config.baud_rate << std::endl;
 
@@ -110,6 +289,8 @@ int main(int argc, char* argv[]) {
                   << controller.getLastError() << std::endl;
         std::cout << "Note: This is expected if no hardware is connected. Continuing in simulation mode." << std::endl;
     }
+    // Status callbacks print from the dispatcher thread; let them land before our own output
+    controller.waitForStatusEvents();
 
     // Show status if requested
     if (show_status) {
@@ -130,12 +311,28 @@ int main(int argc, char* argv[]) {
         for (const auto& metric : metrics) {
             std::cout << "  " << metric.first << ": " << metric.second << std::endl;
         }
+
+        auto latency = controller.getLatencyReport();
+        std::cout << "\nLatency (us):" << std::endl;
+        std::cout << "  " << std::left << std::setw(12) << "stage" << std::right
+                  << std::setw(10) << "count" << std::setw(10) << "p50"
+                  << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max" << std::endl;
+        std::cout << std::fixed << std::setprecision(1);
+        for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+            const LatencySummary& stage = latency.stages[i];
+            std::cout << "  " << std::left << std::setw(12) << latencyStageName(static_cast<LatencyStage>(i))
+                      << std::right << std::setw(10) << stage.count << std::setw(10) << stage.p50_us
+                      << std::setw(10) << stage.p99_us << std::setw(10) << stage.p999_us
+                      << std::setw(10) << stage.max_us << std::endl;
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
     }
 
     // Run calibration if requested
     if (run_calibration) {
         std::cout << "\n=== Equipment Calibration ===" << std::endl;
-        if (controller.calibrate()) {
+        if (controller.calibrate(force_calibration)) {
             std::cout << "Calibration completed successfully!" << std::endl;
         } else {
             std::cerr << "Calibration failed: " << controller.getLastError() << std::endl;
@@ -152,6 +349,14 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
+        if (plan.isCompiled()) {
+            PlanResult result = plan.run(controller, test_device);
+            controller.stop();
+            printPlanResult(plan, result);
+            controller.waitForStatusEvents();
+            return 0;
+        }
+
         // Run test with sample parameters
         std::vector<std::string> test_params = {"voltage", "5.0", "current", "0.1"};
         TestResult result = controller.runTest(test_device, test_params);
@@ -174,6 +379,7 @@ int main(int argc, char* argv[]) {
 
         std::string command;
         while (true) {
+            controller.waitForStatusEvents();
             std::cout << "\n> ";
             std::getline(std::cin, command);
 
@@ -209,11 +415,14 @@ int main(int argc, char* argv[]) {
                     device = command.substr(5);
                 }
                 
+                // Run in the background so the prompt stays responsive during the measurement
                 std::vector<std::string> params = {"default", "test"};
-                TestResult result = controller.runTest(device, params);
-                
-                std::cout << "Test " << (result.passed ? "PASSED" : "FAILED") << std::endl;
-                std::cout << "Notes: " << result.notes << std::endl;
+                std::cout << "Test started on " << device << std::endl;
+                controller.runTestAsync(device, params, [](const TestResult& result) {
+                    std::cout << "\nTest " << result.device_id << " "
+                              << (result.passed ? "PASSED" : "FAILED") << std::endl;
+                    std::cout << "Notes: " << result.notes << std::endl;
+                });
             } else if (command == "calibrate") {
                 if (controller.calibrate()) {
                     std::cout << "Calibration completed." << std::endl;
@@ -239,6 +448,7 @@ int main(int argc, char* argv[]) {
 
     std::cout << "\nShutting down..." << std::endl;
     controller.stop();
+    controller.waitForStatusEvents();
     
     return 0;
 }
\ No newline at end of file
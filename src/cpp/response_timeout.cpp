@@ -0,0 +1,103 @@
+/**
+ * @file response_timeout.cpp
+ * @brief Implementation of adaptive response timeouts
+ */
+
+#include "response_timeout.h"
+#include "equipment_controller.h"
+#include <algorithm>
+#include <cmath>
+
+namespace MechatronicTest {
+
+TimeoutOptions timeoutOptionsFrom(const EquipmentConfig& config) {
+    TimeoutOptions options;
+    options.adaptive = config.adaptive_timeouts;
+    options.floor_ms = std::max(1, config.response_timeout_floor_ms);
+    options.ceiling_ms = std::max(options.floor_ms, config.response_timeout_ceiling_ms);
+    options.k = std::max(0.0, config.response_timeout_k);
+    return options;
+}
+
+ResponseTimeoutEstimator::ResponseTimeoutEstimator(const TimeoutOptions& timeout_options)
+    : options(timeout_options) {}
+
+void ResponseTimeoutEstimator::reset(const TimeoutOptions& timeout_options) {
+    std::lock_guard<std::mutex> lock(mutex);
+    options = timeout_options;
+    entries.clear();
+}
+
+ResponseTimeoutEstimator::Entry& ResponseTimeoutEstimator::entry(std::string_view device_type,
+                                                                 std::string_view command) {
+    for (auto& candidate : entries) {
+        if (candidate.device_type == device_type && candidate.command == command) {
+            return candidate;
+        }
+    }
+    entries.emplace_back();
+    entries.back().device_type.assign(device_type.data(), device_type.size());
+    entries.back().command.assign(command.data(), command.size());
+    return entries.back();
+}
+
+double ResponseTimeoutEstimator::timeoutOf(const Entry& entry) const {
+    double ceiling = entry.ceiling_ms > 0 ? entry.ceiling_ms : options.ceiling_ms;
+    double floor = std::min<double>(options.floor_ms, ceiling);
+    if (!options.adaptive || entry.samples == 0) {
+        return ceiling;
+    }
+    double timeout = (entry.smoothed_ms + options.k * entry.deviation_ms) * entry.backoff;
+    return std::min(ceiling, std::max(floor, timeout));
+}
+
+int ResponseTimeoutEstimator::timeoutMs(std::string_view device_type, std::string_view command, int ceiling_ms) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& e = entry(device_type, command);
+    e.ceiling_ms = ceiling_ms;
+    return static_cast<int>(std::ceil(timeoutOf(e)));
+}
+
+void ResponseTimeoutEstimator::recordResponse(std::string_view device_type, std::string_view command,
+                                              std::chrono::steady_clock::duration elapsed) {
+    double sample = std::chrono::duration<double, std::milli>(elapsed).count();
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& e = entry(device_type, command);
+    if (e.samples == 0) {
+        e.smoothed_ms = sample;
+        e.deviation_ms = sample / 2.0;
+    } else {
+        e.deviation_ms = (1.0 - options.beta) * e.deviation_ms + options.beta * std::abs(e.smoothed_ms - sample);
+        e.smoothed_ms = (1.0 - options.alpha) * e.smoothed_ms + options.alpha * sample;
+    }
+    ++e.samples;
+    e.backoff = 1.0;
+}
+
+void ResponseTimeoutEstimator::recordTimeout(std::string_view device_type, std::string_view command, int ceiling_ms) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& e = entry(device_type, command);
+    e.ceiling_ms = ceiling_ms;
+    if (timeoutOf(e) < (ceiling_ms > 0 ? ceiling_ms : options.ceiling_ms)) {
+        e.backoff *= 2.0;
+    }
+}
+
+std::vector<ResponseTimeoutStats> ResponseTimeoutEstimator::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<ResponseTimeoutStats> stats;
+    stats.reserve(entries.size());
+    for (const auto& e : entries) {
+        stats.push_back({e.device_type, e.command, e.samples, e.smoothed_ms, e.deviation_ms, timeoutOf(e)});
+    }
+    return stats;
+}
+
+std::string_view deviceTypeOf(std::string_view device_id) {
+    size_t end = device_id.size();
+    while (end > 0 && device_id[end - 1] >= '0' && device_id[end - 1] <= '9') --end;
+    while (end > 0 && (device_id[end - 1] == '_' || device_id[end - 1] == '-' || device_id[end - 1] == '.')) --end;
+    return end == 0 ? device_id : device_id.substr(0, end);
+}
+
+} // namespace MechatronicTest
@@ -0,0 +1,412 @@
+/**
+ * @file result_export.cpp
+ * @brief Implementation of the bulk CSV exporter
+ */
+
+#include "result_export.h"
+#include "equipment_controller.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace MechatronicTest {
+
+namespace {
+
+// Longest row apart from the device ID: 20-digit test ID, 27-character
+// timestamp, 24-character double, unit, outcome, flag and delimiters
+constexpr size_t FIXED_ROW_BYTES = 128;
+
+const char* outcomeName(OutcomeCode code) {
+    switch (code) {
+        case OutcomeCode::COMPLETED: return "COMPLETED";
+        case OutcomeCode::NOT_RUNNING: return "NOT_RUNNING";
+        case OutcomeCode::NOT_CONNECTED: return "NOT_CONNECTED";
+        case OutcomeCode::PIPELINE_BUSY: return "PIPELINE_BUSY";
+        case OutcomeCode::SEND_FAILED: return "SEND_FAILED";
+        case OutcomeCode::NO_RESPONSE: return "NO_RESPONSE";
+        case OutcomeCode::INVALID_RESPONSE: return "INVALID_RESPONSE";
+        case OutcomeCode::CORRUPT_RESPONSE: return "CORRUPT_RESPONSE";
+        case OutcomeCode::STREAMING: return "STREAMING";
+    }
+    return "?";
+}
+
+char* put(char* out, const char* text) {
+    size_t length = std::strlen(text);
+    std::memcpy(out, text, length);
+    return out + length;
+}
+
+char* putDigits(char* out, unsigned value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return out + width;
+}
+
+bool needsQuotes(const char* text, size_t length, char delimiter) {
+    for (size_t i = 0; i < length; ++i) {
+        char c = text[i];
+        if (c == delimiter || c == '"' || c == '\n' || c == '\r') return true;
+    }
+    return false;
+}
+
+// Writes a field, quoting it as RFC 4180 requires; out needs 2 * length + 2 bytes
+char* putField(char* out, const char* text, size_t length, char delimiter) {
+    if (!needsQuotes(text, length, delimiter)) {
+        std::memcpy(out, text, length);
+        return out + length;
+    }
+    *out++ = '"';
+    for (size_t i = 0; i < length; ++i) {
+        if (text[i] == '"') *out++ = '"';
+        *out++ = text[i];
+    }
+    *out++ = '"';
+    return out;
+}
+
+/**
+ * @brief Formats epoch microseconds as "YYYY-MM-DDTHH:MM:SS.ffffffZ"
+ *
+ * Results arrive in time order, so the date is converted once per day
+ * (Hinnant's civil-from-days) and the rest is integer arithmetic.
+ */
+class TimestampFormatter {
+public:
+    char* format(char* out, std::int64_t epoch_us) {
+        std::int64_t seconds = epoch_us >= 0 ? epoch_us / 1000000 : -((-epoch_us + 999999) / 1000000);
+        auto micros = static_cast<unsigned>(epoch_us - seconds * 1000000);
+        std::int64_t day = seconds >= 0 ? seconds / 86400 : -((-seconds + 86399) / 86400);
+        auto secondOfDay = static_cast<unsigned>(seconds - day * 86400);
+        if (day != cachedDay) {
+            cacheDate(day);
+        }
+        std::memcpy(out, date, sizeof(date));
+        out += sizeof(date);
+        out = putDigits(out, secondOfDay / 3600, 2);
+        *out++ = ':';
+        out = putDigits(out, secondOfDay / 60 % 60, 2);
+        *out++ = ':';
+        out = putDigits(out, secondOfDay % 60, 2);
+        *out++ = '.';
+        out = putDigits(out, micros, 6);
+        *out++ = 'Z';
+        return out;
+    }
+
+private:
+    void cacheDate(std::int64_t day) {
+        std::int64_t z = day + 719468;
+        std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        auto dayOfEra = static_cast<unsigned>(z - era * 146097);
+        unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        unsigned mp = (5 * dayOfYear + 2) / 153;
+        unsigned dayOfMonth = dayOfYear - (153 * mp + 2) / 5 + 1;
+        unsigned month = mp < 10 ? mp + 3 : mp - 9;
+        std::int64_t year = static_cast<std::int64_t>(yearOfEra) + era * 400 + (month <= 2 ? 1 : 0);
+
+        char* out = putDigits(date, static_cast<unsigned>(std::clamp<std::int64_t>(year, 0, 9999)), 4);
+        *out++ = '-';
+        out = putDigits(out, month, 2);
+        *out++ = '-';
+        out = putDigits(out, dayOfMonth, 2);
+        *out = 'T';
+        cachedDay = day;
+    }
+
+    std::int64_t cachedDay = std::numeric_limits<std::int64_t>::min();
+    char date[11];  ///< "YYYY-MM-DDT"
+};
+
+} // namespace
+
+/**
+ * @brief Output file with a fixed buffer that rows are formatted into in place
+ */
+class CsvExporter::Writer {
+public:
+    Writer(std::vector<char>& storage, char field_delimiter)
+        : buffer(storage), delimiter(field_delimiter), file(nullptr), used(0), written(0) {}
+
+    ~Writer() {
+        if (file) std::fclose(file);
+    }
+
+    bool open(const std::string& path) {
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        std::setvbuf(file, nullptr, _IONBF, 0);  // Our buffer is the only one
+        return true;
+    }
+
+    /**
+     * @brief Get room for at least bytes characters at the end of the buffer
+     */
+    char* reserve(size_t bytes) {
+        if (buffer.size() - used < bytes) {
+            flush();
+            if (buffer.size() < bytes) buffer.resize(bytes);  // Only for pathologically long device IDs
+        }
+        return buffer.data() + used;
+    }
+
+    void commit(const char* end) {
+        used = static_cast<size_t>(end - buffer.data());
+    }
+
+    bool flush() {
+        if (used > 0 && !failed) {
+            failed = std::fwrite(buffer.data(), 1, used, file) != used;
+            written += used;
+        }
+        used = 0;
+        return !failed;
+    }
+
+    bool close() {
+        bool ok = flush();
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        return ok;
+    }
+
+    void writeHeader() {
+        static const char* const columns[] = {"test_id", "timestamp", "device_id", "value", "unit", "outcome", "passed"};
+        char* out = reserve(FIXED_ROW_BYTES);
+        for (size_t i = 0; i < sizeof(columns) / sizeof(columns[0]); ++i) {
+            if (i > 0) *out++ = delimiter;
+            out = put(out, columns[i]);
+        }
+        *out++ = '\n';
+        commit(out);
+    }
+
+    /**
+     * @brief Append one row; device is written as given, so it must already be quoted if needed
+     */
+    void writeRow(const ResultRecord& record, const char* device, size_t device_length) {
+        char* out = reserve(FIXED_ROW_BYTES + device_length);
+        char* end = buffer.data() + buffer.size();
+        out = std::to_chars(out, end, record.test_id).ptr;
+        *out++ = delimiter;
+        out = timestamps.format(out, record.timestamp_us);
+        *out++ = delimiter;
+        std::memcpy(out, device, device_length);
+        out += device_length;
+        *out++ = delimiter;
+        out = std::to_chars(out, end, record.value).ptr;
+        *out++ = delimiter;
+        out = put(out, unitCodeToString(record.unit));
+        *out++ = delimiter;
+        out = put(out, outcomeName(record.outcome));
+        *out++ = delimiter;
+        *out++ = record.passed ? '1' : '0';
+        *out++ = '\n';
+        commit(out);
+    }
+
+    std::uint64_t bytes() const { return written + used; }
+
+private:
+    std::vector<char>& buffer;
+    char delimiter;
+    std::FILE* file;
+    size_t used;
+    std::uint64_t written;
+    bool failed = false;
+    TimestampFormatter timestamps;
+};
+
+CsvExporter::CsvExporter(const ExportOptions& export_options)
+    : options(export_options), busy(false), cancelled(false), rowsWritten(0), totalRows(0),
+      bytesWritten(0), groupsWritten(0), elapsedMs(0.0) {
+    options.buffer_bytes = std::max<size_t>(options.buffer_bytes, 4096);
+    options.row_group_rows = std::max<size_t>(options.row_group_rows, 1);
+}
+
+CsvExporter::~CsvExporter() {
+    cancel();
+    if (worker.joinable()) worker.join();
+}
+
+template <typename FormatRow>
+bool CsvExporter::run(const std::string& path, size_t rows, FormatRow&& formatRow) {
+    auto started = std::chrono::steady_clock::now();
+    rowsWritten = 0;
+    totalRows = rows;
+    bytesWritten = 0;
+    groupsWritten = 0;
+    if (buffer.size() < options.buffer_bytes) {
+        buffer.resize(options.buffer_bytes);
+    }
+
+    std::string partial = path + ".tmp";
+    bool ok = false;
+    {
+        Writer writer(buffer, options.delimiter);
+        if (!writer.open(partial)) {
+            setError("Failed to create " + partial);
+            return false;
+        }
+        if (options.header) writer.writeHeader();
+
+        size_t row = 0;
+        while (row < rows && !cancelled.load(std::memory_order_relaxed)) {
+            size_t groupEnd = std::min(rows, row + options.row_group_rows);
+            for (; row < groupEnd; ++row) {
+                formatRow(writer, row);
+            }
+            rowsWritten.store(row, std::memory_order_relaxed);
+            bytesWritten.store(writer.bytes(), std::memory_order_relaxed);
+            groupsWritten.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ok = writer.close();
+        bytesWritten = writer.bytes();
+        if (!ok) {
+            setError("Failed to write " + partial);
+        } else if (row < rows) {
+            setError("Export cancelled");
+            ok = false;
+        }
+    }
+
+    if (ok && std::rename(partial.c_str(), path.c_str()) != 0) {
+        setError("Failed to rename " + partial + " to " + path);
+        ok = false;
+    }
+    if (!ok) {
+        std::remove(partial.c_str());
+    }
+    elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    return ok;
+}
+
+bool CsvExporter::begin() {
+    if (busy.exchange(true)) {
+        setError("Export already running");
+        return false;
+    }
+    cancelled = false;
+    return true;
+}
+
+bool CsvExporter::writeStore(const ResultStore& store, const std::string& path) {
+    // Quote each device name once rather than once per row
+    std::vector<std::string> devices(store.deviceCount());
+    for (size_t i = 0; i < devices.size(); ++i) {
+        const std::string& name = store.deviceName(static_cast<std::uint32_t>(i));
+        devices[i].resize(2 * name.size() + 2);
+        devices[i].resize(static_cast<size_t>(
+            putField(&devices[i][0], name.data(), name.size(), options.delimiter) - devices[i].data()));
+    }
+
+    const std::uint64_t* testIds = store.testIdColumn();
+    const std::int64_t* timestamps = store.timestampColumn();
+    const double* values = store.valueColumn();
+    const std::uint32_t* deviceIndexes = store.deviceColumn();
+    const UnitCode* units = store.unitColumn();
+    const OutcomeCode* outcomes = store.outcomeColumn();
+    const std::uint8_t* passed = store.passedColumn();
+    static const std::string unknown;
+
+    return run(path, store.size(), [&](Writer& writer, size_t i) {
+        ResultRecord record{testIds[i], timestamps[i], values[i], deviceIndexes[i], units[i], outcomes[i], passed[i], 0};
+        const std::string& device = record.device_index < devices.size() ? devices[record.device_index] : unknown;
+        writer.writeRow(record, device.data(), device.size());
+    });
+}
+
+bool CsvExporter::writeJournal(const JournalReader& journal, const std::string& path) {
+    char delimiter = options.delimiter;
+    return run(path, journal.size(), [&journal, delimiter](Writer& writer, size_t i) {
+        const JournalRecord& entry = journal.record(i);
+        size_t length = strnlen(entry.device_id, sizeof(entry.device_id));
+        char device[2 * sizeof(entry.device_id) + 2];
+        size_t quoted = static_cast<size_t>(putField(device, entry.device_id, length, delimiter) - device);
+        writer.writeRow(entry.result, device, quoted);
+    });
+}
+
+bool CsvExporter::writeJournalFile(const std::string& journal_path, const std::string& path) {
+    JournalReader journal;
+    if (!journal.open(journal_path)) {
+        setError("Failed to open journal " + journal_path);
+        return false;
+    }
+    return writeJournal(journal, path);
+}
+
+bool CsvExporter::exportStore(const ResultStore& store, const std::string& path) {
+    if (!begin()) return false;
+    bool ok = writeStore(store, path);
+    busy = false;
+    return ok;
+}
+
+bool CsvExporter::exportJournal(const JournalReader& journal, const std::string& path) {
+    if (!begin()) return false;
+    bool ok = writeJournal(journal, path);
+    busy = false;
+    return ok;
+}
+
+bool CsvExporter::exportJournal(const std::string& journal_path, const std::string& path) {
+    if (!begin()) return false;
+    bool ok = writeJournalFile(journal_path, path);
+    busy = false;
+    return ok;
+}
+
+std::future<bool> CsvExporter::exportJournalAsync(const std::string& journal_path, const std::string& path) {
+    std::promise<bool> promise;
+    std::future<bool> future = promise.get_future();
+    if (!begin()) {
+        promise.set_value(false);
+        return future;
+    }
+    if (worker.joinable()) {
+        worker.join();  // The previous background export has finished; reclaim its thread
+    }
+    worker = std::thread([this, journal_path, path, promise = std::move(promise)]() mutable {
+        bool ok = writeJournalFile(journal_path, path);
+        busy = false;
+        promise.set_value(ok);
+    });
+    return future;
+}
+
+void CsvExporter::cancel() {
+    cancelled = true;
+}
+
+ExportStats CsvExporter::getStats() const {
+    ExportStats stats;
+    stats.rows = rowsWritten.load(std::memory_order_relaxed);
+    stats.total_rows = totalRows.load(std::memory_order_relaxed);
+    stats.bytes = bytesWritten.load(std::memory_order_relaxed);
+    stats.row_groups = groupsWritten.load(std::memory_order_relaxed);
+    stats.elapsed_ms = elapsedMs.load(std::memory_order_relaxed);
+    stats.running = busy.load();
+    return stats;
+}
+
+std::string CsvExporter::getLastError() const {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    return lastError;
+}
+
+void CsvExporter::setError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    lastError = error;
+}
+
+} // namespace MechatronicTest
@@ -0,0 +1,348 @@
+/**
+ * @file result_journal.cpp
+ * @brief Implementation of the memory-mapped result journal
+ */
+
+#include "result_journal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MechatronicTest {
+
+namespace {
+
+constexpr char JOURNAL_MAGIC[8] = {'M', 'T', 'R', 'J', 'R', 'N', 'L', '\0'};
+
+// Records start after the header, on a cache-line multiple
+constexpr size_t JOURNAL_DATA_OFFSET = 128;
+
+static_assert(sizeof(JournalHeader) <= JOURNAL_DATA_OFFSET, "Header overlaps record area");
+
+size_t journalBytes(size_t records) {
+    return JOURNAL_DATA_OFFSET + records * sizeof(JournalRecord);
+}
+
+void copyTruncated(char* destination, size_t capacity, std::string_view source) {
+    size_t length = std::min(source.size(), capacity - 1);
+    std::memcpy(destination, source.data(), length);
+    std::memset(destination + length, 0, capacity - length);
+}
+
+bool validHeader(const JournalHeader& header) {
+    return std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) == 0 &&
+           header.schema_version == JOURNAL_SCHEMA_VERSION &&
+           header.record_size == sizeof(JournalRecord);
+}
+
+} // namespace
+
+// ResultJournal implementation
+ResultJournal::ResultJournal()
+    : fd(-1), mapping(nullptr), mappedBytes(0), capacityRecords(0), appendedRecords(0), syncedRecords(0),
+      stopping(false) {}
+
+ResultJournal::~ResultJournal() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool ResultJournal::open(const std::string&, const std::string&, const JournalOptions&) {
+    std::lock_guard<std::mutex> lock(mutex);
+    lastError = "Result journal is not supported on this platform";
+    return false;
+}
+
+void ResultJournal::close() {}
+
+bool ResultJournal::remap(size_t) { return false; }
+
+bool ResultJournal::syncRange(size_t, size_t) { return false; }
+
+#else
+
+bool ResultJournal::open(const std::string& path, const std::string& station_id, const JournalOptions& journal_options) {
+    close();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    options = journal_options;
+    options.grow_records = std::max<size_t>(1, options.grow_records);
+    options.sync_interval_ms = std::max(1, options.sync_interval_ms);
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        lastError = "Failed to open journal " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        lastError = "Failed to stat journal " + path;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    bool created = info.st_size == 0;
+    size_t fileBytes = static_cast<size_t>(info.st_size);
+    if (!created && fileBytes < JOURNAL_DATA_OFFSET) {
+        lastError = "Journal " + path + " is truncated";
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    size_t records = created ? options.grow_records
+                             : (fileBytes - JOURNAL_DATA_OFFSET) / sizeof(JournalRecord);
+    if (!remap(std::max<size_t>(records, 1))) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    auto* header = static_cast<JournalHeader*>(mapping);
+    if (created) {
+        std::memset(header, 0, JOURNAL_DATA_OFFSET);
+        std::memcpy(header->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        header->schema_version = JOURNAL_SCHEMA_VERSION;
+        header->record_size = sizeof(JournalRecord);
+        header->record_count = 0;
+        header->created_us = toEpochMicros(std::chrono::system_clock::now());
+        copyTruncated(header->station_id, sizeof(header->station_id), station_id);
+        msync(mapping, JOURNAL_DATA_OFFSET, MS_SYNC);
+    } else if (!validHeader(*header) || header->record_count > capacityRecords) {
+        lastError = "Journal " + path + " has an unrecognized header";
+        munmap(mapping, mappedBytes);
+        mapping = nullptr;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    appendedRecords = syncedRecords = static_cast<size_t>(header->record_count);
+    stopping = false;
+    flusher = std::thread(&ResultJournal::flusherLoop, this);
+    return true;
+}
+
+void ResultJournal::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (mapping) {
+        syncRange(syncedRecords, appendedRecords);
+        munmap(mapping, mappedBytes);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    mappedBytes = capacityRecords = appendedRecords = syncedRecords = 0;
+}
+
+bool ResultJournal::remap(size_t capacity_records) {
+    if (mapping) {
+        munmap(mapping, mappedBytes);
+        mapping = nullptr;
+    }
+
+    size_t bytes = journalBytes(capacity_records);
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        (static_cast<size_t>(info.st_size) < bytes && ftruncate(fd, static_cast<off_t>(bytes)) != 0)) {
+        lastError = std::string("Failed to size journal: ") + std::strerror(errno);
+        return false;
+    }
+
+    void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        lastError = std::string("Failed to map journal: ") + std::strerror(errno);
+        return false;
+    }
+
+    mapping = address;
+    mappedBytes = bytes;
+    capacityRecords = capacity_records;
+    return true;
+}
+
+bool ResultJournal::syncRange(size_t first_record, size_t end_record) {
+    if (!mapping) return false;
+
+    // msync needs a page-aligned start
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = journalBytes(first_record) / pageSize * pageSize;
+    size_t end = std::min(journalBytes(end_record), mappedBytes);
+
+    if (end > begin && msync(static_cast<char*>(mapping) + begin, end - begin, MS_SYNC) != 0) {
+        lastError = std::string("Failed to sync journal: ") + std::strerror(errno);
+        return false;
+    }
+
+    // Only count records whose data is already on disk, then make the count durable
+    static_cast<JournalHeader*>(mapping)->record_count = end_record;
+    if (msync(mapping, std::min(pageSize, mappedBytes), MS_SYNC) != 0) {
+        lastError = std::string("Failed to sync journal header: ") + std::strerror(errno);
+        return false;
+    }
+
+    syncedRecords = end_record;
+    return true;
+}
+
+#endif
+
+void ResultJournal::flusherLoop() {
+    // Appends never signal, so poll; close() wakes early
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        wakeCondition.wait_for(lock, std::chrono::milliseconds(options.sync_interval_ms), [this] { return stopping; });
+        if (mapping && appendedRecords > syncedRecords) {
+            syncRange(syncedRecords, appendedRecords);
+        }
+    }
+}
+
+bool ResultJournal::isOpen() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return mapping != nullptr;
+}
+
+bool ResultJournal::append(std::string_view device_id, const ResultRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!mapping) return false;
+
+    size_t count = appendedRecords;
+    if (count >= capacityRecords) {
+        syncRange(syncedRecords, count);
+        if (!remap(capacityRecords + options.grow_records)) {
+            return false;
+        }
+    }
+
+    JournalRecord entry;
+    entry.result = record;
+    if (entry.result.test_id == 0) {
+        entry.result.test_id = count + 1;
+    }
+    copyTruncated(entry.device_id, sizeof(entry.device_id), device_id);
+    std::memcpy(static_cast<char*>(mapping) + journalBytes(count), &entry, sizeof(entry));
+    appendedRecords = count + 1;
+
+    // The header count is left to syncRange(); the flusher covers quiet periods
+    if (appendedRecords - syncedRecords >= options.sync_every_records) {
+        syncRange(syncedRecords, appendedRecords);
+    }
+    return true;
+}
+
+bool ResultJournal::append(std::string_view device_id, const TestOutcome& outcome) {
+    return append(device_id, makeResultRecord(outcome, 0, 0));
+}
+
+bool ResultJournal::append(const TestResult& result) {
+    return append(result.device_id, makeResultRecord(result, 0, 0));
+}
+
+bool ResultJournal::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!mapping) return false;
+    return syncRange(syncedRecords, appendedRecords);
+}
+
+std::uint64_t ResultJournal::recordCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendedRecords;
+}
+
+std::string ResultJournal::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastError;
+}
+
+// JournalReader implementation
+JournalReader::JournalReader() : fd(-1), mapping(nullptr), mappedBytes(0), recordCount(0) {}
+
+JournalReader::~JournalReader() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool JournalReader::open(const std::string&) { return false; }
+
+void JournalReader::close() {}
+
+#else
+
+bool JournalReader::open(const std::string& path) {
+    close();
+
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < JOURNAL_DATA_OFFSET) {
+        close();
+        return false;
+    }
+
+    mappedBytes = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, mappedBytes, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        mappedBytes = 0;
+        close();
+        return false;
+    }
+    mapping = address;
+
+    if (!validHeader(header())) {
+        close();
+        return false;
+    }
+
+    size_t capacity = (mappedBytes - JOURNAL_DATA_OFFSET) / sizeof(JournalRecord);
+    recordCount = std::min(static_cast<size_t>(header().record_count), capacity);
+    return true;
+}
+
+void JournalReader::close() {
+    if (mapping) {
+        munmap(const_cast<void*>(mapping), mappedBytes);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    mappedBytes = recordCount = 0;
+}
+
+#endif
+
+const JournalHeader& JournalReader::header() const {
+    return *static_cast<const JournalHeader*>(mapping);
+}
+
+const JournalRecord& JournalReader::record(size_t index) const {
+    return *reinterpret_cast<const JournalRecord*>(
+        static_cast<const char*>(mapping) + journalBytes(index));
+}
+
+} // namespace MechatronicTest
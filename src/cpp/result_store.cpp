@@ -0,0 +1,142 @@
+/**
+ * @file result_store.cpp
+ * @brief Implementation of the columnar result store
+ */
+
+#include "result_store.h"
+#include <stdexcept>
+
+namespace MechatronicTest {
+
+std::int64_t toEpochMicros(std::chrono::system_clock::time_point when) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(when.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromEpochMicros(std::int64_t epoch_us) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(epoch_us)));
+}
+
+ResultRecord makeResultRecord(const TestOutcome& outcome, std::uint32_t device_index, std::uint64_t test_id) {
+    ResultRecord record{};
+    record.test_id = test_id;
+    record.timestamp_us = toEpochMicros(outcome.timestamp);
+    record.value = outcome.measurement_value;
+    record.device_index = device_index;
+    record.unit = outcome.unit;
+    record.outcome = outcome.code;
+    record.passed = outcome.passed ? 1 : 0;
+    return record;
+}
+
+ResultRecord makeResultRecord(const TestResult& result, std::uint32_t device_index, std::uint64_t test_id) {
+    ResultRecord record{};
+    record.test_id = test_id;
+    record.timestamp_us = toEpochMicros(result.completed_at);
+    record.value = result.measurement_value;
+    record.device_index = device_index;
+    record.unit = unitCodeFromString(result.units);
+    record.outcome = result.outcome;
+    record.passed = result.passed ? 1 : 0;
+    return record;
+}
+
+ResultStore::ResultStore() : nextTestId(1) {}
+
+void ResultStore::reserve(size_t capacity) {
+    testIds.reserve(capacity);
+    timestamps.reserve(capacity);
+    values.reserve(capacity);
+    devices.reserve(capacity);
+    units.reserve(capacity);
+    outcomes.reserve(capacity);
+    passed.reserve(capacity);
+}
+
+void ResultStore::clear() {
+    testIds.clear();
+    timestamps.clear();
+    values.clear();
+    devices.clear();
+    units.clear();
+    outcomes.clear();
+    passed.clear();
+    deviceNames.clear();
+    deviceIndex.clear();
+    nextTestId = 1;
+}
+
+std::uint32_t ResultStore::internDevice(std::string_view device_id) {
+    auto it = deviceIndex.find(device_id);
+    if (it != deviceIndex.end()) {
+        return it->second;
+    }
+
+    auto index = static_cast<std::uint32_t>(deviceNames.size());
+    deviceNames.emplace_back(device_id);
+    deviceIndex.emplace(deviceNames.back(), index);
+    return index;
+}
+
+const std::string& ResultStore::deviceName(std::uint32_t device_index) const {
+    if (device_index >= deviceNames.size()) {
+        throw std::out_of_range("Unknown device index");
+    }
+    return deviceNames[device_index];
+}
+
+void ResultStore::append(const ResultRecord& record) {
+    testIds.push_back(record.test_id);
+    timestamps.push_back(record.timestamp_us);
+    values.push_back(record.value);
+    devices.push_back(record.device_index);
+    units.push_back(record.unit);
+    outcomes.push_back(record.outcome);
+    passed.push_back(record.passed ? 1 : 0);
+
+    if (record.test_id >= nextTestId) {
+        nextTestId = record.test_id + 1;
+    }
+}
+
+std::uint64_t ResultStore::append(std::string_view device_id, const TestOutcome& outcome) {
+    std::uint64_t test_id = nextTestId;
+    append(makeResultRecord(outcome, internDevice(device_id), test_id));
+    return test_id;
+}
+
+std::uint64_t ResultStore::append(const TestResult& result) {
+    std::uint64_t test_id = nextTestId;
+    append(makeResultRecord(result, internDevice(result.device_id), test_id));
+    return test_id;
+}
+
+ResultRecord ResultStore::record(size_t index) const {
+    ResultRecord record{};
+    record.test_id = testIds[index];
+    record.timestamp_us = timestamps[index];
+    record.value = values[index];
+    record.device_index = devices[index];
+    record.unit = units[index];
+    record.outcome = outcomes[index];
+    record.passed = passed[index];
+    return record;
+}
+
+TestResult ResultStore::toTestResult(size_t index) const {
+    auto when = fromEpochMicros(timestamps[index]);
+
+    TestResult result;
+    result.timestamp = formatTimestamp(when);
+    result.test_id = "TEST_" + result.timestamp;
+    result.device_id = deviceName(devices[index]);
+    result.passed = passed[index] != 0;
+    result.measurement_value = values[index];
+    result.units = unitCodeToString(units[index]);
+    result.outcome = outcomes[index];
+    result.notes = outcomeNote(outcomes[index]);
+    result.completed_at = when;
+    return result;
+}
+
+} // namespace MechatronicTest
@@ -0,0 +1,54 @@
+/**
+ * @file retry_policy.cpp
+ * @brief Implementation of the retry policy
+ */
+
+#include "retry_policy.h"
+#include <algorithm>
+
+namespace MechatronicTest {
+
+RetryPolicy retryPolicyFrom(const EquipmentConfig& config) {
+    RetryPolicy policy;
+    policy.max_retries = std::max(0, config.max_retry_attempts);
+    policy.initial_backoff = std::chrono::microseconds(static_cast<std::int64_t>(std::max(0.0, config.retry_backoff_ms) * 1000.0));
+    policy.max_backoff = std::max(policy.initial_backoff, std::chrono::microseconds(
+        static_cast<std::int64_t>(std::max(0.0, config.retry_max_backoff_ms) * 1000.0)));
+    policy.jitter = std::min(1.0, std::max(0.0, config.retry_jitter));
+    policy.retry_timeout = config.retry_on_timeout;
+    policy.retry_invalid = config.retry_on_invalid_response;
+    policy.retry_corrupt = config.retry_on_corrupt_response;
+    policy.retry_send = config.retry_on_send_failure;
+    return policy;
+}
+
+bool isRetryable(const RetryPolicy& policy, OutcomeCode code) {
+    switch (code) {
+        case OutcomeCode::NO_RESPONSE: return policy.retry_timeout;
+        case OutcomeCode::INVALID_RESPONSE: return policy.retry_invalid;
+        case OutcomeCode::CORRUPT_RESPONSE: return policy.retry_corrupt;
+        case OutcomeCode::SEND_FAILED: return policy.retry_send;
+        default: return false;
+    }
+}
+
+std::chrono::microseconds retryDelay(const RetryPolicy& policy, int retry, std::uint64_t& random_state) {
+    auto base = policy.initial_backoff;
+    for (int i = 1; i < retry && base < policy.max_backoff; ++i) {
+        base *= 2;
+    }
+    base = std::min(base, policy.max_backoff);
+
+    // xorshift64*: cheap, and good enough to decorrelate stations
+    if (random_state == 0) random_state = 0x9E3779B97F4A7C15ULL;
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+    double unit = static_cast<double>((random_state * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+
+    double fixed = static_cast<double>(base.count()) * (1.0 - policy.jitter);
+    double random = static_cast<double>(base.count()) * policy.jitter * unit;
+    return std::chrono::microseconds(static_cast<std::int64_t>(fixed + random));
+}
+
+} // namespace MechatronicTest
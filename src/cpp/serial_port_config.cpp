@@ -0,0 +1,154 @@
+/**
+ * @file serial_port_config.cpp
+ * @brief Implementation of serial port configuration
+ */
+
+#include "serial_port_config.h"
+#include "equipment_controller.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
+#endif
+
+namespace MechatronicTest {
+
+SerialOptions serialOptionsFrom(const EquipmentConfig& config) {
+    SerialOptions options;
+    options.baud_rate = config.baud_rate > 0 ? config.baud_rate : options.baud_rate;
+    options.low_latency = config.serial_low_latency;
+    options.vmin = config.serial_vmin;
+    options.vtime_ds = config.serial_vtime_ds;
+    options.sync_writes = config.serial_sync_writes;
+    return options;
+}
+
+#ifndef _WIN32
+
+namespace {
+
+struct BaudConstant {
+    int rate;
+    speed_t constant;
+};
+
+const BaudConstant BAUD_CONSTANTS[] = {
+    {1200, B1200}, {2400, B2400}, {4800, B4800}, {9600, B9600}, {19200, B19200},
+    {38400, B38400}, {57600, B57600}, {115200, B115200}, {230400, B230400},
+#ifdef B460800
+    {460800, B460800},
+#endif
+#ifdef B500000
+    {500000, B500000},
+#endif
+#ifdef B576000
+    {576000, B576000},
+#endif
+#ifdef B921600
+    {921600, B921600},
+#endif
+#ifdef B1000000
+    {1000000, B1000000},
+#endif
+#ifdef B1152000
+    {1152000, B1152000},
+#endif
+#ifdef B1500000
+    {1500000, B1500000},
+#endif
+#ifdef B2000000
+    {2000000, B2000000},
+#endif
+#ifdef B2500000
+    {2500000, B2500000},
+#endif
+#ifdef B3000000
+    {3000000, B3000000},
+#endif
+#ifdef B3500000
+    {3500000, B3500000},
+#endif
+#ifdef B4000000
+    {4000000, B4000000},
+#endif
+};
+
+bool standardBaud(int rate, speed_t& constant) {
+    for (const auto& entry : BAUD_CONSTANTS) {
+        if (entry.rate == rate) {
+            constant = entry.constant;
+            return true;
+        }
+    }
+    return false;
+}
+
+void enableLowLatency(int fd) {
+#if defined(__linux__) && defined(ASYNC_LOW_LATENCY)
+    // FTDI and similar drivers otherwise hold received bytes for up to 16 ms
+    struct serial_struct serial;
+    if (ioctl(fd, TIOCGSERIAL, &serial) == 0) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        ioctl(fd, TIOCSSERIAL, &serial);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+unsigned char clampControlChar(int value) {
+    return static_cast<unsigned char>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+} // namespace
+
+int serialOpenFlags(const SerialOptions& options) {
+    return O_RDWR | O_NOCTTY | (options.sync_writes ? O_SYNC : 0);
+}
+
+bool configureSerialPort(int fd, const SerialOptions& options) {
+    struct termios tty;
+    if (tcgetattr(fd, &tty) != 0) {
+        return false;
+    }
+
+    speed_t speed = B115200;
+    bool custom = !standardBaud(options.baud_rate, speed);
+    if (custom) {
+        speed = B38400;  // Placeholder; replaced by the custom rate below
+    }
+    cfsetospeed(&tty, speed);
+    cfsetispeed(&tty, speed);
+
+    tty.c_cflag = (tty.c_cflag & ~CSIZE) | CS8;
+    tty.c_iflag &= ~IGNBRK;
+    tty.c_lflag = 0;
+    tty.c_oflag = 0;
+    tty.c_cc[VMIN] = clampControlChar(options.vmin);
+    tty.c_cc[VTIME] = clampControlChar(options.vtime_ds);
+
+    tty.c_iflag &= ~(IXON | IXOFF | IXANY);
+    tty.c_cflag |= (CLOCAL | CREAD);
+    tty.c_cflag &= ~(PARENB | PARODD);
+    tty.c_cflag &= ~CSTOPB;
+    tty.c_cflag &= ~CRTSCTS;
+
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+        return false;
+    }
+    if (custom && !setCustomBaudRate(fd, options.baud_rate)) {
+        return false;
+    }
+    if (options.low_latency) {
+        enableLowLatency(fd);
+    }
+    return true;
+}
+
+#endif // _WIN32
+
+} // namespace MechatronicTest
@@ -0,0 +1,55 @@
+/**
+ * @file serial_termios2.cpp
+ * @brief Custom baud rates through the Linux termios2 interface
+ *
+ * Kept apart from serial_port_config.cpp because <asm/termbits.h>, which
+ * defines struct termios2, conflicts with <termios.h>.
+ */
+
+#include "serial_port_config.h"
+
+#ifndef _WIN32
+
+#if defined(__linux__)
+#include <asm/ioctls.h>
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+#endif
+
+namespace MechatronicTest {
+
+bool setCustomBaudRate(int fd, int baud_rate) {
+#if defined(__linux__) && defined(TCGETS2) && defined(BOTHER)
+    if (baud_rate <= 0) {
+        return false;
+    }
+    struct termios2 tio;
+    if (ioctl(fd, TCGETS2, &tio) != 0) {
+        return false;
+    }
+    tio.c_cflag &= ~CBAUD;
+    tio.c_cflag |= BOTHER;
+    tio.c_ispeed = static_cast<speed_t>(baud_rate);
+    tio.c_ospeed = static_cast<speed_t>(baud_rate);
+    tio.c_cflag &= ~(CBAUD << IBSHIFT);
+    tio.c_cflag |= BOTHER << IBSHIFT;
+    if (ioctl(fd, TCSETS2, &tio) != 0) {
+        return false;
+    }
+    // Drivers round to the nearest divisor; reject anything more than 2% off
+    if (ioctl(fd, TCGETS2, &tio) != 0) {
+        return false;
+    }
+    long actual = static_cast<long>(tio.c_ospeed);
+    long error = actual > baud_rate ? actual - baud_rate : baud_rate - actual;
+    return error * 50 <= baud_rate;
+#else
+    (void)fd;
+    (void)baud_rate;
+    return false;
+#endif
+}
+
+} // namespace MechatronicTest
+
+#endif // _WIN32
@@ -0,0 +1,433 @@
+/**
+ * @file simulated_interface.cpp
+ * @brief Implementation of the simulated hardware interface
+ */
+
+#include "simulated_interface.h"
+#include "binary_protocol.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace MechatronicTest {
+
+namespace {
+
+bool parseNumber(std::string_view text, double& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+bool parseDistribution(std::string_view text, LatencyDistribution& distribution) {
+    if (text == "fixed") distribution = LatencyDistribution::FIXED;
+    else if (text == "uniform") distribution = LatencyDistribution::UNIFORM;
+    else if (text == "normal") distribution = LatencyDistribution::NORMAL;
+    else if (text == "exponential") distribution = LatencyDistribution::EXPONENTIAL;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief First numeric field, e.g. 5.0 in "voltage:5.0"; fallback if none
+ */
+double expectedValue(std::string_view params, double fallback) {
+    while (!params.empty()) {
+        size_t colon = params.find(':');
+        double number;
+        if (parseNumber(params.substr(0, colon), number)) {
+            return number;
+        }
+        params = colon == std::string_view::npos ? std::string_view() : params.substr(colon + 1);
+    }
+    return fallback;
+}
+
+double expectedValue(const std::vector<std::string_view>& fields, size_t first, double fallback) {
+    for (size_t i = first; i < fields.size(); ++i) {
+        double number;
+        if (parseNumber(fields[i], number)) {
+            return number;
+        }
+    }
+    return fallback;
+}
+
+} // namespace
+
+bool parseSimulationModel(std::string_view spec, SimulationModel& model) {
+    while (!spec.empty()) {
+        size_t comma = spec.find(',');
+        std::string_view entry = spec.substr(0, comma);
+        spec = comma == std::string_view::npos ? std::string_view() : spec.substr(comma + 1);
+        if (entry.empty()) continue;
+
+        size_t equals = entry.find('=');
+        if (equals == std::string_view::npos) return false;
+        std::string_view key = entry.substr(0, equals);
+        std::string_view value = entry.substr(equals + 1);
+
+        if (key == "distribution") {
+            if (!parseDistribution(value, model.distribution)) return false;
+            continue;
+        }
+        if (key == "units") {
+            model.units.assign(value.data(), value.size());
+            continue;
+        }
+
+        double number = 0.0;
+        if (!parseNumber(value, number)) return false;
+        if (key == "latency_us") model.latency_us = number;
+        else if (key == "latency_jitter_us") model.latency_jitter_us = number;
+        else if (key == "max_commands_per_second") model.max_commands_per_second = number;
+        else if (key == "drop_rate") model.drop_rate = number;
+        else if (key == "corrupt_rate") model.corrupt_rate = number;
+        else if (key == "fail_rate") model.fail_rate = number;
+        else if (key == "nominal_value") model.nominal_value = number;
+        else if (key == "value_noise") model.value_noise = number;
+        else if (key == "calibration_ms") model.calibration_ms = number;
+        else if (key == "channels") model.channels = static_cast<int>(number);
+        else if (key == "channel_step") model.channel_step = number;
+        else if (key == "stream_rate_hz") model.stream_rate_hz = number;
+        else if (key == "stream_frame_samples") model.stream_frame_samples = static_cast<int>(number);
+        else if (key == "stream_amplitude") model.stream_amplitude = number;
+        else if (key == "stream_frequency_hz") model.stream_frequency_hz = number;
+        else if (key == "seed") model.seed = static_cast<std::uint32_t>(number);
+        else return false;
+    }
+    return true;
+}
+
+SimulatedInterface::SimulatedInterface(const SimulationModel& simulation_model)
+    : model(simulation_model), random(simulation_model.seed), connected(false), replyOffset(0), commands(0),
+      binary(false), streaming(false), streamFrames(0), streamLevel(0.0) {}
+
+bool SimulatedInterface::connect(const std::string& port, int baud_rate) {
+    (void)baud_rate;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (port.find('=') != std::string::npos && !parseSimulationModel(port, model)) {
+        return false;
+    }
+
+    random.seed(model.seed);
+    replies.clear();
+    replyOffset = 0;
+    deviceFreeAt = lastReplyAt = Clock::now();
+    commands = 0;
+    binary = false;
+    streaming = false;
+    rawInput.clear();
+    resetReceiveBuffer();
+    connected = true;
+    return true;
+}
+
+bool SimulatedInterface::disconnect() {
+    std::lock_guard<std::mutex> lock(mutex);
+    connected = false;
+    streaming = false;
+    replies.clear();
+    replyOffset = 0;
+    replyReady.notify_all();
+    return true;
+}
+
+bool SimulatedInterface::isConnected() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return connected;
+}
+
+void SimulatedInterface::setModel(const SimulationModel& simulation_model) {
+    std::lock_guard<std::mutex> lock(mutex);
+    model = simulation_model;
+}
+
+SimulationModel SimulatedInterface::getModel() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return model;
+}
+
+std::uint64_t SimulatedInterface::commandsReceived() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return commands;
+}
+
+bool SimulatedInterface::sendCommand(const std::string& command) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!connected) return false;
+    countSent(command.size() + 2);  // As if terminated with "\r\n" on the wire
+    ++commands;
+
+    // "#<seq>:" tags are echoed on every reply to the command
+    std::string_view line = command;
+    std::string_view tag;
+    if (!line.empty() && line.front() == '#') {
+        size_t colon = line.find(':');
+        if (colon != std::string_view::npos) {
+            tag = line.substr(0, colon + 1);
+            line.remove_prefix(colon + 1);
+        }
+    }
+
+    std::string reply;
+    if (line == BINARY_PROTOCOL_REQUEST) {
+        reply.assign(BINARY_PROTOCOL_ACK.data(), BINARY_PROTOCOL_ACK.size());
+        reply += "\r\n";
+        schedule(std::move(reply), 0.0);
+        binary = true;
+    } else if (line == "CALIBRATE") {
+        reply.append(tag.data(), tag.size());
+        reply += "CAL_OK\r\n";
+        schedule(std::move(reply), model.calibration_ms * 1000.0);
+    } else if (line.rfind("TEST:", 0) == 0) {
+        std::string_view rest = line.substr(5);
+        size_t colon = rest.find(':');
+        std::string_view params = colon == std::string_view::npos ? std::string_view() : rest.substr(colon + 1);
+        handleTest(tag, 0, expectedValue(params, model.nominal_value), reply);
+        schedule(std::move(reply), 0.0);
+    } else if (line.rfind("BATCH:", 0) == 0) {
+        std::string_view rest = line.substr(6);
+        size_t colon = rest.find(':');
+        std::string_view devices = rest.substr(0, colon);
+        std::string_view params = colon == std::string_view::npos ? std::string_view() : rest.substr(colon + 1);
+        size_t count = static_cast<size_t>(std::count(devices.begin(), devices.end(), ',')) + 1;
+        double expected = expectedValue(params, model.nominal_value);
+        for (size_t i = 0; i < count; ++i) {
+            reply.clear();
+            handleTest(tag, 0, expected, reply);
+            schedule(std::move(reply), 0.0);
+        }
+    } else if (line == "STREAM:STOP") {
+        streaming = false;
+        reply = "STREAM:END:" + std::to_string(streamFrames) + "\r\n";
+        schedule(std::move(reply), 0.0);
+    } else if (line.rfind("STREAM:", 0) == 0 && !streaming) {
+        std::string_view rest = line.substr(7);
+        size_t colon = rest.find(':');
+        std::string_view params = colon == std::string_view::npos ? std::string_view() : rest.substr(colon + 1);
+        schedule("STREAM:OK\r\n", 0.0);
+        streaming = true;
+        streamStart = lastReplyAt;
+        streamFrames = 0;
+        streamLevel = expectedValue(params, model.nominal_value);
+    } else {
+        reply.append(tag.data(), tag.size());
+        reply += "ERROR:UNKNOWN_COMMAND\r\n";
+        schedule(std::move(reply), 0.0);
+    }
+    return true;
+}
+
+bool SimulatedInterface::sendRaw(const char* data, size_t length) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!connected || !binary) return false;
+    countSent(length);
+
+    rawInput.append(data, length);
+    size_t start = 0;
+    size_t delimiter;
+    while ((delimiter = rawInput.find('\0', start)) != std::string::npos) {
+        if (delimiter > start) {
+            ++commands;
+            handleBinaryFrame(std::string_view(rawInput).substr(start, delimiter - start));
+        }
+        start = delimiter + 1;
+    }
+    rawInput.erase(0, start);
+    return true;
+}
+
+void SimulatedInterface::handleBinaryFrame(std::string_view encoded) {
+    std::string reply;
+    BinaryFrame frame;
+    std::vector<std::string_view> fields;
+    if (decodeBinaryFrame(encoded, frame) != BinaryDecodeStatus::OK) {
+        appendBinaryFrame(reply, BinaryOpcode::ERROR, 0, nullptr, 0);
+        schedule(std::move(reply), 0.0);
+        return;
+    }
+
+    switch (frame.opcode) {
+        case BinaryOpcode::TEST:
+            if (splitBinaryFields(frame, 0, fields) && !fields.empty()) {
+                handleTest({}, frame.sequence, expectedValue(fields, 1, model.nominal_value), reply);
+                schedule(std::move(reply), 0.0);
+                return;
+            }
+            break;
+        case BinaryOpcode::BATCH:
+            if (frame.length > 0 && splitBinaryFields(frame, 1, fields) && fields.size() >= frame.payload[0]) {
+                double expected = expectedValue(fields, frame.payload[0], model.nominal_value);
+                for (int i = 0; i < frame.payload[0]; ++i) {
+                    reply.clear();
+                    handleTest({}, frame.sequence, expected, reply);
+                    schedule(std::move(reply), 0.0);
+                }
+                return;
+            }
+            break;
+        case BinaryOpcode::CALIBRATE:
+            appendBinaryFrame(reply, BinaryOpcode::CALIBRATED, frame.sequence, nullptr, 0);
+            schedule(std::move(reply), model.calibration_ms * 1000.0);
+            return;
+        default:
+            break;
+    }
+    appendBinaryFrame(reply, BinaryOpcode::ERROR, frame.sequence, nullptr, 0);
+    schedule(std::move(reply), 0.0);
+}
+
+void SimulatedInterface::handleTest(std::string_view tag, std::uint16_t sequence, double expected, std::string& out) {
+    if (chance(model.drop_rate)) {
+        return;
+    }
+    bool corrupt = chance(model.corrupt_rate);
+    readings.resize(static_cast<size_t>(std::max(1, model.channels)));
+    for (size_t i = 0; i < readings.size(); ++i) {
+        readings[i] = expected + static_cast<double>(i) * model.channel_step;
+        if (model.value_noise > 0.0) {
+            readings[i] += std::normal_distribution<double>(0.0, model.value_noise)(random);
+        }
+    }
+    bool passed = !chance(model.fail_rate);
+
+    if (binary) {
+        if (readings.size() > 1) {
+            appendChannelFrames(out, sequence, readings.data(), readings.size());
+        }
+        size_t result = out.size();
+        appendResultFrame(out, sequence, static_cast<float>(readings[0]), unitCodeFromString(model.units), passed);
+        if (corrupt) {
+            // Damage a payload byte of the RESULT; never 0x00, so the frame boundary survives
+            char& damaged = out[result + 3];
+            damaged = static_cast<char>(damaged == 0x5A ? 0xA5 : 0x5A);
+        }
+        return;
+    }
+
+    out.append(tag.data(), tag.size());
+    if (corrupt) {
+        out += "RESULT:#garbled#\r\n";
+        return;
+    }
+    out += "RESULT:";
+    char number[32];
+    for (size_t i = 0; i < readings.size(); ++i) {
+        if (i > 0) out += ',';
+        int length = std::snprintf(number, sizeof(number), "%.6g", readings[i]);
+        out.append(number, static_cast<size_t>(std::max(0, std::min(length, static_cast<int>(sizeof(number)) - 1))));
+    }
+    out += ':';
+    out.append(model.units, 0, 16);
+    out += passed ? ":PASS\r\n" : ":FAIL\r\n";
+}
+
+void SimulatedInterface::schedule(std::string bytes, double extra_us) {
+    // The device works through commands one at a time, then replies after its latency
+    auto now = Clock::now();
+    auto start = std::max(now, deviceFreeAt);
+    if (model.max_commands_per_second > 0.0) {
+        deviceFreeAt = start + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / model.max_commands_per_second));
+    } else {
+        deviceFreeAt = start;
+    }
+
+    auto delay = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::micro>(sampleLatencyUs() + extra_us));
+    lastReplyAt = std::max(lastReplyAt, deviceFreeAt + delay);
+
+    if (!bytes.empty()) {
+        replies.push_back({lastReplyAt, std::move(bytes)});
+        replyReady.notify_all();
+    }
+}
+
+void SimulatedInterface::queueStreamFrame() {
+    // Frames are generated one at a time as they are read, so a long stream costs no memory
+    size_t count = static_cast<size_t>(std::max(1, model.stream_frame_samples));
+    double rate = model.stream_rate_hz > 0.0 ? model.stream_rate_hz : 1.0;
+    std::uint64_t first = streamFrames * count;
+    Clock::time_point ready = streamStart + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(first + count) / rate));
+
+    std::string bytes = "DATA:" + std::to_string(streamFrames) + ":";
+    char number[32];
+    for (size_t i = 0; i < count; ++i) {
+        double t = static_cast<double>(first + i) / rate;
+        double sample = streamLevel + model.stream_amplitude * std::sin(2.0 * 3.14159265358979323846 * model.stream_frequency_hz * t);
+        if (model.value_noise > 0.0) {
+            sample += std::normal_distribution<double>(0.0, model.value_noise)(random);
+        }
+        if (i > 0) bytes += ',';
+        int length = std::snprintf(number, sizeof(number), "%.6g", sample);
+        bytes.append(number, static_cast<size_t>(std::max(0, std::min(length, static_cast<int>(sizeof(number)) - 1))));
+    }
+    bytes += "\r\n";
+
+    ++streamFrames;
+    lastReplyAt = std::max(lastReplyAt, ready);
+    replies.push_back({ready, std::move(bytes)});
+}
+
+double SimulatedInterface::sampleLatencyUs() {
+    double mean = model.latency_us;
+    double spread = model.latency_jitter_us;
+    double sample = mean;
+    switch (model.distribution) {
+        case LatencyDistribution::FIXED:
+            break;
+        case LatencyDistribution::UNIFORM:
+            if (spread > 0.0) sample = std::uniform_real_distribution<double>(mean - spread, mean + spread)(random);
+            break;
+        case LatencyDistribution::NORMAL:
+            if (spread > 0.0) sample = std::normal_distribution<double>(mean, spread)(random);
+            break;
+        case LatencyDistribution::EXPONENTIAL:
+            if (mean > 0.0) sample = std::exponential_distribution<double>(1.0 / mean)(random);
+            break;
+    }
+    return std::max(0.0, sample);
+}
+
+bool SimulatedInterface::chance(double probability) {
+    return probability > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(random) < probability;
+}
+
+long SimulatedInterface::readAvailable(char* buffer, size_t length, int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    while (true) {
+        if (!connected) return -1;
+        if (streaming && replies.empty()) {
+            queueStreamFrame();
+        }
+
+        auto now = Clock::now();
+        if (!replies.empty() && replies.front().ready <= now) {
+            size_t copied = 0;
+            while (copied < length && !replies.empty() && replies.front().ready <= now) {
+                const std::string& bytes = replies.front().bytes;
+                size_t chunk = std::min(length - copied, bytes.size() - replyOffset);
+                std::memcpy(buffer + copied, bytes.data() + replyOffset, chunk);
+                copied += chunk;
+                replyOffset += chunk;
+                if (replyOffset == bytes.size()) {
+                    replies.pop_front();
+                    replyOffset = 0;
+                }
+            }
+            return static_cast<long>(copied);
+        }
+        if (now >= deadline) return 0;
+
+        auto wake = replies.empty() ? deadline : std::min(deadline, replies.front().ready);
+        replyReady.wait_until(lock, wake);
+    }
+}
+
+} // namespace MechatronicTest
@@ -0,0 +1,272 @@
+/**
+ * @file spc_monitor.cpp
+ * @brief Implementation of online statistics and control-chart rules
+ */
+
+#include "spc_monitor.h"
+#include "equipment_controller.h"
+#include "limit_check.h"
+#include <algorithm>
+#include <cmath>
+
+namespace MechatronicTest {
+
+namespace {
+
+int hits(unsigned bits) {
+    int count = 0;
+    for (; bits != 0; bits &= bits - 1) ++count;
+    return count;
+}
+
+void shiftIn(std::uint8_t& bits, bool hit) {
+    bits = static_cast<std::uint8_t>((bits << 1) | (hit ? 1 : 0));
+}
+
+} // namespace
+
+P2Quantile::P2Quantile(double quantile)
+    : p(std::min(1.0, std::max(0.0, quantile))), count(0), heights{},
+      positions{0.0, 1.0, 2.0, 3.0, 4.0},
+      desired{0.0, 2.0 * p, 4.0 * p, 2.0 + 2.0 * p, 4.0},
+      increments{0.0, p / 2.0, p, (1.0 + p) / 2.0, 1.0} {}
+
+void P2Quantile::add(double sample) {
+    if (count < 5) {
+        heights[count++] = sample;
+        if (count == 5) std::sort(heights, heights + 5);
+        return;
+    }
+
+    // Find the cell the sample falls in, stretching the extremes if needed
+    int cell;
+    if (sample < heights[0]) {
+        heights[0] = sample;
+        cell = 0;
+    } else if (sample >= heights[4]) {
+        heights[4] = sample;
+        cell = 3;
+    } else {
+        cell = 0;
+        while (sample >= heights[cell + 1]) ++cell;
+    }
+    for (int i = cell + 1; i < 5; ++i) positions[i] += 1.0;
+    for (int i = 0; i < 5; ++i) desired[i] += increments[i];
+    ++count;
+
+    // Move the middle markers one position toward where they should be
+    for (int i = 1; i < 4; ++i) {
+        double offset = desired[i] - positions[i];
+        if ((offset >= 1.0 && positions[i + 1] - positions[i] > 1.0) ||
+            (offset <= -1.0 && positions[i - 1] - positions[i] < -1.0)) {
+            int step = offset >= 0.0 ? 1 : -1;
+            double height = parabolic(i, step);
+            if (!(heights[i - 1] < height && height < heights[i + 1])) {
+                height = linear(i, step);
+            }
+            heights[i] = height;
+            positions[i] += step;
+        }
+    }
+}
+
+double P2Quantile::parabolic(int i, double d) const {
+    return heights[i] + d / (positions[i + 1] - positions[i - 1]) *
+           ((positions[i] - positions[i - 1] + d) * (heights[i + 1] - heights[i]) / (positions[i + 1] - positions[i]) +
+            (positions[i + 1] - positions[i] - d) * (heights[i] - heights[i - 1]) / (positions[i] - positions[i - 1]));
+}
+
+double P2Quantile::linear(int i, int d) const {
+    return heights[i] + d * (heights[i + d] - heights[i]) / (positions[i + d] - positions[i]);
+}
+
+double P2Quantile::value() const {
+    if (count == 0) return 0.0;
+    if (count >= 5) return heights[2];
+    double sorted[5];
+    std::copy(heights, heights + count, sorted);
+    std::sort(sorted, sorted + count);
+    return sorted[static_cast<size_t>(std::lround(p * static_cast<double>(count - 1)))];
+}
+
+const char* spcRuleName(SpcRule rule) {
+    switch (rule) {
+        case SpcRule::NONE: return "In control";
+        case SpcRule::BEYOND_3_SIGMA: return "Beyond 3 sigma";
+        case SpcRule::TWO_OF_THREE_BEYOND_2_SIGMA: return "2 of 3 beyond 2 sigma";
+        case SpcRule::FOUR_OF_FIVE_BEYOND_1_SIGMA: return "4 of 5 beyond 1 sigma";
+        case SpcRule::EIGHT_ON_ONE_SIDE: return "8 on one side of center";
+    }
+    return "?";
+}
+
+SpcOptions spcOptionsFrom(const EquipmentConfig& config) {
+    SpcOptions options;
+    options.enabled = config.spc_enabled;
+    options.baseline_samples = static_cast<std::uint64_t>(std::max(2, config.spc_baseline_samples));
+    ChannelLimits limits = channelLimitsFrom(config);
+    if (!limits.empty()) {
+        options.lower_spec = limits.lower[0];
+        options.upper_spec = limits.upper[0];
+    }
+    return options;
+}
+
+SpcMonitor::SpcMonitor(const SpcOptions& spc_options) : options(spc_options) {}
+
+void SpcMonitor::reset(const SpcOptions& spc_options) {
+    std::lock_guard<std::mutex> lock(mutex);
+    options = spc_options;
+    entries.clear();
+}
+
+void SpcMonitor::setAlarmCallback(SpcAlarmCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    alarmCallback = std::move(callback);
+}
+
+SpcMonitor::Entry* SpcMonitor::find(std::string_view device_type, std::string_view test) {
+    for (auto& candidate : entries) {
+        if (candidate.device_type == device_type && candidate.test == test) {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+
+const SpcMonitor::Entry* SpcMonitor::find(std::string_view device_type, std::string_view test) const {
+    return const_cast<SpcMonitor*>(this)->find(device_type, test);
+}
+
+SpcRule SpcMonitor::record(std::string_view device_type, std::string_view test, double value) {
+    if (!std::isfinite(value)) return SpcRule::NONE;
+
+    SpcAlarm alarm;
+    SpcAlarmCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!options.enabled) return SpcRule::NONE;
+        Entry* e = find(device_type, test);
+        if (!e) {
+            if (entries.size() >= options.max_keys) return SpcRule::NONE;
+            entries.emplace_back();
+            e = &entries.back();
+            e->device_type.assign(device_type.data(), device_type.size());
+            e->test.assign(test.data(), test.size());
+            e->min = e->max = value;
+        }
+
+        // Welford's update
+        ++e->samples;
+        double delta = value - e->mean;
+        e->mean += delta / static_cast<double>(e->samples);
+        e->m2 += delta * (value - e->mean);
+        e->min = std::min(e->min, value);
+        e->max = std::max(e->max, value);
+        e->p01.add(value);
+        e->p50.add(value);
+        e->p99.add(value);
+
+        if (!e->baselined) {
+            if (e->samples >= std::max<std::uint64_t>(2, options.baseline_samples)) {
+                e->center = e->mean;
+                e->sigma = std::sqrt(e->m2 / static_cast<double>(e->samples - 1));
+                e->baselined = true;
+            }
+            return SpcRule::NONE;
+        }
+
+        double deviation = value - e->center;
+        double z = e->sigma > 0.0 ? deviation / e->sigma
+                 : deviation == 0.0 ? 0.0 : std::copysign(std::numeric_limits<double>::infinity(), deviation);
+        SpcRule rule = check(*e, z);
+        if (rule == SpcRule::NONE) return rule;
+
+        ++e->alarms;
+        e->lastRule = rule;
+        e->lastAlarm = e->samples;
+        if (!alarmCallback) return rule;
+        callback = alarmCallback;
+        alarm.device_type = e->device_type;
+        alarm.test = e->test;
+        alarm.rule = rule;
+        alarm.value = value;
+        alarm.z = z;
+        alarm.sample = e->samples;
+    }
+    callback(alarm);
+    return alarm.rule;
+}
+
+SpcRule SpcMonitor::check(Entry& e, double z) {
+    shiftIn(e.above2, z > 2.0);
+    shiftIn(e.below2, z < -2.0);
+    shiftIn(e.above1, z > 1.0);
+    shiftIn(e.below1, z < -1.0);
+    e.run = z > 0.0 ? std::max<std::int64_t>(e.run, 0) + 1
+          : z < 0.0 ? std::min<std::int64_t>(e.run, 0) - 1 : 0;
+
+    // Rules 2 and 3 fire on the sample that completes the pattern
+    if (std::abs(z) > 3.0) return SpcRule::BEYOND_3_SIGMA;
+    if (((e.above2 & 1) && hits(e.above2 & 0x07u) >= 2) || ((e.below2 & 1) && hits(e.below2 & 0x07u) >= 2)) {
+        return SpcRule::TWO_OF_THREE_BEYOND_2_SIGMA;
+    }
+    if (((e.above1 & 1) && hits(e.above1 & 0x1Fu) >= 4) || ((e.below1 & 1) && hits(e.below1 & 0x1Fu) >= 4)) {
+        return SpcRule::FOUR_OF_FIVE_BEYOND_1_SIGMA;
+    }
+    if (e.run >= 8 || e.run <= -8) return SpcRule::EIGHT_ON_ONE_SIDE;
+    return SpcRule::NONE;
+}
+
+SpcStats SpcMonitor::statsOf(const Entry& e) const {
+    SpcStats stats;
+    stats.device_type = e.device_type;
+    stats.test = e.test;
+    stats.samples = e.samples;
+    stats.mean = e.mean;
+    stats.stddev = e.samples > 1 ? std::sqrt(e.m2 / static_cast<double>(e.samples - 1)) : 0.0;
+    stats.min = e.min;
+    stats.max = e.max;
+    stats.p01 = e.p01.value();
+    stats.p50 = e.p50.value();
+    stats.p99 = e.p99.value();
+    stats.center = e.baselined ? e.center : 0.0;
+    stats.sigma = e.baselined ? e.sigma : 0.0;
+
+    constexpr double none = std::numeric_limits<double>::quiet_NaN();
+    bool lower = std::isfinite(options.lower_spec);
+    bool upper = std::isfinite(options.upper_spec);
+    double spread = 3.0 * stats.stddev;
+    stats.cp = lower && upper && spread > 0.0 ? (options.upper_spec - options.lower_spec) / (2.0 * spread) : none;
+    if (spread <= 0.0 || (!lower && !upper)) {
+        stats.cpk = none;
+    } else {
+        double toUpper = upper ? (options.upper_spec - e.mean) / spread : std::numeric_limits<double>::infinity();
+        double toLower = lower ? (e.mean - options.lower_spec) / spread : std::numeric_limits<double>::infinity();
+        stats.cpk = std::min(toUpper, toLower);
+    }
+    stats.alarms = e.alarms;
+    stats.last_rule = e.lastRule;
+    stats.last_alarm_sample = e.lastAlarm;
+    return stats;
+}
+
+bool SpcMonitor::stats(std::string_view device_type, std::string_view test, SpcStats& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const Entry* e = find(device_type, test);
+    if (!e) return false;
+    out = statsOf(*e);
+    return true;
+}
+
+std::vector<SpcStats> SpcMonitor::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<SpcStats> result;
+    result.reserve(entries.size());
+    for (const auto& e : entries) {
+        result.push_back(statsOf(e));
+    }
+    return result;
+}
+
+} // namespace MechatronicTest
@@ -0,0 +1,273 @@
+/**
+ * @file station_pool.cpp
+ * @brief Implementation of the multi-station test executor
+ */
+
+#include "station_pool.h"
+#include <algorithm>
+#include <chrono>
+
+namespace MechatronicTest {
+
+StationPool::StationPool()
+    : running(false), nextStation(0), outstanding(0), submittedCount(0),
+      passedCount(0), failedCount(0), stolenCount(0), abandonedCount(0) {}
+
+StationPool::~StationPool() {
+    stop();
+}
+
+size_t StationPool::addStation(std::unique_ptr<EquipmentController> controller) {
+    if (running || !controller) {
+        return ANY_STATION;
+    }
+
+    auto station = std::make_unique<Station>();
+    station->controller = std::move(controller);
+    stations.push_back(std::move(station));
+    return stations.size() - 1;
+}
+
+size_t StationPool::addStation(const EquipmentConfig& config) {
+    auto controller = std::make_unique<EquipmentController>();
+    controller->initialize(config);
+    return addStation(std::move(controller));
+}
+
+size_t StationPool::stationCount() const {
+    return stations.size();
+}
+
+EquipmentController& StationPool::station(size_t index) {
+    return *stations.at(index)->controller;
+}
+
+bool StationPool::isStationActive(size_t index) const {
+    return index < stations.size() && stations[index]->active;
+}
+
+bool StationPool::start() {
+    if (running) {
+        return true;
+    }
+
+    bool anyActive = false;
+    for (auto& station : stations) {
+        EquipmentController& controller = *station->controller;
+        station->active = controller.isConnected() &&
+                          (controller.start() || controller.getStatus() == EquipmentStatus::RUNNING);
+        anyActive = anyActive || station->active;
+    }
+    if (!anyActive) {
+        return false;
+    }
+
+    running = true;
+    for (size_t i = 0; i < stations.size(); ++i) {
+        if (stations[i]->active) {
+            stations[i]->worker = std::thread(&StationPool::workerLoop, this, i);
+        }
+    }
+    return true;
+}
+
+void StationPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        running = false;
+    }
+    wakeCondition.notify_all();
+
+    for (auto& station : stations) {
+        if (station->worker.joinable()) {
+            station->worker.join();
+        }
+    }
+
+    // Anything still queued will never run; report it so waiters are released, but do not count it as completed
+    for (size_t i = 0; i < stations.size(); ++i) {
+        std::deque<Job> abandoned;
+        {
+            std::lock_guard<std::mutex> lock(stations[i]->queueMutex);
+            abandoned.swap(stations[i]->queue);
+        }
+        for (auto& job : abandoned) {
+            TestResult result;
+            result.device_id = job.device_id;
+            result.passed = false;
+            result.measurement_value = 0.0;
+            result.outcome = OutcomeCode::NOT_RUNNING;
+            result.notes = "Station pool stopped";
+            abandonedCount.fetch_add(1, std::memory_order_relaxed);
+            deliver(i, job, result);
+        }
+
+        if (stations[i]->active) {
+            stations[i]->controller->stop();
+            stations[i]->active = false;
+        }
+    }
+}
+
+bool StationPool::submit(const std::string& device_id, const std::vector<std::string>& test_parameters,
+                         PoolCallback callback, size_t station, bool pinned) {
+    if (!running || stations.empty()) {
+        return false;
+    }
+
+    size_t target = station;
+    if (target == ANY_STATION) {
+        pinned = false;
+        for (size_t attempt = 0; attempt < stations.size(); ++attempt) {
+            size_t candidate = nextStation.fetch_add(1, std::memory_order_relaxed) % stations.size();
+            if (stations[candidate]->active) {
+                target = candidate;
+                break;
+            }
+        }
+        if (target == ANY_STATION) {
+            return false;
+        }
+    } else if (target >= stations.size() || !stations[target]->active) {
+        return false;
+    }
+
+    {
+        // Holding wakeMutex orders the push against stop() draining the queues
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        if (!running) {
+            return false;
+        }
+        ++outstanding;
+
+        std::lock_guard<std::mutex> queueLock(stations[target]->queueMutex);
+        stations[target]->queue.push_back({device_id, test_parameters, std::move(callback), pinned});
+    }
+    submittedCount.fetch_add(1, std::memory_order_relaxed);
+
+    // Wake every worker so idle stations can steal
+    wakeCondition.notify_all();
+    return true;
+}
+
+void StationPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (outstanding != 0) {
+        idleCondition.wait_for(lock, std::chrono::milliseconds(100));
+    }
+}
+
+std::vector<TestResult> StationPool::takeResults() {
+    std::lock_guard<std::mutex> lock(resultsMutex);
+    std::vector<TestResult> taken;
+    taken.swap(results);
+    return taken;
+}
+
+PoolSummary StationPool::getSummary() const {
+    PoolSummary summary;
+    summary.submitted = submittedCount.load(std::memory_order_relaxed);
+    summary.passed = passedCount.load(std::memory_order_relaxed);
+    summary.failed = failedCount.load(std::memory_order_relaxed);
+    summary.completed = summary.passed + summary.failed;
+    summary.stolen = stolenCount.load(std::memory_order_relaxed);
+    summary.abandoned = abandonedCount.load(std::memory_order_relaxed);
+    summary.station_completed.reserve(stations.size());
+    for (const auto& station : stations) {
+        summary.station_completed.push_back(station->completed.load(std::memory_order_relaxed));
+    }
+    return summary;
+}
+
+void StationPool::workerLoop(size_t index) {
+    EquipmentController& controller = *stations[index]->controller;
+
+    // Checked before every job, so stop() leaves the rest of the queue unrun
+    while (running) {
+        Job job;
+        bool stolen = false;
+        if (takeJob(index, job, stolen)) {
+            if (stolen) {
+                stolenCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            TestResult result = controller.runTest(job.device_id, job.test_parameters);
+            finishJob(index, job, result);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        if (!running) {
+            break;
+        }
+        // Re-check queues periodically in case a wakeup raced with takeJob()
+        wakeCondition.wait_for(lock, std::chrono::milliseconds(20));
+        if (!running) {
+            break;
+        }
+    }
+}
+
+bool StationPool::takeJob(size_t index, Job& job, bool& stolen) {
+    {
+        Station& own = *stations[index];
+        std::lock_guard<std::mutex> lock(own.queueMutex);
+        if (!own.queue.empty()) {
+            job = std::move(own.queue.front());
+            own.queue.pop_front();
+            stolen = false;
+            return true;
+        }
+    }
+
+    // Pick the other queue with the most unpinned jobs as the victim; pinned ones never move
+    size_t victim = ANY_STATION;
+    size_t most = 0;
+    for (size_t i = 0; i < stations.size(); ++i) {
+        if (i == index) continue;
+        std::lock_guard<std::mutex> lock(stations[i]->queueMutex);
+        const std::deque<Job>& queue = stations[i]->queue;
+        size_t unpinned = static_cast<size_t>(
+            std::count_if(queue.begin(), queue.end(), [](const Job& queued) { return !queued.pinned; }));
+        if (unpinned > most) {
+            most = unpinned;
+            victim = i;
+        }
+    }
+    if (victim == ANY_STATION) {
+        return false;
+    }
+
+    Station& other = *stations[victim];
+    std::lock_guard<std::mutex> lock(other.queueMutex);
+    for (auto it = other.queue.rbegin(); it != other.queue.rend(); ++it) {
+        if (!it->pinned) {
+            job = std::move(*it);
+            other.queue.erase(std::next(it).base());
+            stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void StationPool::finishJob(size_t index, Job& job, const TestResult& result) {
+    (result.passed ? passedCount : failedCount).fetch_add(1, std::memory_order_relaxed);
+    stations[index]->completed.fetch_add(1, std::memory_order_relaxed);
+    deliver(index, job, result);
+}
+
+void StationPool::deliver(size_t index, Job& job, const TestResult& result) {
+    if (job.callback) {
+        job.callback(index, result);
+    } else {
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        results.push_back(result);
+    }
+
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    if (--outstanding == 0) {
+        idleCondition.notify_all();
+    }
+}
+
+} // namespace MechatronicTest
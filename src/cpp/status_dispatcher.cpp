@@ -0,0 +1,159 @@
+/**
+ * @file status_dispatcher.cpp
+ * @brief Implementation of the status event dispatcher
+ */
+
+#include "status_dispatcher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+namespace MechatronicTest {
+
+StatusDispatcher::StatusDispatcher(size_t capacity)
+    : queue(capacity), latest(EquipmentStatus::IDLE), overflowed(false), published(0), delivered(0),
+      listeners(std::make_shared<const ListenerList>()), listenerCount(0), nextListenerId(1),
+      stopping(false) {}
+
+StatusDispatcher::~StatusDispatcher() {
+    stop();
+}
+
+void StatusDispatcher::stop() {
+    stopping = true;
+    wakeCondition.notify_all();
+
+    // Join outside listenersMutex; the dispatcher takes it to snapshot listeners
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(listenersMutex);
+        thread = std::move(dispatchThread);
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+StatusListenerId StatusDispatcher::addListener(StatusCallback callback) {
+    if (!callback) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(listenersMutex);
+    auto updated = std::make_shared<ListenerList>(*listeners);
+    StatusListenerId id = nextListenerId++;
+    updated->emplace_back(id, std::move(callback));
+    listeners = std::move(updated);
+    listenerCount = listeners->size();
+
+    if (!dispatchThread.joinable() && !stopping) {
+        dispatchThread = std::thread(&StatusDispatcher::dispatchLoop, this);
+    }
+    return id;
+}
+
+bool StatusDispatcher::removeListener(StatusListenerId id) {
+    std::lock_guard<std::mutex> lock(listenersMutex);
+    auto updated = std::make_shared<ListenerList>(*listeners);
+    auto it = std::find_if(updated->begin(), updated->end(),
+                           [id](const auto& listener) { return listener.first == id; });
+    if (it == updated->end()) {
+        return false;
+    }
+    updated->erase(it);
+    listeners = std::move(updated);
+    listenerCount = listeners->size();
+    return true;
+}
+
+void StatusDispatcher::publish(EquipmentStatus status, std::string_view message) {
+    latest.store(status, std::memory_order_relaxed);
+    if (listenerCount.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    bool queued = queue.tryEmplace([&](Event& event) {
+        size_t length = std::min(message.size(), MESSAGE_CAPACITY - 1);
+        event.status = status;
+        std::memcpy(event.message, message.data(), length);
+        event.message[length] = '\0';
+    });
+    if (queued) {
+        published.fetch_add(1, std::memory_order_release);
+    } else {
+        overflowed.store(true, std::memory_order_release);
+    }
+    wakeCondition.notify_all();
+}
+
+bool StatusDispatcher::waitDelivered(int timeout_ms) {
+    std::uint64_t target = published.load(std::memory_order_acquire);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (delivered.load(std::memory_order_acquire) < target) {
+        if (listenerCount.load() == 0 || std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        wakeCondition.wait_for(lock, std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+void StatusDispatcher::dispatchLoop() {
+    std::vector<std::pair<EquipmentStatus, std::string>> batch;
+    while (!stopping.load(std::memory_order_acquire)) {
+        // Collapse runs of the same status into the latest event
+        std::uint64_t consumed = 0;
+        batch.clear();
+        while (queue.tryConsume([&batch](Event& event) {
+            if (!batch.empty() && batch.back().first == event.status) {
+                batch.back().second = event.message;
+            } else {
+                batch.emplace_back(event.status, event.message);
+            }
+        })) {
+            ++consumed;
+        }
+
+        if (overflowed.exchange(false, std::memory_order_acq_rel)) {
+            batch.emplace_back(latest.load(std::memory_order_relaxed), "Status updates dropped");
+        }
+
+        if (batch.empty()) {
+            // Producers notify without the lock, so a missed wakeup costs at most one interval
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        std::shared_ptr<const ListenerList> targets;
+        {
+            std::lock_guard<std::mutex> lock(listenersMutex);
+            targets = listeners;
+        }
+        for (const auto& event : batch) {
+            if (stopping.load(std::memory_order_acquire)) {
+                return;
+            }
+            deliver(targets, event.first, event.second);
+        }
+
+        delivered.fetch_add(consumed, std::memory_order_release);
+        wakeCondition.notify_all();
+    }
+}
+
+void StatusDispatcher::deliver(const std::shared_ptr<const ListenerList>& targets, EquipmentStatus status,
+                               const std::string& message) {
+    for (const auto& listener : *targets) {
+        try {
+            listener.second(status, message);
+        } catch (...) {
+            // A failing listener must not starve the others
+        }
+    }
+}
+
+} // namespace MechatronicTest
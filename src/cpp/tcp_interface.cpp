@@ -0,0 +1,297 @@
+/**
+ * @file tcp_interface.cpp
+ * @brief Implementation of the TCP hardware interface
+ */
+
+#include "tcp_interface.h"
+#include <chrono>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace MechatronicTest {
+
+namespace {
+
+#ifndef _WIN32
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;  // SO_NOSIGPIPE is set on the socket instead
+#endif
+
+bool waitFor(int fd, short events, int timeout_ms) {
+    struct pollfd pfd = {fd, events, 0};
+    int ready;
+    do {
+        ready = poll(&pfd, 1, timeout_ms);
+    } while (ready < 0 && errno == EINTR);
+    return ready > 0 && !(pfd.revents & (POLLERR | POLLNVAL));
+}
+
+void setOption(int fd, int level, int name, int value) {
+    setsockopt(fd, level, name, &value, sizeof(value));
+}
+#endif
+
+} // namespace
+
+TcpInterface::TcpInterface(const TcpOptions& tcp_options)
+    : options(tcp_options), socket_fd(-1), open(false), reconnectCount(0) {}
+
+TcpInterface::~TcpInterface() {
+    disconnect();
+}
+
+bool TcpInterface::connect(const std::string& port, int baud_rate) {
+    (void)baud_rate;
+    disconnect();
+
+    size_t colon = port.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == port.size()) {
+        return false;
+    }
+    host = port.substr(0, colon);
+    service = port.substr(colon + 1);
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+
+    if (!openSocket()) {
+        return false;
+    }
+    open = true;
+    return true;
+}
+
+bool TcpInterface::disconnect() {
+    closeSocket();
+    open = false;
+    return true;
+}
+
+bool TcpInterface::isConnected() const {
+    return open;
+}
+
+bool TcpInterface::sendCommand(const std::string& command) {
+    return deliver(command.data(), command.size(), true);
+}
+
+bool TcpInterface::sendRaw(const char* data, size_t length) {
+    return deliver(data, length, false);
+}
+
+bool TcpInterface::deliver(const char* data, size_t length, bool terminate) {
+    if (!open) return false;
+    if (socket_fd >= 0 && peerClosed()) {
+        closeSocket();
+    }
+    if (socket_fd < 0 && !reconnect()) return false;
+
+    if (!writeParts(data, length, terminate)) {
+        // The peer may have gone away since the last exchange; retry once on a fresh connection
+        closeSocket();
+        if (!reconnect() || !writeParts(data, length, terminate)) {
+            closeSocket();
+            return false;
+        }
+    }
+    countSent(length + (terminate ? 2 : 0));
+    return true;
+}
+
+bool TcpInterface::reconnect() {
+    if (!options.reconnect) {
+        open = false;
+        return false;
+    }
+    int backoff = options.reconnect_backoff_ms;
+    for (int attempt = 0; attempt < options.reconnect_attempts; ++attempt) {
+        if (attempt > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(backoff));
+            backoff *= 2;
+        }
+        if (openSocket()) {
+            ++reconnectCount;
+            return true;
+        }
+    }
+    open = false;
+    return false;
+}
+
+#ifndef _WIN32
+
+bool TcpInterface::openSocket() {
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses) != 0) {
+        return false;
+    }
+
+    for (struct addrinfo* address = addresses; address; address = address->ai_next) {
+        int fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) continue;
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+        bool connected = ::connect(fd, address->ai_addr, address->ai_addrlen) == 0;
+        if (!connected && errno == EINPROGRESS && waitFor(fd, POLLOUT, options.connect_timeout_ms)) {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            connected = getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0;
+        }
+        if (!connected) {
+            close(fd);
+            continue;
+        }
+
+        // Commands are single small writes; Nagle would hold each one for an ACK
+        setOption(fd, IPPROTO_TCP, TCP_NODELAY, 1);
+#ifdef SO_NOSIGPIPE
+        setOption(fd, SOL_SOCKET, SO_NOSIGPIPE, 1);
+#endif
+        if (options.keepalive) {
+            setOption(fd, SOL_SOCKET, SO_KEEPALIVE, 1);
+#ifdef TCP_KEEPIDLE
+            setOption(fd, IPPROTO_TCP, TCP_KEEPIDLE, options.keepalive_idle_s);
+#endif
+#ifdef TCP_KEEPINTVL
+            setOption(fd, IPPROTO_TCP, TCP_KEEPINTVL, options.keepalive_interval_s);
+#endif
+#ifdef TCP_KEEPCNT
+            setOption(fd, IPPROTO_TCP, TCP_KEEPCNT, options.keepalive_count);
+#endif
+        }
+
+        socket_fd = fd;
+        freeaddrinfo(addresses);
+        resetReceiveBuffer();
+        return true;
+    }
+    freeaddrinfo(addresses);
+    return false;
+}
+
+void TcpInterface::closeSocket() {
+    if (socket_fd >= 0) {
+        close(socket_fd);
+        socket_fd = -1;
+    }
+}
+
+bool TcpInterface::peerClosed() {
+    // A closed connection still accepts the first write, so look for the FIN before sending
+    char probe;
+    struct pollfd pfd = {socket_fd, POLLIN, 0};
+    if (poll(&pfd, 1, 0) <= 0) return false;
+    if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) return true;
+    ssize_t peeked = recv(socket_fd, &probe, 1, MSG_PEEK);
+    return peeked == 0 || (peeked < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+}
+
+bool TcpInterface::writeParts(const char* data, size_t length, bool terminate) {
+    static const char terminator[] = "\r\n";
+    struct iovec parts[2];
+    parts[0].iov_base = const_cast<char*>(data);
+    parts[0].iov_len = length;
+    parts[1].iov_base = const_cast<char*>(terminator);
+    parts[1].iov_len = 2;
+
+    struct msghdr message = {};
+    message.msg_iov = parts;
+    message.msg_iovlen = terminate ? 2 : 1;
+    while (message.msg_iovlen > 0) {
+        ssize_t sent = sendmsg(socket_fd, &message, SEND_FLAGS);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!waitFor(socket_fd, POLLOUT, options.send_timeout_ms)) return false;
+                continue;
+            }
+            return false;
+        }
+
+        // Skip whatever went out; a partial send resumes mid-part
+        size_t remaining = static_cast<size_t>(sent);
+        while (message.msg_iovlen > 0 && remaining >= message.msg_iov->iov_len) {
+            remaining -= message.msg_iov->iov_len;
+            ++message.msg_iov;
+            --message.msg_iovlen;
+        }
+        if (message.msg_iovlen > 0) {
+            message.msg_iov->iov_base = static_cast<char*>(message.msg_iov->iov_base) + remaining;
+            message.msg_iov->iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+long TcpInterface::readAvailable(char* buffer, size_t length, int timeout_ms) {
+    if (socket_fd < 0) return -1;
+
+    struct pollfd pfd = {socket_fd, POLLIN, 0};
+    int ready = poll(&pfd, 1, timeout_ms);
+    if (ready < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    if (ready == 0) {
+        return 0;
+    }
+
+    ssize_t bytesRead = recv(socket_fd, buffer, length, 0);
+    if (bytesRead < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+        closeSocket();
+        return -1;
+    }
+    if (bytesRead == 0) {
+        // Peer closed; the next send reconnects
+        closeSocket();
+        return -1;
+    }
+    return static_cast<long>(bytesRead);
+}
+
+#else
+
+bool TcpInterface::openSocket() {
+    return false;
+}
+
+void TcpInterface::closeSocket() {}
+
+bool TcpInterface::peerClosed() {
+    return true;
+}
+
+bool TcpInterface::writeParts(const char* data, size_t length, bool terminate) {
+    (void)data;
+    (void)length;
+    (void)terminate;
+    return false;
+}
+
+long TcpInterface::readAvailable(char* buffer, size_t length, int timeout_ms) {
+    (void)buffer;
+    (void)length;
+    (void)timeout_ms;
+    return -1;
+}
+
+#endif
+
+} // namespace MechatronicTest
@@ -0,0 +1,290 @@
+/**
+ * @file test_plan.cpp
+ * @brief Implementation of test plan compilation and execution
+ */
+
+#include "test_plan.h"
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef HAS_YAML_CPP
+#include <yaml-cpp/yaml.h>
+#endif
+
+namespace MechatronicTest {
+
+TestPlan::TestPlan(std::string name) : planName(std::move(name)), compiled(false) {}
+
+bool TestPlan::addStep(TestStep step) {
+    if (step.id.empty()) {
+        lastError = "Test step without an id";
+        return false;
+    }
+    for (const auto& existing : planSteps) {
+        if (existing.id == step.id) {
+            lastError = "Duplicate test step '" + step.id + "'";
+            return false;
+        }
+    }
+    planSteps.push_back(std::move(step));
+    compiled = false;
+    return true;
+}
+
+bool TestPlan::compile() {
+    compiled = false;
+    size_t count = planSteps.size();
+    std::unordered_map<std::string, size_t> index;
+    index.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        index.emplace(planSteps[i].id, i);
+    }
+
+    // Dependents of each step, stored contiguously (CSR)
+    indegree.assign(count, 0);
+    dependentsBegin.assign(count + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        for (const auto& dependency : planSteps[i].depends_on) {
+            auto it = index.find(dependency);
+            if (it == index.end()) {
+                lastError = "Step '" + planSteps[i].id + "' depends on unknown step '" + dependency + "'";
+                return false;
+            }
+            ++dependentsBegin[it->second + 1];
+            ++indegree[i];
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        dependentsBegin[i + 1] += dependentsBegin[i];
+    }
+    dependents.assign(dependentsBegin[count], 0);
+    std::vector<size_t> fill(dependentsBegin.begin(), dependentsBegin.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        for (const auto& dependency : planSteps[i].depends_on) {
+            dependents[fill[index[dependency]]++] = i;
+        }
+    }
+
+    // Kahn's algorithm; steps that never become ready are on a cycle
+    order.clear();
+    order.reserve(count);
+    std::vector<size_t> remaining = indegree;
+    for (size_t i = 0; i < count; ++i) {
+        if (remaining[i] == 0) order.push_back(i);
+    }
+    for (size_t next = 0; next < order.size(); ++next) {
+        size_t step = order[next];
+        for (size_t d = dependentsBegin[step]; d < dependentsBegin[step + 1]; ++d) {
+            if (--remaining[dependents[d]] == 0) order.push_back(dependents[d]);
+        }
+    }
+    if (order.size() != count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (remaining[i] != 0) {
+                lastError = "Dependency cycle through step '" + planSteps[i].id + "'";
+                break;
+            }
+        }
+        order.clear();
+        return false;
+    }
+    compiled = true;
+    return true;
+}
+
+PlanResult TestPlan::newResult() const {
+    PlanResult plan;
+    plan.passed = false;
+    plan.aborted = false;
+    plan.elapsed = std::chrono::steady_clock::duration::zero();
+    plan.steps.resize(planSteps.size());
+    for (size_t i = 0; i < planSteps.size(); ++i) {
+        StepResult& step = plan.steps[i];
+        step.id = planSteps[i].id;
+        step.ran = false;
+        step.passed = false;
+        step.station = StationPool::ANY_STATION;
+        step.result.passed = false;
+        step.result.measurement_value = 0.0;
+    }
+    return plan;
+}
+
+void TestPlan::finishStep(PlanResult& plan, size_t step, bool ran, size_t station, const TestResult& result) const {
+    StepResult& outcome = plan.steps[step];
+    outcome.ran = ran;
+    outcome.passed = ran && result.passed;
+    outcome.station = ran ? station : StationPool::ANY_STATION;
+    outcome.result = result;
+    if (!outcome.passed && planSteps[step].hard_fail && !plan.aborted) {
+        plan.aborted = true;
+        plan.failed_step = planSteps[step].id;
+    }
+}
+
+namespace {
+
+/**
+ * @brief Fill in the steps that never started and the plan verdict
+ */
+void concludePlan(PlanResult& plan, const std::vector<TestStep>& steps, const std::string& device_id,
+                  std::chrono::steady_clock::time_point started) {
+    plan.passed = !plan.aborted;
+    for (size_t i = 0; i < steps.size(); ++i) {
+        StepResult& step = plan.steps[i];
+        if (step.result.notes.empty() && !step.ran) {
+            step.result.device_id = device_id;
+            step.result.outcome = OutcomeCode::NOT_RUNNING;
+            step.result.notes = plan.aborted ? "Not started: step '" + plan.failed_step + "' failed"
+                                             : "Not started: a dependency failed";
+        }
+        if (steps[i].hard_fail && !step.passed) {
+            plan.passed = false;
+        }
+    }
+    plan.elapsed = std::chrono::steady_clock::now() - started;
+}
+
+} // namespace
+
+PlanResult TestPlan::run(StationPool& pool, const std::string& device_id) const {
+    auto started = std::chrono::steady_clock::now();
+    PlanResult plan = newResult();
+    if (!compiled) {
+        plan.aborted = true;
+        for (auto& step : plan.steps) {
+            step.result.outcome = OutcomeCode::NOT_RUNNING;
+            step.result.notes = "Test plan not compiled";
+        }
+        concludePlan(plan, planSteps, device_id, started);
+        return plan;
+    }
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<size_t> remaining = indegree;
+    size_t inFlight = 0;
+
+    // Called with mutex held; callbacks run on the pool's worker threads
+    std::function<void(size_t)> launch = [&](size_t step) {
+        const TestStep& definition = planSteps[step];
+        ++inFlight;
+        auto done = [&, step](size_t station, const TestResult& result) {
+            std::lock_guard<std::mutex> lock(mutex);
+            finishStep(plan, step, true, station, result);
+            if (plan.steps[step].passed && !plan.aborted) {
+                for (size_t d = dependentsBegin[step]; d < dependentsBegin[step + 1]; ++d) {
+                    if (--remaining[dependents[d]] == 0) launch(dependents[d]);
+                }
+            }
+            // Notified under the lock: run() may return as soon as it can reacquire it
+            if (--inFlight == 0) finished.notify_all();
+        };
+        if (!pool.submit(device_id, definition.parameters, done, definition.station,
+                         definition.station != StationPool::ANY_STATION)) {
+            --inFlight;
+            TestResult unavailable;
+            unavailable.device_id = device_id;
+            unavailable.passed = false;
+            unavailable.measurement_value = 0.0;
+            unavailable.outcome = OutcomeCode::NOT_CONNECTED;
+            unavailable.notes = "Station not available";
+            finishStep(plan, step, false, StationPool::ANY_STATION, unavailable);
+        }
+    };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    for (size_t step : order) {
+        if (indegree[step] != 0 || plan.aborted) break;  // Roots come first in the schedule
+        launch(step);
+    }
+    while (inFlight != 0) {
+        finished.wait_for(lock, std::chrono::milliseconds(100));
+    }
+    concludePlan(plan, planSteps, device_id, started);
+    return plan;
+}
+
+PlanResult TestPlan::run(EquipmentController& controller, const std::string& device_id) const {
+    auto started = std::chrono::steady_clock::now();
+    PlanResult plan = newResult();
+    if (!compiled) {
+        plan.aborted = true;
+        for (auto& step : plan.steps) {
+            step.result.outcome = OutcomeCode::NOT_RUNNING;
+            step.result.notes = "Test plan not compiled";
+        }
+        concludePlan(plan, planSteps, device_id, started);
+        return plan;
+    }
+
+    std::vector<size_t> remaining = indegree;
+    for (size_t step : order) {
+        if (plan.aborted) break;
+        if (remaining[step] != 0) continue;  // A dependency did not pass
+        finishStep(plan, step, true, 0, controller.runTest(device_id, planSteps[step].parameters));
+        if (plan.steps[step].passed) {
+            for (size_t d = dependentsBegin[step]; d < dependentsBegin[step + 1]; ++d) {
+                --remaining[dependents[d]];
+            }
+        }
+    }
+    concludePlan(plan, planSteps, device_id, started);
+    return plan;
+}
+
+bool loadTestPlan(const std::string& path, TestPlan& plan) {
+    plan = TestPlan();
+#ifdef HAS_YAML_CPP
+    auto strings = [](const YAML::Node& node) {
+        std::vector<std::string> values;
+        if (node && node.IsSequence()) {
+            for (const auto& value : node) values.push_back(value.as<std::string>());
+        } else if (node && node.IsScalar()) {
+            values.push_back(node.as<std::string>());
+        }
+        return values;
+    };
+
+    try {
+        YAML::Node section = YAML::LoadFile(path)["test_plan"];
+        if (!section || !section.IsMap()) {
+            plan.lastError = "No test_plan section in " + path;
+            return false;
+        }
+        if (section["name"]) {
+            plan.planName = section["name"].as<std::string>();
+        }
+        YAML::Node steps = section["steps"];
+        if (!steps || !steps.IsSequence() || steps.size() == 0) {
+            plan.lastError = "test_plan in " + path + " has no steps";
+            return false;
+        }
+        for (const auto& node : steps) {
+            TestStep step;
+            step.id = node["id"] ? node["id"].as<std::string>() : std::string();
+            step.parameters = strings(node["parameters"]);
+            step.depends_on = strings(node["depends_on"]);
+            if (node["station"]) {
+                step.station = node["station"].as<size_t>();
+            }
+            if (node["hard_fail"]) {
+                step.hard_fail = node["hard_fail"].as<bool>();
+            }
+            if (!plan.addStep(std::move(step))) {
+                return false;
+            }
+        }
+    } catch (const YAML::Exception& e) {
+        plan.lastError = "Invalid test_plan in " + path + ": " + e.what();
+        return false;
+    }
+    return plan.compile();
+#else
+    plan.lastError = "Loading " + path + " needs a build with yaml-cpp";
+    return false;
+#endif
+}
+
+} // namespace MechatronicTest
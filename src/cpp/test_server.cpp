@@ -0,0 +1,544 @@
+/**
+ * @file test_server.cpp
+ * @brief Implementation of the station pool socket server
+ */
+
+#include "test_server.h"
+#include "line_framer.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace MechatronicTest {
+
+namespace {
+
+#ifndef _WIN32
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;  // SO_NOSIGPIPE is set on the socket instead
+#endif
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 &&
+           fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+#endif
+
+void appendNumber(std::string& out, double value) {
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "%.9g", value);
+    out.append(text, static_cast<size_t>(std::max(0, length)));
+}
+
+/**
+ * @brief Split a request at ':' into at most max_fields views
+ */
+size_t splitFields(std::string_view request, std::string_view* fields, size_t max_fields) {
+    size_t count = 0;
+    while (count < max_fields) {
+        size_t colon = request.find(':');
+        fields[count++] = request.substr(0, colon);
+        if (colon == std::string_view::npos) break;
+        request.remove_prefix(colon + 1);
+    }
+    return count;
+}
+
+std::string formatResult(std::string_view tag, size_t station, const TestResult& result) {
+    std::string reply;
+    reply.reserve(64 + result.notes.size() + result.measurements.size() * 12);
+    reply += "RESULT:";
+    reply += tag;
+    reply += result.passed ? ":PASS:" : ":FAIL:";
+    reply += std::to_string(station);
+    reply += ':';
+    if (result.measurements.empty()) {
+        appendNumber(reply, result.measurement_value);
+    }
+    for (size_t i = 0; i < result.measurements.size(); ++i) {
+        if (i > 0) reply += ',';
+        appendNumber(reply, result.measurements[i]);
+    }
+    reply += ':';
+    reply += result.units;
+    reply += ':';
+    size_t notes = reply.size();
+    reply += result.notes;
+    std::replace_if(reply.begin() + static_cast<std::ptrdiff_t>(notes), reply.end(),
+                    [](char c) { return c == '\r' || c == '\n'; }, ' ');
+    reply += '\n';
+    return reply;
+}
+
+} // namespace
+
+bool parseServerAddress(const std::string& text, ServerAddress& address) {
+    address = ServerAddress();
+    if (text.rfind("unix:", 0) == 0) {
+        address.unix_socket = true;
+        address.path = text.substr(5);
+        return !address.path.empty();
+    }
+
+    size_t colon;
+    if (!text.empty() && text[0] == '[') {
+        size_t close = text.find(']');
+        if (close == std::string::npos || close + 1 >= text.size() || text[close + 1] != ':') {
+            return false;
+        }
+        address.host = text.substr(1, close - 1);
+        colon = close + 1;
+    } else {
+        colon = text.rfind(':');
+        if (colon == std::string::npos) {
+            return false;
+        }
+        address.host = text.substr(0, colon);
+    }
+    address.port = text.substr(colon + 1);
+    return !address.port.empty() &&
+           std::all_of(address.port.begin(), address.port.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+/**
+ * @brief Self-pipe that wakes the serve thread; shared with in-flight callbacks
+ */
+struct TestServer::Waker {
+    int fds[2] = {-1, -1};
+
+#ifndef _WIN32
+    Waker() {
+        if (pipe(fds) != 0 || !setNonBlocking(fds[0]) || !setNonBlocking(fds[1])) {
+            close();
+        }
+    }
+
+    ~Waker() { close(); }
+
+    void notify() {
+        char byte = 1;
+        if (fds[1] >= 0 && write(fds[1], &byte, 1) < 0) {
+            // Full pipe: a wakeup is already pending
+        }
+    }
+
+    void drain() {
+        char bytes[64];
+        while (fds[0] >= 0 && read(fds[0], bytes, sizeof(bytes)) > 0) {
+        }
+    }
+
+    void close() {
+        for (int& fd : fds) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+    }
+#else
+    void notify() {}
+#endif
+};
+
+/**
+ * @brief One connection; outlives the server while its tests are queued
+ */
+struct TestServer::Client {
+    std::mutex mutex;    // Guards fd against close() and outbox against concurrent results
+    int fd;
+    std::string outbox;  // Reply bytes the socket did not accept yet
+    LineFramer input;
+    std::atomic<size_t> pending{0};
+    std::shared_ptr<Waker> waker;
+
+    Client(int socket_fd, size_t max_request, std::shared_ptr<Waker> server_waker)
+        : fd(socket_fd), input(max_request), waker(std::move(server_waker)) {}
+
+    /**
+     * @brief Write a reply now if nothing is queued ahead of it, else queue it for the serve thread
+     */
+    void send(std::string_view reply) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd < 0) return;
+#ifndef _WIN32
+        if (outbox.empty()) {
+            ssize_t written = ::send(fd, reply.data(), reply.size(), SEND_FLAGS);
+            if (written == static_cast<ssize_t>(reply.size())) return;
+            // Errors other than a full socket show up as POLLERR/POLLHUP in the serve thread
+            reply.remove_prefix(written > 0 ? static_cast<size_t>(written) : 0);
+        }
+#endif
+        outbox.append(reply.data(), reply.size());
+        waker->notify();
+    }
+
+    bool wantsWrite() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !outbox.empty();
+    }
+
+    /**
+     * @brief Write queued bytes; false if the connection failed
+     */
+    bool flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+#ifndef _WIN32
+        while (fd >= 0 && !outbox.empty()) {
+            ssize_t written = ::send(fd, outbox.data(), outbox.size(), SEND_FLAGS);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            outbox.erase(0, static_cast<size_t>(written));
+        }
+#endif
+        return true;
+    }
+};
+
+TestServer::TestServer(StationPool& station_pool, const ServerOptions& server_options)
+    : pool(station_pool), options(server_options), listenFd(-1), connected(0), running(false) {}
+
+TestServer::~TestServer() {
+    stop();
+}
+
+bool TestServer::isRunning() const {
+    return running;
+}
+
+std::string TestServer::boundAddress() const {
+    return bound;
+}
+
+size_t TestServer::clientCount() const {
+    return connected.load(std::memory_order_relaxed);
+}
+
+std::string TestServer::getLastError() const {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    return lastError;
+}
+
+void TestServer::handleRequest(const std::shared_ptr<Client>& client, std::string_view request) {
+    constexpr size_t MAX_FIELDS = 64;
+    std::string_view fields[MAX_FIELDS];
+    size_t count = splitFields(request, fields, MAX_FIELDS);
+    std::string_view verb = fields[0];
+    std::string_view tag = count > 1 ? fields[1] : std::string_view();
+
+    auto fail = [&](const char* message) {
+        std::string reply = "ERROR:";
+        reply += tag;
+        reply += ':';
+        reply += message;
+        reply += '\n';
+        client->send(reply);
+    };
+
+    if (verb == "TEST") {
+        if (count < 3 || fields[2].empty()) {
+            fail("TEST needs a tag and a device");
+            return;
+        }
+        if (client->pending.load(std::memory_order_relaxed) >= options.max_pending_per_client) {
+            fail("Too many pending tests");
+            return;
+        }
+        std::vector<std::string> parameters;
+        parameters.reserve(count - 3);
+        for (size_t i = 3; i < count; ++i) {
+            parameters.emplace_back(fields[i]);
+        }
+        client->pending.fetch_add(1, std::memory_order_relaxed);
+        auto callback = [client, tag = std::string(tag)](size_t station, const TestResult& result) {
+            client->pending.fetch_sub(1, std::memory_order_relaxed);
+            client->send(formatResult(tag, station, result));
+        };
+        if (!pool.submit(std::string(fields[2]), parameters, std::move(callback))) {
+            client->pending.fetch_sub(1, std::memory_order_relaxed);
+            fail("Station pool not running");
+        }
+    } else if (verb == "STATUS") {
+        PoolSummary summary = pool.getSummary();
+        size_t active = 0;
+        for (size_t i = 0; i < pool.stationCount(); ++i) {
+            active += pool.isStationActive(i) ? 1 : 0;
+        }
+        std::string reply = "STATUS:";
+        reply += tag;
+        for (size_t value : {pool.stationCount(), active, summary.submitted, summary.completed,
+                             summary.passed, summary.failed}) {
+            reply += ':';
+            reply += std::to_string(value);
+        }
+        reply += '\n';
+        client->send(reply);
+    } else if (verb == "HEALTH") {
+        size_t station = 0;
+        std::string_view index = count > 2 ? fields[2] : std::string_view();
+        auto parsed = std::from_chars(index.data(), index.data() + index.size(), station);
+        if (index.empty() || parsed.ec != std::errc() || parsed.ptr != index.data() + index.size() ||
+            station >= pool.stationCount()) {
+            fail("No such station");
+            return;
+        }
+        std::string reply = "HEALTH:";
+        reply += tag;
+        reply += ':';
+        bool first = true;
+        for (const auto& metric : pool.station(station).getHealthMetrics()) {
+            if (!first) reply += ',';
+            first = false;
+            reply += metric.first;
+            reply += '=';
+            appendNumber(reply, metric.second);
+        }
+        reply += '\n';
+        client->send(reply);
+    } else if (verb == "PING") {
+        std::string reply = "PONG:";
+        reply += tag;
+        reply += '\n';
+        client->send(reply);
+    } else {
+        fail("Unknown request");
+    }
+}
+
+#ifndef _WIN32
+
+bool TestServer::start(const std::string& address) {
+    auto setError = [this](const std::string& message) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        lastError = message;
+        return false;
+    };
+    if (running) {
+        return setError("Server already running");
+    }
+    if (!parseServerAddress(address, listenAddress)) {
+        return setError("Invalid listen address: " + address);
+    }
+    waker = std::make_shared<Waker>();
+    if (waker->fds[0] < 0) {
+        return setError("Failed to create wakeup pipe");
+    }
+
+    if (listenAddress.unix_socket) {
+        struct sockaddr_un local = {};
+        local.sun_family = AF_UNIX;
+        if (listenAddress.path.size() >= sizeof(local.sun_path)) {
+            return setError("Unix socket path too long: " + listenAddress.path);
+        }
+        std::copy(listenAddress.path.begin(), listenAddress.path.end(), local.sun_path);
+        struct stat existing;
+        if (stat(listenAddress.path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+            unlink(listenAddress.path.c_str());  // A stale socket from a previous run
+        }
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            stop();
+            return setError("Failed to bind " + address);
+        }
+        bound = "unix:" + listenAddress.path;
+    } else {
+        struct addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        struct addrinfo* addresses = nullptr;
+        if (getaddrinfo(listenAddress.host.empty() ? nullptr : listenAddress.host.c_str(),
+                        listenAddress.port.c_str(), &hints, &addresses) != 0) {
+            return setError("Cannot resolve " + address);
+        }
+        for (struct addrinfo* candidate = addresses; candidate; candidate = candidate->ai_next) {
+            listenFd = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+            if (listenFd < 0) continue;
+            int reuse = 1;
+            setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            if (bind(listenFd, candidate->ai_addr, candidate->ai_addrlen) == 0) break;
+            close(listenFd);
+            listenFd = -1;
+        }
+        freeaddrinfo(addresses);
+        if (listenFd < 0) {
+            return setError("Failed to bind " + address);
+        }
+
+        struct sockaddr_storage local = {};
+        socklen_t length = sizeof(local);
+        char host[NI_MAXHOST] = "", service[NI_MAXSERV] = "";
+        getsockname(listenFd, reinterpret_cast<sockaddr*>(&local), &length);
+        getnameinfo(reinterpret_cast<sockaddr*>(&local), length, host, sizeof(host), service, sizeof(service),
+                    NI_NUMERICHOST | NI_NUMERICSERV);
+        bound = local.ss_family == AF_INET6 ? "[" + std::string(host) + "]:" + service
+                                            : std::string(host) + ":" + service;
+    }
+
+    if (listen(listenFd, 64) != 0 || !setNonBlocking(listenFd)) {
+        stop();
+        return setError("Failed to listen on " + address);
+    }
+    running = true;
+    thread = std::thread(&TestServer::serve, this);
+    return true;
+}
+
+void TestServer::stop() {
+    running = false;
+    if (waker) {
+        waker->notify();
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+    for (auto& client : clients) {
+        closeClient(*client);
+    }
+    clients.clear();
+    connected = 0;
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+        if (listenAddress.unix_socket) {
+            unlink(listenAddress.path.c_str());
+        }
+    }
+}
+
+void TestServer::closeClient(Client& client) {
+    std::lock_guard<std::mutex> lock(client.mutex);
+    if (client.fd >= 0) {
+        close(client.fd);
+        client.fd = -1;
+    }
+    client.outbox.clear();
+}
+
+void TestServer::serve() {
+    std::vector<struct pollfd> fds;
+    while (running) {
+        fds.clear();
+        fds.push_back({waker->fds[0], POLLIN, 0});
+        fds.push_back({listenFd, static_cast<short>(clients.size() < options.max_clients ? POLLIN : 0), 0});
+        for (const auto& client : clients) {
+            fds.push_back({client->fd, static_cast<short>(POLLIN | (client->wantsWrite() ? POLLOUT : 0)), 0});
+        }
+
+        // Timed, so a missed wakeup costs at most one period
+        if (poll(fds.data(), fds.size(), 100) < 0 && errno != EINTR) {
+            break;
+        }
+        if (fds[0].revents & POLLIN) {
+            waker->drain();
+        }
+
+        size_t polled = clients.size();
+        for (size_t i = 0; i < polled; ++i) {
+            short events = fds[i + 2].revents;
+            bool open = true;
+            if (events & (POLLIN | POLLHUP | POLLERR)) {
+                open = readRequests(clients[i]);
+            }
+            if (open && (events & POLLOUT)) {
+                open = clients[i]->flush();
+            }
+            if (!open) {
+                closeClient(*clients[i]);
+            }
+        }
+        auto gone = std::remove_if(clients.begin(), clients.end(),
+                                   [](const std::shared_ptr<Client>& client) { return client->fd < 0; });
+        clients.erase(gone, clients.end());
+
+        if (fds[1].revents & POLLIN) {
+            acceptClients();
+        }
+        connected.store(clients.size(), std::memory_order_relaxed);
+    }
+}
+
+void TestServer::acceptClients() {
+    while (clients.size() < options.max_clients) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (!setNonBlocking(fd)) {
+            close(fd);
+            continue;
+        }
+        if (!listenAddress.unix_socket) {
+            int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        }
+#ifdef SO_NOSIGPIPE
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        clients.push_back(std::make_shared<Client>(fd, options.max_request_bytes, waker));
+    }
+}
+
+bool TestServer::readRequests(const std::shared_ptr<Client>& client) {
+    while (true) {
+        size_t space = 0;
+        char* buffer = client->input.prepareWrite(space);
+        ssize_t received = recv(client->fd, buffer, space, 0);
+        if (received == 0) {
+            return false;
+        }
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client->input.commitWrite(static_cast<size_t>(received));
+
+        std::string_view request;
+        while (client->input.nextFrame(request)) {
+            handleRequest(client, request);
+        }
+    }
+}
+
+#else
+
+bool TestServer::start(const std::string& address) {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    lastError = parseServerAddress(address, listenAddress) ? "Test server requires POSIX sockets"
+                                                           : "Invalid listen address: " + address;
+    return false;
+}
+
+void TestServer::stop() {}
+
+void TestServer::closeClient(Client&) {}
+
+void TestServer::serve() {}
+
+void TestServer::acceptClients() {}
+
+bool TestServer::readRequests(const std::shared_ptr<Client>&) {
+    return false;
+}
+
+#endif
+
+} // namespace MechatronicTest
@@ -0,0 +1,262 @@
+/**
+ * @file usb_interface.cpp
+ * @brief Implementation of the USB bulk-transfer hardware interface
+ */
+
+#include "usb_interface.h"
+
+#ifdef HAS_LIBUSB
+
+#include <libusb.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace MechatronicTest {
+
+namespace {
+
+bool parseHex16(const std::string& text, std::uint16_t& value) {
+    if (text.empty() || text.size() > 4) return false;
+    char* end = nullptr;
+    unsigned long parsed = std::strtoul(text.c_str(), &end, 16);
+    if (*end != '\0') return false;
+    value = static_cast<std::uint16_t>(parsed);
+    return true;
+}
+
+libusb_device_handle* openMatching(libusb_context* context, std::uint16_t vendor, std::uint16_t product,
+                                   const std::string& serial) {
+    libusb_device** devices = nullptr;
+    ssize_t count = libusb_get_device_list(context, &devices);
+    if (count < 0) return nullptr;
+
+    libusb_device_handle* found = nullptr;
+    for (ssize_t i = 0; i < count && !found; ++i) {
+        libusb_device_descriptor descriptor;
+        if (libusb_get_device_descriptor(devices[i], &descriptor) != 0 ||
+            descriptor.idVendor != vendor || descriptor.idProduct != product) {
+            continue;
+        }
+        libusb_device_handle* candidate = nullptr;
+        if (libusb_open(devices[i], &candidate) != 0) continue;
+
+        if (!serial.empty()) {
+            unsigned char text[128];
+            int length = descriptor.iSerialNumber == 0 ? -1 :
+                libusb_get_string_descriptor_ascii(candidate, descriptor.iSerialNumber, text, sizeof(text));
+            if (length < 0 || serial != std::string(reinterpret_cast<char*>(text), static_cast<size_t>(length))) {
+                libusb_close(candidate);
+                continue;
+            }
+        }
+        found = candidate;
+    }
+    libusb_free_device_list(devices, 1);
+    return found;
+}
+
+} // namespace
+
+UsbInterface::UsbInterface(const UsbOptions& usb_options)
+    : options(usb_options), context(nullptr), handle(nullptr), running(false), activeTransfers(0),
+      connected(false), ringHead(0), ringSize(0), failed(false), dropped(0) {}
+
+UsbInterface::~UsbInterface() {
+    disconnect();
+}
+
+bool UsbInterface::connect(const std::string& port, int baud_rate) {
+    (void)baud_rate;
+    disconnect();
+
+    // "<vid>:<pid>[:<serial>]"
+    size_t first = port.find(':');
+    if (first == std::string::npos) return false;
+    size_t second = port.find(':', first + 1);
+    std::uint16_t vendor = 0, product = 0;
+    if (!parseHex16(port.substr(0, first), vendor) ||
+        !parseHex16(port.substr(first + 1, second == std::string::npos ? std::string::npos : second - first - 1),
+                    product)) {
+        return false;
+    }
+    std::string serial = second == std::string::npos ? std::string() : port.substr(second + 1);
+
+    if (libusb_init(&context) != 0) {
+        context = nullptr;
+        return false;
+    }
+    handle = openMatching(context, vendor, product, serial);
+    if (!handle) {
+        release();
+        return false;
+    }
+    libusb_set_auto_detach_kernel_driver(handle, 1);
+    if (libusb_claim_interface(handle, options.interface_number) != 0) {
+        release();
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(ringMutex);
+        ring.assign(options.receive_capacity, 0);
+        ringHead = ringSize = 0;
+        failed = false;
+    }
+    resetReceiveBuffer();
+
+    // Queue every bulk-IN transfer before any data is expected
+    transfers.assign(static_cast<size_t>(std::max(1, options.queued_transfers)), nullptr);
+    transferBuffers.assign(transfers.size(), std::vector<unsigned char>(options.transfer_size));
+    running = true;
+    for (size_t i = 0; i < transfers.size(); ++i) {
+        transfers[i] = libusb_alloc_transfer(0);
+        if (!transfers[i]) {
+            release();
+            return false;
+        }
+        libusb_fill_bulk_transfer(transfers[i], handle, options.bulk_in_endpoint, transferBuffers[i].data(),
+                                  static_cast<int>(options.transfer_size), &UsbInterface::transferComplete, this, 0);
+        if (libusb_submit_transfer(transfers[i]) != 0) {
+            release();
+            return false;
+        }
+        ++activeTransfers;
+    }
+    eventThread = std::thread([this]() { handleEvents(); });
+
+    connected = true;
+    return true;
+}
+
+bool UsbInterface::disconnect() {
+    connected = false;
+    release();
+    return true;
+}
+
+bool UsbInterface::isConnected() const {
+    return connected;
+}
+
+bool UsbInterface::sendCommand(const std::string& command) {
+    if (!connected) return false;
+
+    // Reuse one buffer so steady-state sends do not allocate
+    txBuffer.assign(command);
+    txBuffer += "\r\n";
+    return bulkOut(reinterpret_cast<const unsigned char*>(txBuffer.data()), txBuffer.size());
+}
+
+bool UsbInterface::sendRaw(const char* data, size_t length) {
+    if (!connected) return false;
+    return bulkOut(reinterpret_cast<const unsigned char*>(data), length);
+}
+
+bool UsbInterface::bulkOut(const unsigned char* data, size_t length) {
+    int transferred = 0;
+    int result = libusb_bulk_transfer(handle, options.bulk_out_endpoint, const_cast<unsigned char*>(data),
+                                      static_cast<int>(length), &transferred,
+                                      static_cast<unsigned int>(options.send_timeout_ms));
+    if (result != 0 || transferred != static_cast<int>(length)) {
+        return false;
+    }
+    countSent(length);
+    return true;
+}
+
+void UsbInterface::transferComplete(libusb_transfer* transfer) {
+    static_cast<UsbInterface*>(transfer->user_data)->onTransfer(transfer);
+}
+
+void UsbInterface::onTransfer(libusb_transfer* transfer) {
+    if (transfer->status == LIBUSB_TRANSFER_COMPLETED && transfer->actual_length > 0) {
+        std::lock_guard<std::mutex> lock(ringMutex);
+        size_t length = static_cast<size_t>(transfer->actual_length);
+        size_t space = ring.size() - ringSize;
+        if (length > space) {
+            dropped.fetch_add(length - space, std::memory_order_relaxed);
+            length = space;
+        }
+        size_t tail = (ringHead + ringSize) % ring.size();
+        size_t first = std::min(length, ring.size() - tail);
+        std::memcpy(ring.data() + tail, transfer->buffer, first);
+        std::memcpy(ring.data(), transfer->buffer + first, length - first);
+        ringSize += length;
+        dataReady.notify_one();
+    }
+
+    bool resubmit = running &&
+        (transfer->status == LIBUSB_TRANSFER_COMPLETED || transfer->status == LIBUSB_TRANSFER_TIMED_OUT);
+    if (resubmit && libusb_submit_transfer(transfer) == 0) {
+        return;
+    }
+
+    if (running && transfer->status != LIBUSB_TRANSFER_CANCELLED) {
+        // Stall, overflow or unplug: wake the reader so it reports the error
+        std::lock_guard<std::mutex> lock(ringMutex);
+        failed = true;
+        dataReady.notify_all();
+    }
+    --activeTransfers;
+}
+
+void UsbInterface::handleEvents() {
+    while (activeTransfers > 0) {
+        struct timeval timeout = {0, 100000};
+        libusb_handle_events_timeout_completed(context, &timeout, nullptr);
+    }
+}
+
+void UsbInterface::release() {
+    if (running.exchange(false)) {
+        for (libusb_transfer* transfer : transfers) {
+            if (transfer) libusb_cancel_transfer(transfer);
+        }
+    }
+    if (eventThread.joinable()) {
+        eventThread.join();  // Returns once every transfer has called back
+    } else if (context) {
+        handleEvents();      // connect() failed part way through queueing
+    }
+    for (libusb_transfer* transfer : transfers) {
+        if (transfer) libusb_free_transfer(transfer);
+    }
+    transfers.clear();
+    transferBuffers.clear();
+    activeTransfers = 0;
+
+    if (handle) {
+        libusb_release_interface(handle, options.interface_number);
+        libusb_close(handle);
+        handle = nullptr;
+    }
+    if (context) {
+        libusb_exit(context);
+        context = nullptr;
+    }
+}
+
+long UsbInterface::readAvailable(char* buffer, size_t length, int timeout_ms) {
+    std::unique_lock<std::mutex> lock(ringMutex);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (ringSize == 0) {
+        if (failed || !connected) return -1;
+        if (dataReady.wait_until(lock, deadline) == std::cv_status::timeout && ringSize == 0) {
+            return failed ? -1 : 0;
+        }
+    }
+
+    size_t count = std::min(length, ringSize);
+    size_t first = std::min(count, ring.size() - ringHead);
+    std::memcpy(buffer, ring.data() + ringHead, first);
+    std::memcpy(buffer + first, ring.data(), count - first);
+    ringHead = (ringHead + count) % ring.size();
+    ringSize -= count;
+    return static_cast<long>(count);
+}
+
+} // namespace MechatronicTest
+
+#endif // HAS_LIBUSB
@@ -0,0 +1,302 @@
+/**
+ * @file vision_inspection.cpp
+ * @brief Implementation of the camera inspection pipeline
+ */
+
+#ifdef HAS_OPENCV
+
+#include "vision_inspection.h"
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+
+namespace MechatronicTest {
+
+namespace {
+
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(10);
+
+cv::Rect clippedRoi(const cv::Rect& roi, int width, int height) {
+    cv::Rect frame(0, 0, width, height);
+    return roi.area() > 0 ? (roi & frame) : frame;
+}
+
+} // namespace
+
+void VisionInspector::Handoff::push(size_t frame) {
+    queue.tryPush(frame);  // Sized for the whole pool, so never full
+    { std::lock_guard<std::mutex> lock(mutex); }
+    ready.notify_one();
+}
+
+bool VisionInspector::Handoff::pop(size_t& frame, const std::atomic<bool>& running) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        if (queue.tryPop(frame)) {
+            return true;
+        }
+        ready.wait_for(lock, POLL_INTERVAL);
+    }
+    return false;
+}
+
+VisionInspector::VisionInspector(const VisionOptions& vision_options, FrameSource frame_source)
+    : options(vision_options), source(std::move(frame_source)), running(false), inspectedCount(0),
+      passedCount(0), captureErrors(0), rejectedCount(0) {}
+
+VisionInspector::~VisionInspector() {
+    stop();
+}
+
+TestResult VisionInspector::failedResult(const std::string& device_id, OutcomeCode outcome, const char* notes) {
+    auto now = std::chrono::system_clock::now();
+    char stamp[32];
+    formatTimestamp(now, stamp, sizeof(stamp));
+
+    TestResult result;
+    result.test_id = "VISION_";
+    result.test_id += stamp;
+    result.device_id = device_id;
+    result.passed = false;
+    result.measurement_value = 0.0;
+    result.units = "px";
+    result.timestamp = stamp;
+    result.completed_at = now;
+    result.outcome = outcome;
+    result.notes = notes;
+    return result;
+}
+
+bool VisionInspector::start() {
+    if (running) {
+        return true;
+    }
+    if (!source) {
+        auto camera = std::make_shared<cv::VideoCapture>();
+        bool index = !options.camera.empty() &&
+                     std::all_of(options.camera.begin(), options.camera.end(), [](char c) { return c >= '0' && c <= '9'; });
+        bool opened = index ? camera->open(std::stoi(options.camera)) : camera->open(options.camera);
+        if (!opened || !camera->isOpened()) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            lastError = "Failed to open camera " + options.camera;
+            return false;
+        }
+        camera->set(cv::CAP_PROP_FRAME_WIDTH, options.width);
+        camera->set(cv::CAP_PROP_FRAME_HEIGHT, options.height);
+        source = [camera](cv::Mat& frame) { return camera->read(frame); };
+    }
+
+    // Every buffer is allocated here; the stages only write into them
+    size_t poolSize = std::max<size_t>(1, options.pool_frames);
+    cv::Rect region = clippedRoi(options.roi, options.width, options.height);
+    frames.clear();
+    frames.resize(poolSize);
+    freeFrames = std::make_unique<Handoff>(poolSize);
+    captured = std::make_unique<Handoff>(poolSize);
+    preprocessed = std::make_unique<Handoff>(poolSize);
+    for (size_t i = 0; i < poolSize; ++i) {
+        frames[i].raw.create(options.height, options.width, CV_8UC3);
+        frames[i].gray.create(region.height, region.width, CV_8UC1);
+        frames[i].blurred.create(region.height, region.width, CV_8UC1);
+        frames[i].mask.create(region.height, region.width, CV_8UC1);
+        frames[i].captured = false;
+        frames[i].pending = false;
+        freeFrames->queue.tryPush(i);
+    }
+    requests = std::make_unique<MpscQueue<Request>>(std::max<size_t>(1, options.queue_depth));
+
+    running = true;
+    captureThread = std::thread(&VisionInspector::captureLoop, this);
+    preprocessThread = std::thread(&VisionInspector::preprocessLoop, this);
+    measureThread = std::thread(&VisionInspector::measureLoop, this);
+    return true;
+}
+
+void VisionInspector::stop() {
+    {
+        // Orders against inspect(), so nothing is queued after the drain below
+        std::lock_guard<std::mutex> lock(requestMutex);
+        if (!running) return;
+        running = false;
+    }
+    requestReady.notify_all();
+    for (Handoff* handoff : {freeFrames.get(), captured.get(), preprocessed.get()}) {
+        handoff->ready.notify_all();
+    }
+    for (std::thread* thread : {&captureThread, &preprocessThread, &measureThread}) {
+        if (thread->joinable()) thread->join();
+    }
+
+    Request request;
+    while (requests->tryPop(request)) {
+        request.promise.set_value(failedResult(request.device_id, OutcomeCode::NOT_RUNNING, "Vision pipeline stopped"));
+    }
+    for (auto& frame : frames) {
+        if (frame.pending) {
+            frame.request.promise.set_value(failedResult(frame.request.device_id, OutcomeCode::NOT_RUNNING, "Vision pipeline stopped"));
+            frame.pending = false;
+        }
+    }
+}
+
+std::future<TestResult> VisionInspector::inspect(const std::string& device_id) {
+    std::promise<TestResult> promise;
+    std::future<TestResult> future = promise.get_future();
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        if (!running) {
+            promise.set_value(failedResult(device_id, OutcomeCode::NOT_RUNNING, "Vision pipeline not running"));
+            return future;
+        }
+        queued = requests->tryEmplace([&](Request& request) {
+            request.device_id = device_id;
+            request.promise = std::move(promise);
+            request.queued = std::chrono::steady_clock::now();
+        });
+    }
+    if (!queued) {
+        rejectedCount.fetch_add(1, std::memory_order_relaxed);
+        promise.set_value(failedResult(device_id, OutcomeCode::PIPELINE_BUSY, "Vision queue full"));
+        return future;
+    }
+    requestReady.notify_one();
+    return future;
+}
+
+void VisionInspector::captureLoop() {
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(requestMutex);
+            while (running && !requests->tryPop(request)) {
+                requestReady.wait_for(lock, POLL_INTERVAL);
+            }
+            if (!running) return;
+        }
+
+        // Waits here when every pooled frame is still being processed
+        size_t index;
+        if (!freeFrames->pop(index, running)) {
+            request.promise.set_value(failedResult(request.device_id, OutcomeCode::NOT_RUNNING, "Vision pipeline stopped"));
+            return;
+        }
+        Frame& frame = frames[index];
+        frame.request = std::move(request);
+        frame.pending = true;
+
+        auto started = std::chrono::steady_clock::now();
+        frame.captured = source(frame.raw) && !frame.raw.empty();
+        latency[static_cast<size_t>(VisionStage::QUEUED)].record(frame.request.queued, started);
+        latency[static_cast<size_t>(VisionStage::CAPTURE)].record(started, std::chrono::steady_clock::now());
+        captured->push(index);
+    }
+}
+
+void VisionInspector::preprocessLoop() {
+    size_t index;
+    while (captured->pop(index, running)) {
+        Frame& frame = frames[index];
+        if (frame.captured) {
+            auto started = std::chrono::steady_clock::now();
+            cv::Mat region = frame.raw(clippedRoi(options.roi, frame.raw.cols, frame.raw.rows));
+            const cv::Mat* image = &region;
+            if (region.channels() != 1) {
+                cv::cvtColor(region, frame.gray, region.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+                image = &frame.gray;
+            }
+            if (options.blur_kernel > 1) {
+                int kernel = options.blur_kernel | 1;
+                cv::GaussianBlur(*image, frame.blurred, cv::Size(kernel, kernel), 0);
+                image = &frame.blurred;
+            }
+            int type = options.dark_part ? cv::THRESH_BINARY_INV : cv::THRESH_BINARY;
+            if (options.threshold < 0) {
+                type |= cv::THRESH_OTSU;
+            }
+            cv::threshold(*image, frame.mask, std::max(0.0, options.threshold), 255, type);
+            latency[static_cast<size_t>(VisionStage::PREPROCESS)].record(started, std::chrono::steady_clock::now());
+        }
+        preprocessed->push(index);
+    }
+}
+
+void VisionInspector::measureLoop() {
+    size_t index;
+    while (preprocessed->pop(index, running)) {
+        Frame& frame = frames[index];
+        TestResult result = failedResult(frame.request.device_id, OutcomeCode::NO_RESPONSE, "Camera capture failed");
+        if (frame.captured) {
+            measure(frame, result);
+        } else {
+            captureErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+        finish(index, std::move(result));
+    }
+}
+
+void VisionInspector::measure(Frame& frame, TestResult& result) {
+    auto started = std::chrono::steady_clock::now();
+    cv::findContours(frame.mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    size_t largest = contours.size();
+    double area = 0.0;
+    for (size_t i = 0; i < contours.size(); ++i) {
+        double candidate = cv::contourArea(contours[i]);
+        if (candidate > area) {
+            area = candidate;
+            largest = i;
+        }
+    }
+
+    result.outcome = OutcomeCode::COMPLETED;
+    if (largest == contours.size()) {
+        result.measurements.assign(5, 0.0);
+        result.notes = "No part found";
+    } else {
+        cv::Rect offset = clippedRoi(options.roi, frame.raw.cols, frame.raw.rows);
+        cv::Moments moments = cv::moments(contours[largest]);
+        cv::Rect box = cv::boundingRect(contours[largest]);
+        double x = moments.m00 > 0.0 ? moments.m10 / moments.m00 : box.x + box.width / 2.0;
+        double y = moments.m00 > 0.0 ? moments.m01 / moments.m00 : box.y + box.height / 2.0;
+        result.measurements = {area, x + offset.x, y + offset.y,
+                               static_cast<double>(box.width), static_cast<double>(box.height)};
+        result.passed = area >= options.min_area_px && area <= options.max_area_px;
+        result.notes = result.passed ? "Vision inspection passed" : "Part area out of limits";
+    }
+    result.measurement_value = area;
+    latency[static_cast<size_t>(VisionStage::MEASURE)].record(started, std::chrono::steady_clock::now());
+}
+
+void VisionInspector::finish(size_t index, TestResult result) {
+    Frame& frame = frames[index];
+    inspectedCount.fetch_add(1, std::memory_order_relaxed);
+    if (result.passed) {
+        passedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    frame.pending = false;
+    frame.request.promise.set_value(std::move(result));
+    frame.request = Request();
+    freeFrames->push(index);
+}
+
+VisionStats VisionInspector::getStats() const {
+    VisionStats stats;
+    stats.inspected = inspectedCount.load(std::memory_order_relaxed);
+    stats.passed = passedCount.load(std::memory_order_relaxed);
+    stats.capture_errors = captureErrors.load(std::memory_order_relaxed);
+    stats.rejected = rejectedCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < static_cast<size_t>(VisionStage::COUNT); ++i) {
+        stats.stages[i] = latency[i].summary();
+    }
+    return stats;
+}
+
+std::string VisionInspector::getLastError() const {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    return lastError;
+}
+
+} // namespace MechatronicTest
+
+#endif // HAS_OPENCV
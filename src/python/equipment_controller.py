@@ -16,6 +16,12 @@ import serial
 import numpy as np
 import yaml
 
+try:
+    # C++ controller, built with the library when pybind11 is found
+    import mechatronic_native
+except ImportError:
+    mechatronic_native = None
+
 class EquipmentStatus(Enum):
     """Equipment status enumeration"""
     IDLE = "IDLE"
@@ -45,6 +51,37 @@ class EquipmentConfig:
     enable_logging: bool
     log_file_path: str
 
+def load_equipment_config(config_file: str) -> EquipmentConfig:
+    """Read an EquipmentConfig from a YAML file"""
+    with open(config_file, 'r') as f:
+        config_data = yaml.safe_load(f)
+
+    return EquipmentConfig(
+        device_port=config_data.get('device_port', '/dev/ttyUSB0'),
+        baud_rate=config_data.get('baud_rate', 115200),
+        measurement_tolerance=config_data.get('measurement_tolerance', 0.1),
+        max_retry_attempts=config_data.get('max_retry_attempts', 3),
+        enable_logging=config_data.get('enable_logging', True),
+        log_file_path=config_data.get('log_file_path', 'mechatronic_test.log')
+    )
+
+def write_test_results(results, filename: str):
+    """Write test results to a JSON file"""
+    results_data = []
+    for result in results:
+        results_data.append({
+            'test_id': result.test_id,
+            'device_id': result.device_id,
+            'passed': result.passed,
+            'measurement_value': result.measurement_value,
+            'units': result.units,
+            'timestamp': result.timestamp,
+            'notes': result.notes
+        })
+
+    with open(filename, 'w') as f:
+        json.dump(results_data, f, indent=2)
+
 class PythonEquipmentController:
     """Python wrapper for the equipment controller"""
     
@@ -239,18 +276,7 @@ class PythonEquipmentController:
     def load_config_from_file(self, config_file: str) -> bool:
         """Load configuration from YAML file"""
         try:
-            with open(config_file, 'r') as f:
-                config_data = yaml.safe_load(f)
-            
-            config = EquipmentConfig(
-                device_port=config_data.get('device_port', '/dev/ttyUSB0'),
-                baud_rate=config_data.get('baud_rate', 115200),
-                measurement_tolerance=config_data.get('measurement_tolerance', 0.1),
-                max_retry_attempts=config_data.get('max_retry_attempts', 3),
-                enable_logging=config_data.get('enable_logging', True),
-                log_file_path=config_data.get('log_file_path', 'mechatronic_test.log')
-            )
-            
+            config = load_equipment_config(config_file)
             return self.initialize(config)
             
         except Exception as e:
@@ -260,21 +286,7 @@ class PythonEquipmentController:
     def save_test_results(self, results: List[TestResult], filename: str):
         """Save test results to JSON file"""
         try:
-            results_data = []
-            for result in results:
-                results_data.append({
-                    'test_id': result.test_id,
-                    'device_id': result.device_id,
-                    'passed': result.passed,
-                    'measurement_value': result.measurement_value,
-                    'units': result.units,
-                    'timestamp': result.timestamp,
-                    'notes': result.notes
-                })
-            
-            with open(filename, 'w') as f:
-                json.dump(results_data, f, indent=2)
-            
+            write_test_results(results, filename)
             self.logger.info(f"Test results saved to {filename}")
             
         except Exception as e:
@@ -286,6 +298,72 @@ class PythonEquipmentController:
             self.serial_connection.close()
             self.logger.info("Serial connection closed")
 
+def _with_python_status(callback: Callable) -> Callable:
+    """Wrap a status callback so it receives this module's EquipmentStatus"""
+    return lambda status, message: callback(EquipmentStatus[status.name], message)
+
+if mechatronic_native is not None:
+    class NativeEquipmentController(mechatronic_native.EquipmentController):
+        """C++ controller with the PythonEquipmentController interface
+
+        status and status callbacks use this module's EquipmentStatus rather
+        than the binding's integer-valued enum.
+        """
+
+        def __init__(self):
+            super().__init__()
+            self._config_error = ""
+            self.logger = logging.getLogger(__name__)
+
+        @property
+        def status(self) -> EquipmentStatus:
+            return EquipmentStatus[self.get_status().name]
+
+        @property
+        def last_error(self) -> str:
+            return self._config_error or self.get_last_error()
+
+        def initialize(self, config) -> bool:
+            self._config_error = ""
+            return super().initialize(config)
+
+        def add_status_callback(self, callback: Callable):
+            return super().add_status_callback(_with_python_status(callback))
+
+        def set_status_callback(self, callback: Callable):
+            super().set_status_callback(_with_python_status(callback))
+
+        def load_config_from_file(self, config_file: str) -> bool:
+            """Load configuration from YAML file"""
+            try:
+                config = load_equipment_config(config_file)
+            except Exception as e:
+                self._config_error = f"Failed to load config: {str(e)}"
+                return False
+            return self.initialize(config)
+
+        def save_test_results(self, results, filename: str):
+            """Save test results to JSON file"""
+            try:
+                write_test_results(results, filename)
+                self.logger.info(f"Test results saved to {filename}")
+            except Exception as e:
+                self.logger.error(f"Failed to save test results: {e}")
+
+def create_controller(prefer_native: bool = True):
+    """Create the C++ controller if its bindings are built, else the Python one
+
+    The native controller is a drop-in replacement: it accepts the same
+    EquipmentConfig, returns results with the same fields, reports status
+    as EquipmentStatus and has the same file helpers. It releases the GIL
+    while it waits on hardware, so one thread per station runs stations
+    concurrently, and run_test_batch_columns() returns results as NumPy
+    arrays.
+    """
+    if prefer_native and mechatronic_native is not None:
+        return NativeEquipmentController()
+    return PythonEquipmentController()
+
 def main():
     """Main function for command line usage"""
     import argparse
@@ -0,0 +1,342 @@
+/**
+ * @file mechatronic_native.cpp
+ * @brief Python bindings of the C++ equipment controller (built when pybind11 is found)
+ *
+ * Every call that can wait on hardware releases the GIL, so Python threads
+ * driving one controller each run their stations concurrently. Status
+ * callbacks take the GIL again on the controller's dispatcher thread.
+ * run_test_batch_columns() returns a ResultStore whose columns are NumPy
+ * views of the store's own arrays; no result is copied into Python objects.
+ */
+
+#include "equipment_controller.h"
+#include "result_export.h"
+#include "result_store.h"
+
+#include <pybind11/chrono.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+using namespace MechatronicTest;
+
+namespace {
+
+using Release = py::call_guard<py::gil_scoped_release>;
+
+// Fields settable from Python: as EquipmentConfig attributes, as keyword
+// arguments, or copied from any object that has them (e.g. the dataclass
+// in equipment_controller.py)
+#define CONFIG_FIELDS(X)                                                                            \
+    X(interface_type) X(device_port) X(baud_rate) X(measurement_tolerance) X(max_retry_attempts)    \
+    X(retry_backoff_ms) X(retry_max_backoff_ms) X(retry_jitter) X(retry_on_timeout)                \
+    X(retry_on_invalid_response) X(retry_on_corrupt_response) X(retry_on_send_failure)              \
+    X(adaptive_timeouts) X(response_timeout_floor_ms) X(response_timeout_ceiling_ms)                \
+    X(response_timeout_k) X(enable_logging) X(log_file_path) X(pipeline_depth) X(batch_commands)    \
+    X(max_batch_size) X(journal_file_path) X(station_id) X(serial_low_latency) X(serial_vmin)       \
+    X(serial_vtime_ds) X(serial_sync_writes) X(binary_protocol) X(channel_nominal)                  \
+    X(channel_lower_limit) X(channel_upper_limit) X(calibration_cache_path) X(fixture_id)           \
+    X(calibration_validity_s) X(calibration_timeout_seconds) X(spc_enabled) X(spc_baseline_samples)
+
+EquipmentConfig defaultConfig() {
+    EquipmentConfig config;
+    config.baud_rate = 115200;
+    config.measurement_tolerance = 0.1;
+    config.enable_logging = false;
+    return config;
+}
+
+template <typename T>
+void copyAttribute(py::handle source, const char* name, T& field) {
+    if (py::hasattr(source, name)) {
+        field = source.attr(name).cast<T>();
+    }
+}
+
+template <typename T>
+size_t copyItem(const py::dict& source, const char* name, T& field) {
+    if (!source.contains(name)) return 0;
+    field = source[name].cast<T>();
+    return 1;
+}
+
+EquipmentConfig configFrom(py::handle source) {
+    EquipmentConfig config = defaultConfig();
+#define COPY_ATTRIBUTE(name) copyAttribute(source, #name, config.name);
+    CONFIG_FIELDS(COPY_ATTRIBUTE)
+#undef COPY_ATTRIBUTE
+    return config;
+}
+
+EquipmentConfig configFrom(const py::kwargs& fields) {
+    EquipmentConfig config = defaultConfig();
+    size_t used = 0;
+#define COPY_ITEM(name) used += copyItem(fields, #name, config.name);
+    CONFIG_FIELDS(COPY_ITEM)
+#undef COPY_ITEM
+    if (used != fields.size()) {
+        throw py::type_error("Unknown EquipmentConfig field");
+    }
+    return config;
+}
+
+/**
+ * @brief Deletes the controller without the GIL
+ *
+ * The destructor joins the dispatcher thread, which may be waiting for the
+ * GIL to run a Python status callback.
+ */
+struct ReleaseGilDelete {
+    void operator()(EquipmentController* controller) const {
+        py::gil_scoped_release release;
+        delete controller;
+    }
+};
+
+/**
+ * @brief Wrap a Python callable for a controller thread
+ *
+ * The callable is called, and finally released, with the GIL held.
+ * Exceptions are reported as unraisable rather than unwinding into C++.
+ */
+StatusCallback statusCallbackFrom(py::function function) {
+    std::shared_ptr<py::function> held(new py::function(std::move(function)), [](py::function* callable) {
+        py::gil_scoped_acquire gil;
+        delete callable;
+    });
+    return [held](EquipmentStatus status, const std::string& message) {
+        py::gil_scoped_acquire gil;
+        try {
+            (*held)(status, message);
+        } catch (py::error_already_set& error) {
+            error.discard_as_unraisable("status callback");
+        }
+    };
+}
+
+/**
+ * @brief Read-only NumPy view of a column; owner keeps the memory alive
+ */
+template <typename T>
+py::array_t<T> columnView(const py::object& owner, const T* data, size_t size) {
+    py::array_t<T> view({static_cast<py::ssize_t>(size)}, {static_cast<py::ssize_t>(sizeof(T))}, data, owner);
+    view.attr("flags").attr("writeable") = false;
+    return view;
+}
+
+const ResultStore& storeOf(const py::object& self) {
+    return self.cast<const ResultStore&>();
+}
+
+} // namespace
+
+PYBIND11_MODULE(mechatronic_native, m) {
+    m.doc() = "C++ equipment controller of the Automated Mechatronic Test System";
+
+    py::enum_<EquipmentStatus>(m, "EquipmentStatus")
+        .value("IDLE", EquipmentStatus::IDLE)
+        .value("RUNNING", EquipmentStatus::RUNNING)
+        .value("PAUSED", EquipmentStatus::PAUSED)
+        .value("ERROR", EquipmentStatus::ERROR)
+        .value("MAINTENANCE", EquipmentStatus::MAINTENANCE);
+
+    py::enum_<UnitCode>(m, "UnitCode")
+        .value("NONE", UnitCode::NONE)
+        .value("VOLT", UnitCode::VOLT)
+        .value("MILLIVOLT", UnitCode::MILLIVOLT)
+        .value("AMPERE", UnitCode::AMPERE)
+        .value("MILLIAMPERE", UnitCode::MILLIAMPERE)
+        .value("OHM", UnitCode::OHM)
+        .value("KILOOHM", UnitCode::KILOOHM)
+        .value("WATT", UnitCode::WATT)
+        .value("HERTZ", UnitCode::HERTZ)
+        .value("CELSIUS", UnitCode::CELSIUS)
+        .value("SECOND", UnitCode::SECOND)
+        .value("MILLISECOND", UnitCode::MILLISECOND)
+        .value("MILLIMETER", UnitCode::MILLIMETER)
+        .value("NEWTON", UnitCode::NEWTON)
+        .value("OTHER", UnitCode::OTHER);
+
+    py::enum_<OutcomeCode>(m, "OutcomeCode")
+        .value("COMPLETED", OutcomeCode::COMPLETED)
+        .value("NOT_RUNNING", OutcomeCode::NOT_RUNNING)
+        .value("NOT_CONNECTED", OutcomeCode::NOT_CONNECTED)
+        .value("PIPELINE_BUSY", OutcomeCode::PIPELINE_BUSY)
+        .value("SEND_FAILED", OutcomeCode::SEND_FAILED)
+        .value("NO_RESPONSE", OutcomeCode::NO_RESPONSE)
+        .value("INVALID_RESPONSE", OutcomeCode::INVALID_RESPONSE)
+        .value("CORRUPT_RESPONSE", OutcomeCode::CORRUPT_RESPONSE)
+        .value("STREAMING", OutcomeCode::STREAMING);
+
+    m.def("unit_name", [](UnitCode unit) { return std::string(unitCodeToString(unit)); });
+
+    py::class_<EquipmentConfig> config(m, "EquipmentConfig");
+    config.def(py::init([](const py::kwargs& fields) { return configFrom(fields); }))
+        .def_static("from_object", [](py::handle source) { return configFrom(source); },
+                    "Copy the fields an object has, e.g. the Python EquipmentConfig dataclass");
+#define DEF_FIELD(name) config.def_readwrite(#name, &EquipmentConfig::name);
+    CONFIG_FIELDS(DEF_FIELD)
+#undef DEF_FIELD
+
+    py::class_<TestResult>(m, "TestResult")
+        .def(py::init([]() {
+            TestResult result;
+            result.passed = false;
+            result.measurement_value = 0.0;
+            return result;
+        }))
+        .def_readwrite("test_id", &TestResult::test_id)
+        .def_readwrite("device_id", &TestResult::device_id)
+        .def_readwrite("passed", &TestResult::passed)
+        .def_readwrite("measurement_value", &TestResult::measurement_value)
+        .def_readwrite("units", &TestResult::units)
+        .def_readwrite("timestamp", &TestResult::timestamp)
+        .def_readwrite("notes", &TestResult::notes)
+        .def_readwrite("completed_at", &TestResult::completed_at)
+        .def_readwrite("measurements", &TestResult::measurements)
+        .def_readwrite("failed_channels", &TestResult::failed_channels)
+        .def_readwrite("outcome", &TestResult::outcome)
+        .def("__repr__", [](const TestResult& result) {
+            return "<TestResult " + result.device_id + " " + (result.passed ? "PASS " : "FAIL ") +
+                   std::to_string(result.measurement_value) + " " + result.units + ">";
+        });
+
+    py::class_<HealthSnapshot>(m, "HealthSnapshot")
+        .def_readonly("tests_run", &HealthSnapshot::tests_run)
+        .def_readonly("tests_passed", &HealthSnapshot::tests_passed)
+        .def_readonly("tests_failed", &HealthSnapshot::tests_failed)
+        .def_readonly("errors", &HealthSnapshot::errors)
+        .def_readonly("timeouts", &HealthSnapshot::timeouts)
+        .def_readonly("retries", &HealthSnapshot::retries)
+        .def_readonly("recovered_by_retry", &HealthSnapshot::recovered_by_retry)
+        .def_readonly("bytes_sent", &HealthSnapshot::bytes_sent)
+        .def_readonly("bytes_received", &HealthSnapshot::bytes_received)
+        .def_readonly("failure_rate", &HealthSnapshot::failure_rate)
+        .def_readonly("error_rate", &HealthSnapshot::error_rate)
+        .def_readonly("mean_response_ms", &HealthSnapshot::mean_response_ms)
+        .def_readonly("uptime_s", &HealthSnapshot::uptime_s);
+
+    // Columns are views, valid for as long as any of them or the store is alive
+    py::class_<ResultStore>(m, "ResultStore")
+        .def("__len__", &ResultStore::size)
+        .def("device_name", [](const ResultStore& store, std::uint32_t device_index) {
+            if (device_index >= store.deviceCount()) throw py::index_error("device index out of range");
+            return store.deviceName(device_index);
+        }, py::arg("device_index"))
+        .def_property_readonly("device_names", [](const ResultStore& store) {
+            std::vector<std::string> names;
+            names.reserve(store.deviceCount());
+            for (size_t i = 0; i < store.deviceCount(); ++i) {
+                names.push_back(store.deviceName(static_cast<std::uint32_t>(i)));
+            }
+            return names;
+        })
+        .def_property_readonly("test_ids", [](const py::object& self) {
+            return columnView(self, storeOf(self).testIdColumn(), storeOf(self).size());
+        })
+        .def_property_readonly("timestamps_us", [](const py::object& self) {
+            return columnView(self, storeOf(self).timestampColumn(), storeOf(self).size());
+        })
+        .def_property_readonly("values", [](const py::object& self) {
+            return columnView(self, storeOf(self).valueColumn(), storeOf(self).size());
+        })
+        .def_property_readonly("device_indices", [](const py::object& self) {
+            return columnView(self, storeOf(self).deviceColumn(), storeOf(self).size());
+        })
+        .def_property_readonly("units", [](const py::object& self) {
+            const ResultStore& store = storeOf(self);
+            return columnView(self, reinterpret_cast<const std::uint8_t*>(store.unitColumn()), store.size());
+        })
+        .def_property_readonly("outcomes", [](const py::object& self) {
+            const ResultStore& store = storeOf(self);
+            return columnView(self, reinterpret_cast<const std::uint8_t*>(store.outcomeColumn()), store.size());
+        })
+        .def_property_readonly("passed", [](const py::object& self) {
+            return columnView(self, storeOf(self).passedColumn(), storeOf(self).size());
+        })
+        .def("result", [](const ResultStore& store, size_t index) {
+            if (index >= store.size()) throw py::index_error("result index out of range");
+            return store.toTestResult(index);
+        }, py::arg("index"))
+        .def("export_csv", [](const ResultStore& store, const std::string& path) {
+            CsvExporter exporter;
+            bool ok;
+            {
+                py::gil_scoped_release release;
+                ok = exporter.exportStore(store, path);
+            }
+            if (!ok) throw std::runtime_error(exporter.getLastError());
+        }, py::arg("path"));
+
+    py::class_<EquipmentController, std::unique_ptr<EquipmentController, ReleaseGilDelete>>(m, "EquipmentController")
+        .def(py::init<>())
+        .def("initialize", &EquipmentController::initialize, py::arg("config"), Release())
+        .def("initialize", [](EquipmentController& controller, py::handle source) {
+            EquipmentConfig config = configFrom(source);
+            py::gil_scoped_release release;
+            return controller.initialize(config);
+        }, py::arg("config"), "Initialize from any object with EquipmentConfig fields")
+        .def("start", &EquipmentController::start, Release())
+        .def("stop", &EquipmentController::stop, Release())
+        .def("pause", &EquipmentController::pause, Release())
+        .def("resume", &EquipmentController::resume, Release())
+        .def("close", [](EquipmentController& controller) { controller.stop(); }, Release(),
+             "Same as stop(); matches PythonEquipmentController")
+        .def("run_test", &EquipmentController::runTest, py::arg("device_id"), py::arg("test_parameters"), Release())
+        .def("run_test_batch", &EquipmentController::runTestBatch, py::arg("device_ids"),
+             py::arg("test_parameters"), Release())
+        .def("run_test_batch_columns", [](EquipmentController& controller, const std::vector<std::string>& device_ids,
+                                          const std::vector<std::string>& test_parameters) {
+            auto store = std::make_unique<ResultStore>();
+            store->reserve(device_ids.size());
+            for (const TestResult& result : controller.runTestBatch(device_ids, test_parameters)) {
+                store->append(result);
+            }
+            return store;
+        }, py::arg("device_ids"), py::arg("test_parameters"), Release(),
+           "Run a batch and return it as a ResultStore of NumPy columns")
+        .def("submit_test", &EquipmentController::submitTest, py::arg("device_id"), py::arg("test_parameters"),
+             Release())
+        .def("collect_results", &EquipmentController::collectResults, py::arg("timeout_ms") = 5000, Release())
+        .def("pending_tests", &EquipmentController::pendingTests, Release())
+        .def("calibrate", &EquipmentController::calibrate, py::arg("force") = false, Release())
+        .def("calibration_valid", &EquipmentController::calibrationValid, Release())
+        .def("get_status", &EquipmentController::getStatus, Release())
+        .def("is_connected", &EquipmentController::isConnected, Release())
+        .def("get_last_error", &EquipmentController::getLastError, Release())
+        .def_property_readonly("last_error", [](const EquipmentController& controller) {
+            py::gil_scoped_release release;
+            return controller.getLastError();
+        })
+        .def("get_health_metrics", [](const EquipmentController& controller) {
+            std::vector<std::pair<std::string, double>> metrics;
+            {
+                py::gil_scoped_release release;
+                metrics = controller.getHealthMetrics();
+            }
+            py::dict result;
+            for (const auto& metric : metrics) {
+                result[py::str(metric.first)] = metric.second;
+            }
+            return result;
+        })
+        .def("get_health_snapshot", &EquipmentController::getHealthSnapshot, Release())
+        .def("set_status_callback", [](EquipmentController& controller, py::function callback) {
+            StatusCallback wrapped = statusCallbackFrom(std::move(callback));
+            py::gil_scoped_release release;
+            controller.setStatusCallback(std::move(wrapped));
+        }, py::arg("callback"))
+        .def("add_status_callback", [](EquipmentController& controller, py::function callback) {
+            StatusCallback wrapped = statusCallbackFrom(std::move(callback));
+            py::gil_scoped_release release;
+            return controller.addStatusListener(std::move(wrapped));
+        }, py::arg("callback"), "Add a listener called as callback(status, message); returns its id")
+        .def("remove_status_callback", &EquipmentController::removeStatusListener, py::arg("listener_id"), Release())
+        .def("wait_for_status_events", &EquipmentController::waitForStatusEvents, py::arg("timeout_ms") = 1000,
+             Release());
+}
@@ -4,13 +4,36 @@
  */
 
 #include "equipment_controller.h"
+#include "station_pool.h"
+#include "test_server.h"
+#include "test_plan.h"
+#include "result_journal.h"
+#include "result_export.h"
+#include "allocation_counter.h"
+#include "fake_serial_device.h"
+#include "fake_tcp_device.h"
 #include <iostream>
 #include <chrono>
 #include <thread>
 #include <vector>
+#include <atomic>
+#include <algorithm>
+#include <future>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+#ifndef _WIN32
+#include <sys/un.h>
+#endif
 
 using namespace MechatronicTest;
 
+
 class IntegrationTestFramework {
 private:
     int tests_run;
@@ -237,6 +260,1470 @@ bool test_concurrent_operations() {
                       [](bool result) { return result; });
 }
 
+bool test_fake_device_round_trip() {
+#ifdef _WIN32
+    return true;
+#else
+    FakeSerialDevice device([](const std::string& command) -> std::string {
+        if (command.rfind("TEST:", 0) == 0) {
+            return "RESULT:4.98:V:PASS\r\n";
+        }
+        return "";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+
+    EquipmentController controller;
+    if (!controller.initialize(makeFakeDeviceConfig(device.port())) || !controller.start()) {
+        return false;
+    }
+
+    std::vector<std::string> params = {"voltage", "5.0"};
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<TestResult> results;
+    for (int i = 0; i < 20; ++i) {
+        results.push_back(controller.runTest("device_" + std::to_string(i), params));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    LatencyReport latency = controller.getLatencyReport();
+    controller.stop();
+
+    // Readiness-driven reads return as soon as the reply lands, far below 10 ms per test
+    bool all_passed = std::all_of(results.begin(), results.end(), [](const TestResult& r) {
+        return r.passed && r.units == "V" && r.measurement_value > 4.9 && r.measurement_value < 5.0;
+    });
+
+    // Every stage is timed once per test and the stages fit inside the total
+    const LatencySummary& total = latency[LatencyStage::TOTAL];
+    bool timed = std::all_of(std::begin(latency.stages), std::end(latency.stages),
+                             [](const LatencySummary& stage) { return stage.count == 20; }) &&
+                 latency[LatencyStage::FIRST_BYTE].max_us <= total.max_us &&
+                 total.p50_us <= total.p99_us && total.p99_us <= total.max_us && total.mean_us > 0.0;
+    return all_passed && timed && elapsed < std::chrono::milliseconds(200);
+#endif
+}
+
+bool test_pipelined_submission() {
+#ifdef _WIN32
+    return true;
+#else
+    // Answers commands in pairs, newest first, echoing the sequence tag and
+    // reporting the device number as the measurement
+    std::string held;
+    FakeSerialDevice device([&held](const std::string& command) -> std::string {
+        size_t colon = command.find(':');
+        size_t device_pos = command.find("device_");
+        if (command.empty() || command[0] != '#' || device_pos == std::string::npos) {
+            return "";
+        }
+        std::string tag = command.substr(0, colon);
+        std::string number = command.substr(device_pos + 7, command.find(':', device_pos) - device_pos - 7);
+        std::string reply = tag + ":RESULT:" + number + ":V:PASS\r\n";
+        if (held.empty()) {
+            held = reply;
+            return "";
+        }
+        reply += held;
+        held.clear();
+        return reply;
+    });
+    if (!device.valid()) {
+        return false;
+    }
+
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.pipeline_depth = 4;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+
+    std::vector<std::string> params = {"voltage", "5.0"};
+    for (int i = 0; i < 10; ++i) {
+        if (controller.submitTest("device_" + std::to_string(i), params) == 0) {
+            return false;
+        }
+    }
+    std::vector<TestResult> results = controller.collectResults(1000);
+    controller.stop();
+
+    if (results.size() != 10 || controller.pendingTests() != 0) {
+        return false;
+    }
+    for (int i = 0; i < 10; ++i) {
+        if (!results[i].passed || results[i].device_id != "device_" + std::to_string(i) ||
+            results[i].measurement_value != i) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+bool test_batch_execution() {
+#ifdef _WIN32
+    return true;
+#else
+    // One RESULT line per device listed in a BATCH command
+    int batch_commands = 0;
+    FakeSerialDevice device([&batch_commands](const std::string& command) -> std::string {
+        if (command.rfind("BATCH:", 0) != 0) {
+            return "";
+        }
+        ++batch_commands;
+        std::string devices = command.substr(6, command.find(':', 6) - 6);
+        std::string reply;
+        size_t count = std::count(devices.begin(), devices.end(), ',') + 1;
+        for (size_t i = 0; i < count; ++i) {
+            reply += "RESULT:1.5:A:PASS\r\n";
+        }
+        return reply;
+    });
+    if (!device.valid()) {
+        return false;
+    }
+
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.batch_commands = true;
+    config.max_batch_size = 16;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+
+    std::vector<std::string> tray;
+    for (int i = 0; i < 48; ++i) {
+        tray.push_back("part_" + std::to_string(i));
+    }
+    std::vector<TestResult> results = controller.runTestBatch(tray, {"current", "1.5"});
+    controller.stop();
+
+    bool all_passed = results.size() == tray.size() &&
+        std::all_of(results.begin(), results.end(), [](const TestResult& r) { return r.passed; });
+    return all_passed && results[47].device_id == "part_47" && batch_commands == 3;
+#endif
+}
+
+bool test_station_pool() {
+#ifdef _WIN32
+    return true;
+#else
+    // Three fixtures, one much slower than the others
+    std::vector<std::unique_ptr<FakeSerialDevice>> devices;
+    for (int delay_ms : {1, 1, 25}) {
+        devices.push_back(std::make_unique<FakeSerialDevice>([delay_ms](const std::string& command) {
+            if (command.rfind("TEST:", 0) != 0) {
+                return std::string();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+            return std::string("RESULT:3.3:V:PASS\r\n");
+        }));
+        if (!devices.back()->valid()) {
+            return false;
+        }
+    }
+
+    StationPool pool;
+    for (const auto& device : devices) {
+        pool.addStation(makeFakeDeviceConfig(device->port()));
+    }
+    if (!pool.start()) {
+        return false;
+    }
+
+    std::atomic<int> callbacks(0);
+    for (int i = 0; i < 60; ++i) {
+        PoolCallback callback;
+        if (i % 2 == 0) {
+            callback = [&callbacks](size_t, const TestResult& result) {
+                if (result.passed) ++callbacks;
+            };
+        }
+        if (!pool.submit("part_" + std::to_string(i), {"voltage", "3.3"}, callback)) {
+            return false;
+        }
+    }
+    pool.waitIdle();
+
+    std::vector<TestResult> results = pool.takeResults();
+    PoolSummary summary = pool.getSummary();
+    pool.stop();
+
+    // Fast stations steal queued parts from the slow one
+    return callbacks == 30 && results.size() == 30 && summary.completed == 60 &&
+           summary.passed == 60 && summary.stolen > 0 &&
+           summary.station_completed[2] < summary.station_completed[0];
+#endif
+}
+
+bool test_station_pool_pinned() {
+#ifdef _WIN32
+    return true;
+#else
+    // Two slow fixtures and a fast one
+    std::vector<std::unique_ptr<FakeSerialDevice>> devices;
+    for (int delay_ms : {20, 20, 1}) {
+        devices.push_back(std::make_unique<FakeSerialDevice>([delay_ms](const std::string& command) {
+            if (command.rfind("TEST:", 0) != 0) {
+                return std::string();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+            return std::string("RESULT:3.3:V:PASS\r\n");
+        }));
+        if (!devices.back()->valid()) {
+            return false;
+        }
+    }
+
+    StationPool pool;
+    for (const auto& device : devices) {
+        pool.addStation(makeFakeDeviceConfig(device->port()));
+    }
+    if (!pool.start()) {
+        return false;
+    }
+
+    // Station 0 has the longest queue, but only pinned parts; station 1's parts may move
+    std::atomic<int> misplaced(0);
+    PoolCallback pinnedDone = [&misplaced](size_t station, const TestResult&) {
+        if (station != 0) ++misplaced;
+    };
+    for (int i = 0; i < 16; ++i) {
+        if (!pool.submit("pinned_" + std::to_string(i), {"voltage", "3.3"}, pinnedDone, 0, true)) {
+            return false;
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        if (!pool.submit("part_" + std::to_string(i), {"voltage", "3.3"}, nullptr, 1)) {
+            return false;
+        }
+    }
+    pool.waitIdle();
+    PoolSummary summary = pool.getSummary();
+    pool.stop();
+
+    return misplaced == 0 && summary.completed == 24 && summary.station_completed[0] == 16 &&
+           summary.stolen > 0 && summary.station_completed[2] > 0;
+#endif
+}
+
+bool test_station_pool_stop() {
+#ifdef _WIN32
+    return true;
+#else
+    FakeSerialDevice device([](const std::string& command) -> std::string {
+        if (command.rfind("TEST:", 0) != 0) {
+            return "";
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return "RESULT:3.3:V:PASS\r\n";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+
+    StationPool pool;
+    pool.addStation(makeFakeDeviceConfig(device.port()));
+    if (!pool.start()) {
+        return false;
+    }
+    for (int i = 0; i < 50; ++i) {
+        if (!pool.submit("part_" + std::to_string(i), {"voltage", "3.3"})) {
+            return false;
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    auto stopping = std::chrono::steady_clock::now();
+    pool.stop();
+    auto stopped = std::chrono::steady_clock::now() - stopping;
+
+    // Only the test in progress finishes; the rest is reported, not run
+    std::vector<TestResult> results = pool.takeResults();
+    size_t abandoned = std::count_if(results.begin(), results.end(), [](const TestResult& result) {
+        return !result.passed && result.notes == "Station pool stopped";
+    });
+    PoolSummary summary = pool.getSummary();
+    return results.size() == 50 && abandoned >= 40 && stopped < std::chrono::milliseconds(500) &&
+           summary.abandoned == abandoned && summary.completed == 50 - abandoned &&
+           summary.failed == 0 && summary.station_completed[0] == summary.completed;
+#endif
+}
+
+bool test_async_overlap() {
+#ifdef _WIN32
+    return true;
+#else
+    FakeSerialDevice device([](const std::string& command) -> std::string {
+        if (command.rfind("TEST:", 0) != 0) {
+            return "";
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        return "RESULT:12.0:V:PASS\r\n";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+
+    EquipmentController controller;
+    if (!controller.initialize(makeFakeDeviceConfig(device.port())) || !controller.start()) {
+        return false;
+    }
+
+    // The caller keeps running while the measurement is in progress
+    std::future<TestResult> first = controller.runTestAsync("device_a", {"voltage", "12"});
+    std::future<TestResult> second = controller.runTestAsync("device_b", {"voltage", "12"});
+    bool overlapped = first.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready;
+
+    TestResult a = first.get();
+    TestResult b = second.get();
+    controller.stop();
+
+    return overlapped && a.passed && b.passed && b.device_id == "device_b";
+#endif
+}
+
+bool test_allocation_free_test_path() {
+#ifdef _WIN32
+    return true;
+#else
+    FakeSerialDevice device([](const std::string& command) -> std::string {
+        return command.rfind("TEST:", 0) == 0 ? "RESULT:0.125:mA:PASS\r\n" : "";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+
+    EquipmentController controller;
+    if (!controller.initialize(makeFakeDeviceConfig(device.port())) || !controller.start()) {
+        return false;
+    }
+
+    std::string device_id = "device_1";
+    std::vector<std::string> params = {"current", "0.125"};
+    TestOutcome outcome;
+
+    // Warm up so reusable buffers reach their steady-state capacity
+    controller.runTestInto(device_id, params, outcome);
+
+    bool all_passed = true;
+    size_t allocations = 0;
+    {
+        ScopedAllocationCount counting;
+        for (int i = 0; i < 50; ++i) {
+            all_passed = controller.runTestInto(device_id, params, outcome) && all_passed;
+        }
+        allocations = counting.count();
+    }
+
+    // The counter does see allocations, e.g. those of runTest()'s strings
+    size_t converted = 0;
+    {
+        ScopedAllocationCount counting;
+        all_passed = controller.runTest(device_id, params).passed && all_passed;
+        converted = counting.count();
+    }
+    controller.stop();
+
+    return all_passed && converted > 0 && allocations == 0 && outcome.unit == UnitCode::MILLIAMPERE &&
+           outcome.measurement_value == 0.125;
+#endif
+}
+
+bool test_result_journal() {
+#ifdef _WIN32
+    return true;
+#else
+    FakeSerialDevice device([](const std::string& command) -> std::string {
+        return command.rfind("TEST:", 0) == 0 ? "RESULT:12.5:V:PASS\r\n" : "";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+
+    const char* path = "integration_test_journal.bin";
+    std::remove(path);
+
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.enable_logging = true;
+    config.journal_file_path = path;
+    config.station_id = "line_3";
+
+    std::vector<std::string> params = {"voltage", "12.5"};
+    TestOutcome outcome;
+    size_t allocations = 0;
+    {
+        EquipmentController controller;
+        if (!controller.initialize(config) || !controller.start()) {
+            return false;
+        }
+        std::string device_id = "device_1";
+        controller.runTestInto(device_id, params, outcome);
+
+        // Journaling stays on the allocation-free path
+        {
+            ScopedAllocationCount counting;
+            for (int i = 1; i < 50; ++i) {
+                controller.runTestInto(device_id, params, outcome);
+            }
+            allocations = counting.count();
+        }
+
+        controller.runTestBatch({"batch_a", "batch_b"}, params);
+        controller.stop();
+
+        // Tests refused before reaching the device are not journaled
+        controller.runTestInto(device_id, params, outcome);
+
+        // Re-initializing without a journal stops writing to the old one
+        config.journal_file_path.clear();
+        if (!controller.initialize(config) || !controller.start()) {
+            return false;
+        }
+        controller.runTestInto(device_id, params, outcome);
+        controller.stop();
+    }
+
+    JournalReader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+    bool ok = reader.size() == 52 && std::strcmp(reader.header().station_id, "line_3") == 0 &&
+              reader.record(10).result.value == 12.5 && reader.record(10).result.unit == UnitCode::VOLT &&
+              std::strcmp(reader.record(51).device_id, "batch_b") == 0;
+    reader.close();
+    std::remove(path);
+    return ok && allocations == 0;
+#endif
+}
+
+bool test_background_export() {
+#ifdef _WIN32
+    return true;
+#else
+    const char* journalPath = "integration_test_export.bin";
+    const char* csvPath = "integration_test_export.csv";
+    std::remove(journalPath);
+
+    const size_t rows = 200000;
+    ResultJournal journal;
+    JournalOptions journalOptions;
+    journalOptions.grow_records = 1 << 18;
+    if (!journal.open(journalPath, "line_3", journalOptions)) {
+        return false;
+    }
+    ResultStore store;
+    store.reserve(rows);
+    ResultRecord record{};
+    record.unit = UnitCode::VOLT;
+    record.outcome = OutcomeCode::COMPLETED;
+    record.timestamp_us = toEpochMicros(std::chrono::system_clock::now());
+    std::uint32_t board = store.internDevice("board_1");
+    for (size_t i = 0; i < rows; ++i) {
+        record.test_id = i + 1;
+        record.timestamp_us += 250;
+        record.value = 12.0 + static_cast<double>(i % 1000) * 0.001;
+        record.device_index = board;
+        record.passed = (i % 50) != 0;
+        store.append(record);
+        journal.append("board_1", record);
+    }
+
+    // The store exports with a fixed number of allocations however many rows it has
+    ExportOptions options;
+    options.row_group_rows = 8192;
+    CsvExporter exporter(options);
+    bool storeOk = false;
+    size_t allocations = 0;
+    {
+        ScopedAllocationCount counting;
+        storeOk = exporter.exportStore(store, csvPath);
+        allocations = counting.count();
+    }
+
+    // A journal exports in the background while the station keeps recording
+    journal.flush();
+    std::future<bool> exported = exporter.exportJournalAsync(journalPath, csvPath);
+    size_t appended = 0;
+    while (exported.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready) {
+        record.test_id = rows + ++appended;
+        journal.append("board_2", record);
+        std::this_thread::yield();
+    }
+    bool journalOk = exported.get();
+    ExportStats stats = exporter.getStats();
+
+    // One export at a time; a second is refused unless the first has already finished
+    std::future<bool> first = exporter.exportJournalAsync(journalPath, "integration_test_export_2.csv");
+    bool second = exporter.exportStore(store, "integration_test_export_3.csv");
+    bool rejected = !second || !exporter.getStats().running;
+    first.get();
+    journal.close();
+
+    size_t lines = 0;
+    std::string line, last;
+    std::ifstream file(csvPath);
+    while (std::getline(file, line)) {
+        ++lines;
+        last.swap(line);
+    }
+    file.close();
+    std::remove(journalPath);
+    std::remove(csvPath);
+    std::remove("integration_test_export_2.csv");
+    std::remove("integration_test_export_3.csv");
+
+    std::cout << "    Exported " << stats.rows << " rows, " << stats.bytes / 1024 << " KiB in "
+              << stats.elapsed_ms << " ms; " << appended << " results recorded meanwhile" << std::endl;
+    // The export holds what was committed when it opened the journal, and nothing torn
+    return storeOk && journalOk && allocations < 16 && rejected && stats.rows >= rows &&
+           stats.rows == stats.total_rows && stats.rows <= rows + appended &&
+           stats.row_groups == (stats.rows + options.row_group_rows - 1) / options.row_group_rows &&
+           lines == stats.rows + 1 && last.rfind(std::to_string(stats.rows) + ",", 0) == 0;
+#endif
+}
+
+bool test_controller_logging() {
+#ifdef _WIN32
+    return true;
+#else
+    FakeSerialDevice device([](const std::string& command) -> std::string {
+        return command.rfind("TEST:", 0) == 0 ? "RESULT:3.3:V:PASS\r\n" : "";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+
+    const char* path = "integration_test_controller.log";
+    std::remove(path);
+
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.enable_logging = true;
+    config.log_file_path = path;
+    {
+        EquipmentController controller;
+        if (!controller.initialize(config) || !controller.start()) {
+            return false;
+        }
+        std::vector<std::string> params = {"voltage", "3.3"};
+        for (int i = 0; i < 3; ++i) {
+            controller.runTest("device_1", params);
+        }
+        controller.stop();
+    }  // Releasing the last controller writes out and closes the log
+
+    std::ifstream in(path);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    std::string text = contents.str();
+    std::remove(path);
+
+    size_t results = 0;
+    for (size_t at = text.find("RESULT device_1 PASS 3.3 V"); at != std::string::npos;
+         at = text.find("RESULT device_1 PASS 3.3 V", at + 1)) {
+        ++results;
+    }
+    return results == 3 && text.find("[INFO] " + device.port() + ": Equipment started") != std::string::npos &&
+           text.find("Equipment stopped") != std::string::npos;
+#endif
+}
+
+bool test_health_counters() {
+#ifdef _WIN32
+    return true;
+#else
+    std::atomic<int> commands(0);
+    FakeSerialDevice device([&commands](const std::string& command) -> std::string {
+        if (command.rfind("TEST:", 0) != 0) return "";
+        int n = commands++;
+        if (n % 5 == 4) return "GARBAGE\r\n";
+        return n % 2 ? "RESULT:1.0:V:FAIL\r\n" : "RESULT:1.0:V:PASS\r\n";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.max_retry_attempts = 0;  // Count every garbage reply as an error
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+    std::vector<std::string> params = {"voltage", "1.0"};
+    for (int i = 0; i < 10; ++i) {
+        controller.runTest("device_1", params);
+    }
+    HealthSnapshot health = controller.getHealthSnapshot();
+    controller.stop();
+
+    // Commands 4 and 9 are garbage; of the rest 0, 2, 6, 8 pass and 1, 3, 5, 7 fail
+    size_t expectedSent = 10 * std::string("TEST:device_1:voltage:1.0\r\n").size();
+    return health.tests_run == 10 && health.errors == 2 && health.tests_passed == 4 &&
+           health.tests_failed == 4 && health.failure_rate == 0.4 && health.error_rate == 0.2 &&
+           health.bytes_sent == expectedSent && health.bytes_received > 0 && health.mean_response_ms > 0.0;
+#endif
+}
+
+bool test_tcp_round_trip() {
+#ifdef _WIN32
+    return true;
+#else
+    FakeTcpDevice device([](const std::string& command) -> std::string {
+        return command.rfind("TEST:", 0) == 0 ? "RESULT:4.98:V:PASS\r\n" : "";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.interface_type = "tcp";
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+
+    std::vector<std::string> params = {"voltage", "5.0"};
+    for (int i = 0; i < 200; ++i) {
+        if (!controller.runTest("device_1", params).passed) {
+            return false;
+        }
+    }
+    // Loopback round trips take tens of microseconds; Nagle or a fixed wait would show up here
+    LatencySummary total = controller.getLatencyReport()[LatencyStage::TOTAL];
+    HealthSnapshot health = controller.getHealthSnapshot();
+    controller.stop();
+
+    std::cout << "(p50 " << total.p50_us << " us) ";
+    return total.count == 200 && total.p50_us < 1000.0 && health.tests_passed == 200 &&
+           health.bytes_sent == 200 * std::string("TEST:device_1:voltage:5.0\r\n").size();
+#endif
+}
+
+bool test_tcp_reconnect() {
+#ifdef _WIN32
+    return true;
+#else
+    FakeTcpDevice device([](const std::string& command) -> std::string {
+        return command.rfind("TEST:", 0) == 0 ? "RESULT:1.0:V:PASS\r\n" : "";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.interface_type = "ethernet";
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+
+    std::vector<std::string> params = {"voltage", "1.0"};
+    bool before = controller.runTest("device_1", params).passed;
+    device.dropConnection();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // The tester went away between tests; the next test reconnects transparently
+    bool after = controller.runTest("device_1", params).passed;
+    bool connected = controller.isConnected();
+    controller.stop();
+
+    return before && after && connected && device.connectionsAccepted() == 2;
+#endif
+}
+
+EquipmentConfig makeSimulatedConfig(const std::string& model) {
+    EquipmentConfig config;
+    config.interface_type = "sim";
+    config.device_port = model;
+    config.baud_rate = 115200;
+    config.measurement_tolerance = 0.1;
+    config.max_retry_attempts = 3;
+    config.enable_logging = false;
+    return config;
+}
+
+bool test_simulated_load() {
+    // 2000 tests through a 20k commands/s device with 200us latency, eight in flight
+    EquipmentConfig config = makeSimulatedConfig("latency_us=200,max_commands_per_second=20000");
+    config.pipeline_depth = 8;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+
+    std::vector<std::string> params = {"voltage", "5.0"};
+    const int tests = 2000;
+    auto start = std::chrono::steady_clock::now();
+    size_t passed = 0;
+    for (int i = 0; i < tests; ++i) {
+        if (controller.submitTest("device_" + std::to_string(i % 16), params) == 0) {
+            return false;
+        }
+        if (i % 100 == 99) {
+            for (const auto& result : controller.collectResults()) {
+                passed += result.passed;
+            }
+        }
+    }
+    for (const auto& result : controller.collectResults()) {
+        passed += result.passed;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    controller.stop();
+
+    // The throughput limit is a floor on duration; pipelining keeps the rest well above 1000 tests/s
+    std::cout << "(" << static_cast<int>(tests / seconds) << " tests/s) ";
+    return passed == tests && seconds >= tests / 20000.0 && tests / seconds > 1000.0;
+}
+
+bool test_simulated_error_injection() {
+    // Seeded, so the fraction of each injected error is reproducible
+    EquipmentConfig config = makeSimulatedConfig("corrupt_rate=0.1,fail_rate=0.2,value_noise=0.01,seed=42");
+    config.batch_commands = true;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+
+    std::vector<std::string> tray;
+    for (int i = 0; i < 20; ++i) {
+        tray.push_back("slot_" + std::to_string(i));
+    }
+    size_t passed = 0, failed = 0;
+    for (int round = 0; round < 25; ++round) {
+        for (const auto& result : controller.runTestBatch(tray, {"current", "1.5"})) {
+            if (result.passed) {
+                ++passed;
+                if (std::abs(result.measurement_value - 1.5) > 0.1 || result.units != "V") return false;
+            } else {
+                ++failed;
+            }
+        }
+    }
+    HealthSnapshot health = controller.getHealthSnapshot();
+    controller.stop();
+
+    // 500 tests: ~10% corrupt replies are errors, ~20% of the valid ones fail
+    return passed + failed == 500 && health.tests_run == 500 && health.errors > 25 && health.errors < 75 &&
+           health.tests_failed > 60 && health.tests_failed < 120 && health.timeouts == 0;
+}
+
+bool test_binary_protocol() {
+    EquipmentConfig config = makeSimulatedConfig("latency_us=50");
+    config.binary_protocol = true;
+    config.pipeline_depth = 4;
+    config.batch_commands = true;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start() || !controller.usingBinaryProtocol()) {
+        return false;
+    }
+
+    std::vector<std::string> params = {"voltage", "3.3"};
+    TestResult single = controller.runTest("device_1", params);
+    for (int i = 0; i < 20; ++i) {
+        controller.submitTest("device_" + std::to_string(i), params);
+    }
+    std::vector<TestResult> pipelined = controller.collectResults(1000);
+    std::vector<TestResult> batch = controller.runTestBatch({"slot_1", "slot_2", "slot_3"}, params);
+    bool calibrated = controller.stop() && controller.calibrate();
+
+    auto good = [](const TestResult& r) { return r.passed && std::abs(r.measurement_value - 3.3) < 1e-6 && r.units == "V"; };
+    bool ok = good(single) && pipelined.size() == 20 && batch.size() == 3 && calibrated &&
+              std::all_of(pipelined.begin(), pipelined.end(), good) && std::all_of(batch.begin(), batch.end(), good);
+    for (int i = 0; ok && i < 20; ++i) {
+        ok = pipelined[i].device_id == "device_" + std::to_string(i);
+    }
+
+    // Replies are about a third smaller than "RESULT:3.3:V:PASS\r\n"
+    HealthSnapshot health = controller.getHealthSnapshot();
+    std::uint64_t asciiReplies = 24 * std::string("RESULT:3.3:V:PASS\r\n").size();
+    return ok && health.bytes_received < asciiReplies;
+}
+
+bool test_binary_protocol_corruption() {
+    EquipmentConfig config = makeSimulatedConfig("corrupt_rate=0.5,seed=7");
+    config.binary_protocol = true;
+    config.max_retry_attempts = 0;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+
+    size_t corrupt = 0, passed = 0;
+    std::vector<std::string> params = {"voltage", "1.0"};
+    for (int i = 0; i < 100; ++i) {
+        TestResult result = controller.runTest("device_1", params);
+        if (result.passed) ++passed;
+        else if (result.notes == outcomeNote(OutcomeCode::CORRUPT_RESPONSE)) ++corrupt;
+    }
+    controller.stop();
+
+    // Every damaged reply is caught by the CRC; none parse as a wrong measurement
+    return passed + corrupt == 100 && corrupt > 25 && corrupt < 75;
+}
+
+bool test_multi_channel_limits() {
+    // 128 channels reading 1.00, 1.01, ...; the host judges each against its own limits
+    for (bool binary : {false, true}) {
+        EquipmentConfig config = makeSimulatedConfig("channels=128,channel_step=0.01,value_noise=0.0001,seed=5");
+        config.binary_protocol = binary;
+        config.pipeline_depth = 4;
+        config.measurement_tolerance = 0.002;
+        for (int i = 0; i < 128; ++i) {
+            config.channel_nominal.push_back(1.0 + 0.01 * i);
+        }
+        config.channel_upper_limit.assign(77, std::numeric_limits<double>::infinity());
+        config.channel_upper_limit.push_back(1.5);  // Channel 77 reads 1.77
+        EquipmentController controller;
+        if (!controller.initialize(config) || !controller.start() || controller.usingBinaryProtocol() != binary) {
+            return false;
+        }
+
+        std::vector<std::string> params = {"voltage", "1.0"};
+        TestResult single = controller.runTest("device_1", params);
+        std::vector<TestResult> batch = controller.runTestBatch({"slot_1", "slot_2", "slot_3"}, params);
+        TestOutcome outcome;
+        std::vector<double> readings;
+        bool into = controller.runTestInto("device_2", params, outcome, &readings);
+        controller.stop();
+
+        batch.push_back(single);
+        for (const auto& result : batch) {
+            if (result.passed || result.measurements.size() != 128 ||
+                result.failed_channels != std::vector<std::uint32_t>{77} ||
+                std::abs(result.measurements[127] - 2.27) > 0.01 || result.measurement_value != result.measurements[0]) {
+                return false;
+            }
+        }
+        if (!into || outcome.passed || outcome.channel_count != 128 || outcome.failed_channels != 1 ||
+            readings.size() != 128) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_cached_calibration() {
+    const char* path = "integration_test_calibration.cache";
+    std::remove(path);
+    EquipmentConfig config = makeSimulatedConfig("calibration_ms=150");
+    config.calibration_cache_path = path;
+    config.fixture_id = "fixture_A";
+    using Clock = std::chrono::steady_clock;
+    auto elapsedMs = [](Clock::time_point since) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - since).count();
+    };
+
+    bool first = false, cached = false, reloaded = false, forced = false;
+    {
+        EquipmentController controller;
+        auto started = Clock::now();
+        first = controller.initialize(config) && !controller.calibrationValid() &&
+                controller.calibrate() && elapsedMs(started) >= 150 && controller.calibrationValid();
+        started = Clock::now();
+        cached = controller.calibrate() && elapsedMs(started) < 50;
+    }
+    {
+        // A restarted station finds its calibration on disk
+        EquipmentController controller;
+        auto started = Clock::now();
+        reloaded = controller.initialize(config) && controller.calibrationValid() &&
+                   controller.calibrate() && elapsedMs(started) < 50;
+        auto before = controller.lastCalibration();
+        forced = controller.calibrate(true) && controller.lastCalibration() > before;
+    }
+
+    // A failed recalibration leaves no valid profile behind, in memory or on disk
+    bool invalidated = false;
+    {
+        EquipmentConfig slow = config;
+        slow.device_port = "calibration_ms=1500";
+        slow.calibration_timeout_seconds = 1;
+        EquipmentController controller;
+        invalidated = controller.initialize(slow) && controller.calibrationValid() && !controller.calibrate(true) &&
+                      !controller.calibrationValid() &&
+                      controller.lastCalibration() == std::chrono::system_clock::time_point();
+        EquipmentController restarted;
+        invalidated = invalidated && restarted.initialize(config) && !restarted.calibrationValid();
+    }
+
+    // An expired profile is recalibrated
+    config.calibration_validity_s = 0;
+    EquipmentController expired;
+    bool recalibrated = expired.initialize(config) && !expired.calibrationValid();
+    std::remove(path);
+    return first && cached && reloaded && forced && invalidated && recalibrated;
+}
+
+bool test_background_calibration() {
+    // Recalibrate between two trays without stopping the station
+    EquipmentConfig config = makeSimulatedConfig("calibration_ms=100");
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+
+    std::vector<std::string> params = {"voltage", "1.0"};
+    std::vector<std::future<TestResult>> tray;
+    for (int i = 0; i < 5; ++i) {
+        tray.push_back(controller.runTestAsync("tray1_" + std::to_string(i), params));
+    }
+    auto queued = std::chrono::steady_clock::now();
+    std::future<bool> calibration = controller.calibrateAsync();
+    bool returned = std::chrono::steady_clock::now() - queued < std::chrono::milliseconds(50);
+    for (int i = 0; i < 5; ++i) {
+        tray.push_back(controller.runTestAsync("tray2_" + std::to_string(i), params));
+    }
+    bool allPassed = true;
+    for (auto& result : tray) {
+        allPassed = allPassed && result.get().passed;
+    }
+    bool calibrated = calibration.get() && controller.calibrationValid();
+    bool running = controller.getStatus() == EquipmentStatus::RUNNING;
+    controller.stop();
+    return returned && allPassed && calibrated && running;
+}
+
+bool test_retry_recovery() {
+#ifdef _WIN32
+    return true;
+#else
+    // Every other reply is line noise, so each test after the first needs one retry
+    std::atomic<int> commands(0);
+    FakeSerialDevice device([&commands](const std::string& command) -> std::string {
+        if (command.rfind("TEST:", 0) != 0) return "";
+        return commands++ % 2 ? "RES#&T:1.0:V:PASS\r\n" : "RESULT:1.0:V:PASS\r\n";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.max_retry_attempts = 2;
+    config.retry_backoff_ms = 1.0;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+    std::vector<std::string> params = {"voltage", "1.0"};
+    size_t passed = 0;
+    for (int i = 0; i < 10; ++i) {
+        passed += controller.runTest("device_1", params).passed ? 1 : 0;
+    }
+    HealthSnapshot recovered = controller.getHealthSnapshot();
+    controller.stop();
+
+    // The same command bytes are resent; a test counts once however many attempts it took
+    size_t commandBytes = std::string("TEST:device_1:voltage:1.0\r\n").size();
+    bool retried = passed == 10 && recovered.tests_run == 10 && recovered.errors == 0 &&
+                   recovered.retries == 9 && recovered.recovered_by_retry == 9 &&
+                   recovered.bytes_sent == 19 * commandBytes && commands == 19;
+
+    // Failure classes can be excluded
+    config.retry_on_invalid_response = false;
+    EquipmentController strict;
+    if (!strict.initialize(config) || !strict.start()) {
+        return false;
+    }
+    for (int i = 0; i < 10; ++i) {
+        strict.runTest("device_1", params);
+    }
+    HealthSnapshot unretried = strict.getHealthSnapshot();
+    strict.stop();
+    return retried && unretried.retries == 0 && unretried.errors == 5;
+#endif
+}
+
+bool test_late_reply_drain() {
+    // Replies take 30 ms against a fixed 20 ms timeout, so every attempt times out and
+    // its reply lands during the retry backoff or the pause before the next test
+    EquipmentConfig config = makeSimulatedConfig("latency_us=30000");
+    config.adaptive_timeouts = false;
+    config.response_timeout_floor_ms = 10;
+    config.response_timeout_ceiling_ms = 20;
+    config.max_retry_attempts = 2;
+    config.retry_on_timeout = true;
+    config.retry_backoff_ms = 20.0;
+    config.retry_jitter = 0.0;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+
+    bool attributed = true;
+    for (int i = 1; i <= 3; ++i) {
+        std::vector<std::string> params = {"voltage", std::to_string(i)};
+        TestResult result = controller.runTest("device_" + std::to_string(i), params);
+        // A late reply must never answer a retry or a later test
+        if (result.passed && std::abs(result.measurement_value - i) > 0.5) {
+            attributed = false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    }
+    HealthSnapshot health = controller.getHealthSnapshot();
+    controller.stop();
+    return attributed && health.timeouts > 0 && health.retries > 0;
+}
+
+bool test_adaptive_timeouts() {
+#ifdef _WIN32
+    return true;
+#else
+    // The fixture answers 20 tests, then goes dead
+    std::atomic<int> commands(0);
+    FakeSerialDevice device([&commands](const std::string& command) -> std::string {
+        if (command.rfind("TEST:", 0) != 0) return "";
+        return commands++ < 20 ? "RESULT:1.0:V:PASS\r\n" : "";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.max_retry_attempts = 0;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+    std::vector<std::string> params = {"voltage", "1.0"};
+    for (int i = 0; i < 20; ++i) {
+        if (!controller.runTest("device_1", params).passed) return false;
+    }
+    auto started = std::chrono::steady_clock::now();
+    TestResult dead = controller.runTest("device_2", params);
+    auto detected = std::chrono::steady_clock::now() - started;
+    auto metrics = controller.getHealthMetrics();
+    auto timeouts = controller.getResponseTimeouts();
+    controller.stop();
+
+    // Learned from device_1 and shared by its type; well under the 5 s ceiling
+    bool exposed = std::any_of(metrics.begin(), metrics.end(), [](const std::pair<std::string, double>& metric) {
+        return metric.first == "Response_Timeout_Ms:device/voltage" && metric.second < 1000.0;
+    });
+    return !dead.passed && dead.notes == "No response from device" && detected < std::chrono::seconds(1) &&
+           exposed && timeouts.size() == 1 && timeouts[0].device_type == "device" && timeouts[0].samples == 20;
+#endif
+}
+
+#ifndef _WIN32
+namespace {
+
+/**
+ * @brief Minimal blocking client for the test server
+ */
+class ServerClient {
+public:
+    explicit ServerClient(const std::string& address) : fd(-1) {
+        ServerAddress parsed;
+        if (!parseServerAddress(address, parsed)) return;
+        if (parsed.unix_socket) {
+            struct sockaddr_un remote = {};
+            remote.sun_family = AF_UNIX;
+            std::strncpy(remote.sun_path, parsed.path.c_str(), sizeof(remote.sun_path) - 1);
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) != 0) {
+                close(fd);
+                fd = -1;
+            }
+        } else {
+            struct sockaddr_in remote = {};
+            remote.sin_family = AF_INET;
+            remote.sin_port = htons(static_cast<uint16_t>(std::stoi(parsed.port)));
+            inet_pton(AF_INET, parsed.host.c_str(), &remote.sin_addr);
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) != 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+    ~ServerClient() {
+        if (fd >= 0) close(fd);
+    }
+
+    bool send(const std::string& requests) {
+        return fd >= 0 && ::send(fd, requests.data(), requests.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(requests.size());
+    }
+
+    // Read until count lines have arrived or two seconds pass
+    std::vector<std::string> receive(size_t count) {
+        std::vector<std::string> lines;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (fd >= 0 && lines.size() < count && std::chrono::steady_clock::now() < deadline) {
+            struct pollfd pfd = {fd, POLLIN, 0};
+            if (poll(&pfd, 1, 50) <= 0) continue;
+            char buffer[1024];
+            ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) break;
+            partial.append(buffer, static_cast<size_t>(received));
+            size_t newline;
+            while ((newline = partial.find('\n')) != std::string::npos) {
+                lines.push_back(partial.substr(0, newline));
+                partial.erase(0, newline + 1);
+            }
+        }
+        return lines;
+    }
+
+private:
+    int fd;
+    std::string partial;
+};
+
+} // namespace
+#endif
+
+bool test_overdue_reply_protection() {
+#ifdef _WIN32
+    return true;
+#else
+    // The fixture answers 20 tests at once, then takes 80 ms for three, past the learned 50 ms
+    std::atomic<int> commands(0);
+    FakeSerialDevice device([&commands](const std::string& command) -> std::string {
+        if (command.rfind("TEST:", 0) != 0) return "";
+        int index = commands++;
+        if (index >= 20 && index < 23) std::this_thread::sleep_for(std::chrono::milliseconds(80));
+        return "RESULT:" + command.substr(command.rfind(':') + 1) + ":V:PASS\r\n";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.max_retry_attempts = 0;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+    std::vector<std::string> params = {"voltage", "1.0"};
+    for (int i = 0; i < 20; ++i) {
+        if (!controller.runTest("device_1", params).passed) return false;
+    }
+
+    // Each timed-out reply is waited out before the next command, never taken as its answer
+    std::vector<TestResult> results;
+    for (int i = 2; i <= 6; ++i) {
+        params[1] = std::to_string(i);
+        results.push_back(controller.runTest("device_1", params));
+    }
+    HealthSnapshot health = controller.getHealthSnapshot();
+    controller.stop();
+
+    bool attributed = true;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].passed && std::abs(results[i].measurement_value - static_cast<double>(i + 2)) > 0.5) {
+            attributed = false;
+        }
+    }
+    // Once the fixture is fast again, its answers line up with their tests
+    return attributed && health.timeouts == 3 && results[3].passed && results[4].passed;
+#endif
+}
+
+bool test_tagged_retry_replies() {
+#ifdef _WIN32
+    return true;
+#else
+    // Echoes tags; answers 20 tests at once, then takes 80 ms for one, past the learned 50 ms
+    std::atomic<int> commands(0);
+    FakeSerialDevice device([&commands](const std::string& command) -> std::string {
+        size_t test = command.find(":TEST:");
+        if (command.empty() || command[0] != '#' || test == std::string::npos) return "";
+        if (commands++ == 20) std::this_thread::sleep_for(std::chrono::milliseconds(80));
+        return command.substr(0, test) + ":RESULT:" + command.substr(command.rfind(':') + 1) + ":V:PASS\r\n";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.pipeline_depth = 2;
+    config.max_retry_attempts = 1;
+    config.retry_on_timeout = true;
+    config.retry_backoff_ms = 5.0;
+    config.retry_jitter = 0.0;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) {
+        return false;
+    }
+    std::vector<std::string> params = {"voltage", "1.0"};
+    for (int i = 0; i < 20; ++i) {
+        if (!controller.runTest("device_1", params).passed) return false;
+    }
+
+    // The late reply to the first attempt is told apart from the retry's, with no wait for it
+    auto start = std::chrono::steady_clock::now();
+    params[1] = "2";
+    TestResult retried = controller.runTest("device_1", params);
+    params[1] = "3";
+    TestResult next = controller.runTest("device_1", params);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    HealthSnapshot health = controller.getHealthSnapshot();
+    controller.stop();
+
+    return retried.passed && retried.measurement_value == 2.0 && next.passed && next.measurement_value == 3.0 &&
+           health.retries == 1 && health.recovered_by_retry == 1 && elapsed < std::chrono::milliseconds(500);
+#endif
+}
+
+bool test_test_server() {
+#ifdef _WIN32
+    return true;
+#else
+    std::vector<std::unique_ptr<FakeSerialDevice>> devices;
+    for (int i = 0; i < 2; ++i) {
+        devices.push_back(std::make_unique<FakeSerialDevice>([](const std::string& command) {
+            return command.rfind("TEST:", 0) == 0 ? std::string("RESULT:1.5,1.6:V:PASS\r\n") : std::string();
+        }));
+        if (!devices.back()->valid()) {
+            return false;
+        }
+    }
+    StationPool pool;
+    for (const auto& device : devices) {
+        pool.addStation(makeFakeDeviceConfig(device->port()));
+    }
+    if (!pool.start()) {
+        return false;
+    }
+    TestServer server(pool);
+    if (!server.start("127.0.0.1:0")) {
+        return false;
+    }
+
+    // Two clients pipeline tests; results come back tagged, in completion order
+    ServerClient first(server.boundAddress()), second(server.boundAddress());
+    std::string burst;
+    for (int i = 0; i < 20; ++i) {
+        burst += "TEST:a" + std::to_string(i) + ":part_" + std::to_string(i) + ":voltage:1.5\n";
+    }
+    if (!first.send(burst) || !second.send("PING:p\nTEST:b0:part_x:voltage\nBOGUS:q\nHEALTH:h:7\n")) {
+        return false;
+    }
+    std::vector<std::string> results = first.receive(20);
+    std::vector<std::string> others = second.receive(4);
+
+    size_t passed = 0;
+    std::vector<bool> seen(20, false);
+    for (const auto& line : results) {
+        size_t tagEnd = line.find(':', 8);
+        if (line.rfind("RESULT:a", 0) != 0 || tagEnd == std::string::npos) return false;
+        seen[std::stoi(line.substr(8, tagEnd - 8)) % 20] = true;
+        passed += line.find(":PASS:") != std::string::npos && line.find(":1.5,1.6:V:") != std::string::npos;
+    }
+    bool multiplexed = results.size() == 20 && passed == 20 &&
+                       std::all_of(seen.begin(), seen.end(), [](bool tag) { return tag; });
+    bool answered = others.size() == 4 &&
+                    std::count(others.begin(), others.end(), "PONG:p") == 1 &&
+                    std::count(others.begin(), others.end(), "ERROR:q:Unknown request") == 1 &&
+                    std::count(others.begin(), others.end(), "ERROR:h:No such station") == 1 &&
+                    std::any_of(others.begin(), others.end(), [](const std::string& line) {
+                        return line.rfind("RESULT:b0:PASS:", 0) == 0;
+                    });
+
+    ServerClient status(server.boundAddress());
+    status.send("STATUS:s\nHEALTH:h0:0\n");
+    std::vector<std::string> replies = status.receive(2);
+    bool reported = replies.size() == 2 && replies[0] == "STATUS:s:2:2:21:21:21:0" &&
+                    replies[1].rfind("HEALTH:h0:Tests_Run=", 0) == 0;
+    server.stop();
+
+    // The same protocol over a Unix socket
+    const char* path = "integration_test_server.sock";
+    TestServer local(pool);
+    if (!local.start(std::string("unix:") + path)) {
+        return false;
+    }
+    ServerClient unixClient(local.boundAddress());
+    unixClient.send("TEST:u:part_u\n");
+    std::vector<std::string> unixResults = unixClient.receive(1);
+    local.stop();
+    pool.stop();
+
+    bool overUnix = unixResults.size() == 1 && unixResults[0].rfind("RESULT:u:PASS:", 0) == 0 &&
+                    std::ifstream(path).fail();
+    return multiplexed && answered && reported && overUnix;
+#endif
+}
+
+bool test_parallel_test_plan() {
+#ifdef _WIN32
+    return true;
+#else
+    // Two instruments; voltage and current take 40 ms each and the current step can be made to fail
+    std::atomic<int> busy(0), overlap(0);
+    std::atomic<bool> currentFails(false);
+    auto handler = [&](const std::string& command) -> std::string {
+        if (command.rfind("TEST:", 0) != 0) return "";
+        bool slow = command.find(":voltage:") != std::string::npos || command.find(":current:") != std::string::npos;
+        int running = ++busy;
+        overlap = std::max(overlap.load(), running);
+        if (slow) std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        --busy;
+        bool fail = currentFails && command.find(":current:") != std::string::npos;
+        return fail ? "RESULT:0.0:A:FAIL\r\n" : "RESULT:1.0:V:PASS\r\n";
+    };
+    FakeSerialDevice first(handler), second(handler);
+    if (!first.valid() || !second.valid()) {
+        return false;
+    }
+    StationPool pool;
+    pool.addStation(makeFakeDeviceConfig(first.port()));
+    pool.addStation(makeFakeDeviceConfig(second.port()));
+    if (!pool.start()) {
+        return false;
+    }
+
+    TestPlan plan("standard_part");
+    plan.addStep({"power_up", {"power", "on"}, {}, StationPool::ANY_STATION, true});
+    plan.addStep({"voltage", {"voltage", "5.0"}, {"power_up"}, StationPool::ANY_STATION, true});
+    plan.addStep({"current", {"current", "0.1"}, {"power_up"}, StationPool::ANY_STATION, true});
+    plan.addStep({"vision", {"vision", "check"}, {"voltage", "current"}, 0, false});
+    if (!plan.compile()) {
+        return false;
+    }
+
+    // Independent steps share the two instruments
+    PlanResult passed = plan.run(pool, "part_1");
+    bool parallel = passed.passed && !passed.aborted && overlap >= 2 &&
+                    std::all_of(passed.steps.begin(), passed.steps.end(), [](const StepResult& step) {
+                        return step.ran && step.passed;
+                    }) &&
+                    passed.steps[3].station == 0 && passed.steps[1].station != passed.steps[2].station;
+
+    // A hard failure stops the plan before the dependent step
+    currentFails = true;
+    PlanResult failed = plan.run(pool, "part_2");
+    pool.stop();
+    bool aborted = !failed.passed && failed.aborted && failed.failed_step == "current" &&
+                   failed.steps[1].ran && failed.steps[1].passed && !failed.steps[3].ran &&
+                   failed.steps[3].result.notes == "Not started: step 'current' failed";
+    return parallel && aborted;
+#endif
+}
+
+bool test_binary_protocol_fallback() {
+#ifdef _WIN32
+    return true;
+#else
+    // Firmware without binary support ignores the request
+    FakeSerialDevice device([](const std::string& command) -> std::string {
+        return command.rfind("TEST:", 0) == 0 ? "RESULT:2.5:V:PASS\r\n" : "";
+    });
+    if (!device.valid()) {
+        return false;
+    }
+    EquipmentConfig config = makeFakeDeviceConfig(device.port());
+    config.binary_protocol = true;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start() || controller.usingBinaryProtocol()) {
+        return false;
+    }
+    TestResult result = controller.runTest("device_1", {"voltage", "2.5"});
+    controller.stop();
+    return result.passed && result.measurement_value == 2.5;
+#endif
+}
+
+bool test_spc_drift_alarm() {
+    // 5.0 V +/- 0.01 noise for the baseline, then a 0.1 V step
+    EquipmentConfig config = makeSimulatedConfig("value_noise=0.01,seed=3");
+    config.channel_nominal = {5.0};
+    config.measurement_tolerance = 0.5;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) return false;
+    std::vector<SpcAlarm> alarms;
+    controller.setSpcAlarmCallback([&alarms](const SpcAlarm& alarm) { alarms.push_back(alarm); });
+
+    for (int i = 0; i < 40; ++i) {
+        controller.runTest("PSU_" + std::to_string(i), {"voltage", "5.0"});
+    }
+    bool quiet = alarms.empty();
+    TestResult shifted = controller.runTest("PSU_40", {"voltage", "5.1"});
+    bool flagged = alarms.size() == 1 && alarms[0].device_type == "PSU" && alarms[0].test == "voltage" &&
+                   alarms[0].rule == SpcRule::BEYOND_3_SIGMA && alarms[0].sample == 41;
+
+    // Batches are tracked too; the metrics expose capability per key
+    controller.runTestBatch({"PSU_41", "PSU_42"}, {"voltage", "5.0"});
+    std::vector<SpcStats> stats = controller.getSpcStats();
+    auto metrics = controller.getHealthMetrics();
+    bool cpk = std::any_of(metrics.begin(), metrics.end(), [](const auto& metric) {
+        return metric.first == "Cpk:PSU/voltage" && metric.second > 1.0;
+    });
+    controller.stop();
+    return quiet && shifted.passed && flagged && stats.size() == 1 && stats[0].samples == 43 &&
+           std::abs(stats[0].center - 5.0) < 0.01 && stats[0].sigma > 0.0 && cpk;
+}
+
+bool test_streaming_acquisition() {
+    // 200k samples/s in frames of 250; blocks of 1000 samples
+    EquipmentController controller;
+    if (!controller.initialize(makeSimulatedConfig("stream_rate_hz=200000,stream_frame_samples=250,"
+                                                   "stream_amplitude=1,stream_frequency_hz=1000")) ||
+        !controller.start()) {
+        return false;
+    }
+    StreamOptions options;
+    options.block_samples = 1000;
+    options.ring_blocks = 8;
+    if (!controller.startStream("adc_1", {"2.5"}, options) || !controller.isStreaming() ||
+        controller.startStream("adc_1", {}, options)) {
+        return false;
+    }
+
+    // A consumer that keeps up sees every sample, in order, in the same buffers
+    std::uint64_t nextSample = 0;
+    std::uint64_t nextBlock = 0;
+    bool contiguous = true;
+    bool inRange = true;
+    std::vector<const double*> buffers;
+    auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+    while (std::chrono::steady_clock::now() < until) {
+        controller.readStream([&](const SampleBlock& block) {
+            contiguous = contiguous && block.sequence == nextBlock++ && block.first_sample == nextSample;
+            nextSample += block.samples.size();
+            for (double sample : block.samples) inRange = inRange && sample >= 1.4 && sample <= 3.6;
+            if (std::find(buffers.begin(), buffers.end(), block.samples.data()) == buffers.end()) {
+                buffers.push_back(block.samples.data());
+            }
+        });
+    }
+    StreamStats kept = controller.stopStream();
+    while (controller.readStream([&](const SampleBlock& block) { nextSample += block.samples.size(); }, 10) != 0) {
+    }
+    bool keptUp = contiguous && inRange && kept.device_ended && !controller.isStreaming() &&
+                  kept.dropped_blocks == 0 && kept.samples == nextSample && kept.samples >= 40000 &&
+                  kept.missed_frames == 0 && kept.malformed_frames == 0 && buffers.size() <= 8;
+
+    // A consumer that stalls loses whole blocks, and the losses are counted
+    if (!controller.startStream("adc_1", {"2.5"}, options)) return false;
+
+    // Meanwhile queries answer and commands fail at once instead of waiting for the link
+    auto asked = std::chrono::steady_clock::now();
+    TestResult busy = controller.runTest("adc_1", {"voltage", "5.0"});
+    bool refused = controller.isConnected() && controller.pendingTests() == 0 && !busy.passed &&
+                   busy.notes == outcomeNote(OutcomeCode::STREAMING) &&
+                   controller.submitTest("adc_1", {"voltage", "5.0"}) == 0 && !controller.calibrate(true) &&
+                   controller.collectResults().empty() && controller.getStatus() == EquipmentStatus::RUNNING &&
+                   std::chrono::steady_clock::now() - asked < std::chrono::milliseconds(100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::uint64_t read = 0;
+    std::uint64_t gaps = 0;
+    std::uint64_t expected = 0;
+    auto count = [&](const SampleBlock& block) {
+        gaps += block.sequence - expected;
+        expected = block.sequence + 1;
+        read += block.samples.size();
+    };
+    controller.readStream(count);
+    StreamStats stalled = controller.stopStream();
+    while (controller.readStream(count, 10) != 0) {
+    }
+    bool dropped = stalled.dropped_blocks > 0 && stalled.dropped_samples > (stalled.dropped_blocks - 1) * 1000 &&
+                   stalled.samples == read && gaps <= stalled.dropped_blocks;
+
+    // The link is free for tests again
+    TestResult after = controller.runTest("adc_1", {"voltage", "5.0"});
+    controller.stop();
+    return keptUp && refused && dropped && after.passed;
+}
+
 int main() {
     std::cout << "=== Automated Mechatronic Test System - Integration Tests ===" << std::endl;
     std::cout << "Testing system integration and workflows..." << std::endl << std::endl;
@@ -249,6 +1736,37 @@ int main() {
     framework.run_test("Health Monitoring", test_health_monitoring);
     framework.run_test("Error Recovery", test_error_recovery);
     framework.run_test("Concurrent Operations", test_concurrent_operations);
+    framework.run_test("Fake Device Round Trip", test_fake_device_round_trip);
+    framework.run_test("Pipelined Submission", test_pipelined_submission);
+    framework.run_test("Batch Execution", test_batch_execution);
+    framework.run_test("Station Pool", test_station_pool);
+    framework.run_test("Station Pool Pinned Jobs", test_station_pool_pinned);
+    framework.run_test("Station Pool Stop", test_station_pool_stop);
+    framework.run_test("Async Overlap", test_async_overlap);
+    framework.run_test("Allocation-Free Test Path", test_allocation_free_test_path);
+    framework.run_test("Result Journal", test_result_journal);
+    framework.run_test("Background CSV Export", test_background_export);
+    framework.run_test("Controller Logging", test_controller_logging);
+    framework.run_test("Health Counters", test_health_counters);
+    framework.run_test("TCP Round Trip", test_tcp_round_trip);
+    framework.run_test("TCP Reconnect", test_tcp_reconnect);
+    framework.run_test("Simulated Load", test_simulated_load);
+    framework.run_test("Simulated Error Injection", test_simulated_error_injection);
+    framework.run_test("Binary Protocol", test_binary_protocol);
+    framework.run_test("Binary Protocol Corruption", test_binary_protocol_corruption);
+    framework.run_test("Binary Protocol Fallback", test_binary_protocol_fallback);
+    framework.run_test("Multi-Channel Limits", test_multi_channel_limits);
+    framework.run_test("Cached Calibration", test_cached_calibration);
+    framework.run_test("Retry Recovery", test_retry_recovery);
+    framework.run_test("Late Reply Drain", test_late_reply_drain);
+    framework.run_test("Background Calibration", test_background_calibration);
+    framework.run_test("Adaptive Timeouts", test_adaptive_timeouts);
+    framework.run_test("Overdue Reply Protection", test_overdue_reply_protection);
+    framework.run_test("Tagged Retry Replies", test_tagged_retry_replies);
+    framework.run_test("Test Server", test_test_server);
+    framework.run_test("Parallel Test Plan", test_parallel_test_plan);
+    framework.run_test("SPC Drift Alarm", test_spc_drift_alarm);
+    framework.run_test("Streaming Acquisition", test_streaming_acquisition);
 
     framework.print_summary();
 
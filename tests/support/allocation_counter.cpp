@@ -0,0 +1,74 @@
+/**
+ * @file allocation_counter.cpp
+ * @brief Global operator new and delete replacements that count allocations per thread
+ */
+
+#include "allocation_counter.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local bool counting = false;
+thread_local size_t allocations = 0;
+
+void* allocate(size_t size) {
+    if (counting) {
+        ++allocations;
+    }
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+// Over-aligned blocks keep the malloc() pointer just below the block
+void* allocateAligned(size_t size, std::align_val_t alignment) {
+    size_t align = static_cast<size_t>(alignment);
+    void* raw = allocate(size + align + sizeof(void*));
+    std::uintptr_t first = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+    void** block = reinterpret_cast<void**>((first + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1));
+    block[-1] = raw;
+    return block;
+}
+
+void releaseAligned(void* memory) {
+    if (memory) {
+        std::free(static_cast<void**>(memory)[-1]);
+    }
+}
+
+} // namespace
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { releaseAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { releaseAligned(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { releaseAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { releaseAligned(memory); }
+
+namespace MechatronicTest {
+
+ScopedAllocationCount::ScopedAllocationCount() : start(allocations), wasCounting(counting) {
+    counting = true;
+}
+
+ScopedAllocationCount::~ScopedAllocationCount() {
+    counting = wasCounting;
+}
+
+size_t ScopedAllocationCount::count() const {
+    return allocations - start;
+}
+
+} // namespace MechatronicTest
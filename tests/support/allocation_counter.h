@@ -0,0 +1,40 @@
+/**
+ * @file allocation_counter.h
+ * @brief Per-thread heap allocation counting for the allocation-free path tests
+ */
+
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Counts heap allocations made by the constructing thread while in scope
+ *
+ * Every form of the global operator new is replaced in allocation_counter.cpp,
+ * with matching operator delete forms; the replacements live in their own
+ * translation unit so no caller ever sees them inlined.
+ */
+class ScopedAllocationCount {
+public:
+    ScopedAllocationCount();
+    ~ScopedAllocationCount();
+
+    ScopedAllocationCount(const ScopedAllocationCount&) = delete;
+    ScopedAllocationCount& operator=(const ScopedAllocationCount&) = delete;
+
+    /**
+     * @brief Get the allocations made by this thread since construction
+     */
+    size_t count() const;
+
+private:
+    size_t start;
+    bool wasCounting;
+};
+
+} // namespace MechatronicTest
+
+#endif // ALLOCATION_COUNTER_H
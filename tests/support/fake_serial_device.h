@@ -0,0 +1,115 @@
+/**
+ * @file fake_serial_device.h
+ * @brief Pseudo-terminal fake device shared by the integration tests and benchmarks
+ */
+
+#ifndef FAKE_SERIAL_DEVICE_H
+#define FAKE_SERIAL_DEVICE_H
+
+#include "equipment_controller.h"
+
+#ifndef _WIN32
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Fake serial device on a pseudo-terminal
+ *
+ * The controller opens the slave side like a real serial port; a responder
+ * thread answers each received command line on the master side.
+ */
+class FakeSerialDevice {
+private:
+    int master_fd;
+    std::string slave_path;
+    std::atomic<bool> running;
+    std::thread responder;
+    std::function<std::string(const std::string&)> handler;
+
+public:
+    explicit FakeSerialDevice(std::function<std::string(const std::string&)> command_handler)
+        : master_fd(-1), running(false), handler(std::move(command_handler)) {
+        master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master_fd < 0 || grantpt(master_fd) != 0 || unlockpt(master_fd) != 0) {
+            return;
+        }
+        slave_path = ptsname(master_fd);
+        running = true;
+        responder = std::thread([this]() { serve(); });
+    }
+
+    ~FakeSerialDevice() {
+        running = false;
+        if (responder.joinable()) {
+            responder.join();
+        }
+        if (master_fd >= 0) {
+            close(master_fd);
+        }
+    }
+
+    const std::string& port() const {
+        return slave_path;
+    }
+
+    bool valid() const {
+        return !slave_path.empty();
+    }
+
+private:
+    void serve() {
+        std::string line;
+        char buffer[256];
+        while (running) {
+            struct pollfd pfd = {master_fd, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0 || !(pfd.revents & POLLIN)) {
+                continue;
+            }
+            ssize_t n = read(master_fd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                continue;
+            }
+            for (ssize_t i = 0; i < n; ++i) {
+                if (buffer[i] == '\n') {
+                    if (!line.empty() && line.back() == '\r') {
+                        line.pop_back();
+                    }
+                    std::string reply = handler(line);
+                    if (!reply.empty()) {
+                        ssize_t written = write(master_fd, reply.data(), reply.size());
+                        (void)written;
+                    }
+                    line.clear();
+                } else {
+                    line += buffer[i];
+                }
+            }
+        }
+    }
+};
+
+inline EquipmentConfig makeFakeDeviceConfig(const std::string& port) {
+    EquipmentConfig config;
+    config.device_port = port;
+    config.baud_rate = 115200;
+    config.measurement_tolerance = 0.1;
+    config.max_retry_attempts = 3;
+    config.enable_logging = false;
+    config.log_file_path = "";
+    return config;
+}
+
+} // namespace MechatronicTest
+
+#endif // _WIN32
+
+#endif // FAKE_SERIAL_DEVICE_H
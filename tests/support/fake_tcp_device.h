@@ -0,0 +1,152 @@
+/**
+ * @file fake_tcp_device.h
+ * @brief Loopback TCP fake device shared by the integration tests
+ */
+
+#ifndef FAKE_TCP_DEVICE_H
+#define FAKE_TCP_DEVICE_H
+
+#ifndef _WIN32
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace MechatronicTest {
+
+/**
+ * @brief Fake network tester listening on 127.0.0.1
+ *
+ * Serves one connection at a time; a responder thread answers each
+ * received command line. dropConnection() closes the current connection
+ * from the device side, as a tester reboot would.
+ */
+class FakeTcpDevice {
+private:
+    int listen_fd;
+    int port_number;
+    std::atomic<bool> running;
+    std::atomic<bool> dropRequested;
+    std::atomic<int> acceptedCount;
+    std::thread responder;
+    std::function<std::string(const std::string&)> handler;
+
+public:
+    explicit FakeTcpDevice(std::function<std::string(const std::string&)> command_handler)
+        : listen_fd(-1), port_number(0), running(false), dropRequested(false), acceptedCount(0),
+          handler(std::move(command_handler)) {
+        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd < 0) {
+            return;
+        }
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listen_fd, 4) != 0 ||
+            getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            return;
+        }
+        port_number = ntohs(address.sin_port);
+        running = true;
+        responder = std::thread([this]() { serve(); });
+    }
+
+    ~FakeTcpDevice() {
+        running = false;
+        if (responder.joinable()) {
+            responder.join();
+        }
+        if (listen_fd >= 0) {
+            close(listen_fd);
+        }
+    }
+
+    std::string port() const {
+        return "127.0.0.1:" + std::to_string(port_number);
+    }
+
+    bool valid() const {
+        return port_number != 0;
+    }
+
+    int connectionsAccepted() const {
+        return acceptedCount;
+    }
+
+    void dropConnection() {
+        dropRequested = true;
+        while (dropRequested && running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+private:
+    void serve() {
+        int client_fd = -1;
+        std::string line;
+        char buffer[256];
+        while (running) {
+            if (dropRequested) {
+                if (client_fd >= 0) {
+                    close(client_fd);
+                    client_fd = -1;
+                }
+                dropRequested = false;
+            }
+
+            struct pollfd pfd = {client_fd >= 0 ? client_fd : listen_fd, POLLIN, 0};
+            if (poll(&pfd, 1, 5) <= 0) {
+                continue;
+            }
+            if (client_fd < 0) {
+                client_fd = accept(listen_fd, nullptr, nullptr);
+                if (client_fd >= 0) {
+                    ++acceptedCount;
+                    line.clear();
+                }
+                continue;
+            }
+
+            ssize_t n = read(client_fd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                close(client_fd);
+                client_fd = -1;
+                continue;
+            }
+            for (ssize_t i = 0; i < n; ++i) {
+                if (buffer[i] == '\n') {
+                    if (!line.empty() && line.back() == '\r') {
+                        line.pop_back();
+                    }
+                    std::string reply = handler(line);
+                    if (!reply.empty()) {
+                        ssize_t written = write(client_fd, reply.data(), reply.size());
+                        (void)written;
+                    }
+                    line.clear();
+                } else {
+                    line += buffer[i];
+                }
+            }
+        }
+        if (client_fd >= 0) {
+            close(client_fd);
+        }
+    }
+};
+
+} // namespace MechatronicTest
+
+#endif // _WIN32
+
+#endif // FAKE_TCP_DEVICE_H
@@ -4,10 +4,49 @@
  */
 
 #include "equipment_controller.h"
+#include "result_store.h"
+#include "result_journal.h"
+#include "result_export.h"
+#include "async_logger.h"
+#include "mpsc_queue.h"
+#include "spsc_ring.h"
+#include "simulated_interface.h"
+#include "serial_port_config.h"
+#include "binary_protocol.h"
+#include "limit_check.h"
+#include "calibration_cache.h"
+#include "retry_policy.h"
+#include "response_timeout.h"
+#include "test_server.h"
+#include "test_plan.h"
+#include "spc_monitor.h"
+#include "vision_inspection.h"
 #include <iostream>
 #include <cassert>
 #include <chrono>
 #include <thread>
+#include <algorithm>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+#ifdef HAS_OPENCV
+#include <opencv2/imgproc.hpp>
+#endif
 
 using namespace MechatronicTest;
 
@@ -115,6 +154,39 @@ bool test_test_execution() {
     return !result.test_id.empty() && !result.device_id.empty();
 }
 
+bool test_batch_interface() {
+    EquipmentController controller;
+
+    // Not running: every device still gets a result, in order
+    std::vector<std::string> devices = {"dev_a", "dev_b", "dev_c"};
+    std::vector<TestResult> results = controller.runTestBatch(devices, {"test_param"});
+
+    return results.size() == devices.size() &&
+           results[2].device_id == "dev_c" && !results[2].passed && !results[2].timestamp.empty();
+}
+
+bool test_async_test_interface() {
+    EquipmentController controller;
+
+    std::future<TestResult> future = controller.runTestAsync("async_device", {"test_param"});
+    if (future.wait_for(std::chrono::seconds(2)) != std::future_status::ready) {
+        return false;
+    }
+    TestResult from_future = future.get();
+
+    std::promise<std::string> notes;
+    controller.runTestAsync("async_device", {"test_param"}, [&notes](const TestResult& result) {
+        notes.set_value(result.notes);
+    });
+    std::future<std::string> from_callback = notes.get_future();
+    if (from_callback.wait_for(std::chrono::seconds(2)) != std::future_status::ready) {
+        return false;
+    }
+
+    return from_future.device_id == "async_device" && !from_future.passed &&
+           from_callback.get() == "Equipment not in running state";
+}
+
 bool test_health_metrics() {
     EquipmentController controller;
     
@@ -124,11 +196,143 @@ bool test_health_metrics() {
     return !metrics.empty();
 }
 
+bool test_health_snapshot() {
+    EquipmentController controller;
+    HealthSnapshot before = controller.getHealthSnapshot();
+
+    EquipmentConfig config;
+    config.device_port = "test_port";
+    config.baud_rate = 115200;
+    config.measurement_tolerance = 0.1;
+    config.max_retry_attempts = 3;
+    config.enable_logging = false;
+    config.log_file_path = "";
+    controller.initialize(config);
+
+    // Rejected while not running, so not counted
+    std::vector<std::string> params = {"voltage", "5.0"};
+    controller.runTest("device_1", params);
+
+    controller.start();
+    controller.runTest("device_1", params);
+    controller.runTestBatch({"device_2", "device_3"}, params);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    HealthSnapshot after = controller.getHealthSnapshot();
+    controller.stop();
+
+    return before.tests_run == 0 && before.uptime_s == 0.0 && after.uptime_s > 0.0 &&
+           after.tests_run == 3 && after.errors == 3 && after.error_rate == 1.0 &&
+           after.tests_passed == 0 && after.timeouts == 0;
+}
+
 bool test_hardware_interface_creation() {
     auto interface = createHardwareInterface("serial");
     return interface != nullptr;
 }
 
+bool test_serial_port_config() {
+    EquipmentConfig config;
+    config.baud_rate = 921600;
+    config.serial_vmin = 1;
+    config.serial_vtime_ds = 300;
+    config.serial_sync_writes = false;
+    SerialOptions options = serialOptionsFrom(config);
+    if (options.baud_rate != 921600 || options.vmin != 1 || options.vtime_ds != 300 || options.sync_writes) {
+        return false;
+    }
+#ifdef _WIN32
+    return true;
+#else
+    if ((serialOpenFlags(options) & O_SYNC) == O_SYNC) {
+        return false;
+    }
+
+    // A pseudo-terminal accepts line settings; low-latency mode is silently unsupported
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        return false;
+    }
+    int slave = open(ptsname(master), serialOpenFlags(options));
+    bool configured = slave >= 0 && configureSerialPort(slave, options);
+
+    struct termios tty;
+    bool applied = configured && tcgetattr(slave, &tty) == 0 && cfgetospeed(&tty) == B921600 &&
+                   tty.c_cc[VMIN] == 1 && tty.c_cc[VTIME] == 255;
+
+    // No B250000 constant; goes through termios2 on Linux
+    options.baud_rate = 250000;
+#ifdef __linux__
+    applied = applied && configureSerialPort(slave, options);
+#endif
+    if (slave >= 0) close(slave);
+    close(master);
+    return applied;
+#endif
+}
+
+bool test_tcp_interface_creation() {
+    auto tcp = createHardwareInterface("tcp");
+    auto ethernet = createHardwareInterface("ethernet");
+    if (!tcp || !ethernet) {
+        return false;
+    }
+    // Ports are host:port; nothing listens on port 1
+    return !tcp->connect("no_port_here", 0) && !tcp->connect("127.0.0.1:", 0) &&
+           !tcp->connect("127.0.0.1:1", 0) && !tcp->isConnected() && !tcp->sendCommand("TEST:device_1");
+}
+
+bool test_usb_interface_creation() {
+    auto usb = createHardwareInterface("usb");
+#ifdef HAS_LIBUSB
+    // Ports are vid:pid[:serial] in hex
+    return usb && !usb->connect("not_a_device", 0) && !usb->connect("12345:1", 0) && !usb->isConnected();
+#else
+    return usb == nullptr;
+#endif
+}
+
+bool test_simulated_interface() {
+    SimulationModel model;
+    if (!parseSimulationModel("distribution=normal,latency_us=200,latency_jitter_us=20,units=mA", model) ||
+        model.distribution != LatencyDistribution::NORMAL || model.latency_us != 200.0 ||
+        model.latency_jitter_us != 20.0 || model.units != "mA" || model.nominal_value != 5.0 ||
+        parseSimulationModel("latency_us=fast", model) || parseSimulationModel("colour=red", model)) {
+        return false;
+    }
+
+    auto sim = createHardwareInterface("sim");
+    if (!sim || !sim->connect("latency_us=2000", 0)) {
+        return false;
+    }
+    // The reply is not readable before its latency has elapsed
+    auto sent = std::chrono::steady_clock::now();
+    sim->sendCommand("#7:TEST:device_1:voltage:3.3");
+    std::string reply(sim->receiveFrame(1000));
+    bool delayed = std::chrono::steady_clock::now() - sent >= std::chrono::milliseconds(2);
+
+    sim->sendCommand("BATCH:a,b,c:current:1.5");
+    std::vector<std::string> batch;
+    for (int i = 0; i < 3; ++i) {
+        batch.emplace_back(sim->receiveFrame(1000));
+    }
+    sim->sendCommand("CALIBRATE");
+    std::string calibrated(sim->receiveFrame(1000));
+
+    // Everything dropped: nothing to read
+    auto* simulated = static_cast<SimulatedInterface*>(sim.get());
+    SimulationModel lossy = simulated->getModel();
+    lossy.drop_rate = 1.0;
+    simulated->setModel(lossy);
+    sim->sendCommand("TEST:device_1");
+    bool dropped = sim->receiveFrame(20).empty();
+    std::uint64_t commands = simulated->commandsReceived();
+    sim->disconnect();
+
+    return reply == "#7:RESULT:3.3:V:PASS" && delayed && batch[0] == "RESULT:1.5:V:PASS" &&
+           batch[1] == batch[0] && batch[2] == batch[0] && calibrated == "CAL_OK" && dropped &&
+           commands == 4 && !sim->isConnected() && !sim->sendCommand("TEST:device_1");
+}
+
 bool test_calibration_interface() {
     EquipmentController controller;
     
@@ -167,6 +371,939 @@ bool test_status_callback() {
     return callback_called;
 }
 
+bool feed(LineFramer& framer, const std::string& bytes) {
+    // Mimic successive reads that each fill whatever space is free
+    size_t offset = 0;
+    while (offset < bytes.size()) {
+        size_t space = 0;
+        char* region = framer.prepareWrite(space);
+        if (space == 0) return false;
+        size_t chunk = std::min(space, bytes.size() - offset);
+        std::copy(bytes.begin() + offset, bytes.begin() + offset + chunk, region);
+        framer.commitWrite(chunk);
+        offset += chunk;
+    }
+    return true;
+}
+
+bool test_line_framer() {
+    LineFramer framer(48);
+    std::string_view frame;
+
+    // Partial frame waits for its terminator
+    if (!feed(framer, "RESULT:4.9") || framer.nextFrame(frame)) return false;
+
+    // Two frames in one read; the second is kept for the next call
+    if (!feed(framer, "8:V:PASS\r\nRESULT:1:A:FAIL\r\n")) return false;
+    if (!framer.nextFrame(frame) || frame != "RESULT:4.98:V:PASS") return false;
+    if (!framer.nextFrame(frame) || frame != "RESULT:1:A:FAIL") return false;
+    if (framer.nextFrame(frame) || framer.buffered() != 0) return false;
+
+    // Blank lines are skipped and leftovers survive buffer compaction
+    if (!feed(framer, "\r\n\r\nCAL_OK\nPART")) return false;
+    if (!framer.nextFrame(frame) || frame != "CAL_OK") return false;
+    if (!feed(framer, "IAL_FRAME_THAT_FORCES_THE_BUFFER_TO_SLIDE\n")) return false;
+    if (!framer.nextFrame(frame) || frame != "PARTIAL_FRAME_THAT_FORCES_THE_BUFFER_TO_SLIDE") return false;
+
+    // A full buffer without a terminator is flushed as one frame
+    if (!feed(framer, std::string(48, 'x'))) return false;
+    return framer.nextFrame(frame) && frame.size() == 48;
+}
+
+bool test_binary_protocol() {
+    // CRC-16/CCITT-FALSE check value
+    if (crc16("123456789", 9) != 0x29B1) {
+        return false;
+    }
+
+    // Zeros and runs longer than one COBS block survive a round trip
+    std::string payload(300, 'x');
+    payload[0] = payload[100] = payload[254] = '\0';
+    std::string wire;
+    if (appendBinaryFrame(wire, BinaryOpcode::TEST, 1, payload.data(), payload.size()) ||
+        !appendBinaryFrame(wire, BinaryOpcode::TEST, 0xBEEF, payload.data(), 255)) {
+        return false;
+    }
+    BinaryFrame frame;
+    std::string_view encoded(wire.data(), wire.size() - 1);
+    if (wire.back() != '\0' || encoded.find('\0') != std::string_view::npos ||
+        decodeBinaryFrame(encoded, frame) != BinaryDecodeStatus::OK || frame.sequence != 0xBEEF ||
+        frame.length != 255 || std::memcmp(frame.payload, payload.data(), 255) != 0) {
+        return false;
+    }
+    std::string damaged(encoded);
+    damaged[20] ^= 0x01;
+    if (decodeBinaryFrame(damaged, frame) != BinaryDecodeStatus::BAD_CRC ||
+        decodeBinaryFrame(std::string_view(encoded).substr(0, 10), frame) == BinaryDecodeStatus::OK) {
+        return false;
+    }
+
+    // Commands carry length-prefixed fields; results a float32, unit and verdict
+    std::string command;
+    std::vector<std::string_view> fields;
+    if (!encodeTestCommand(command, 7, "device_1", {"voltage", "5.0"}) ||
+        decodeBinaryFrame(std::string_view(command.data(), command.size() - 1), frame) != BinaryDecodeStatus::OK ||
+        frame.opcode != BinaryOpcode::TEST || frame.sequence != 7 || !splitBinaryFields(frame, 0, fields) ||
+        fields.size() != 3 || fields[0] != "device_1" || fields[2] != "5.0" ||
+        encodeTestCommand(command, 0, std::string(300, 'd'), {})) {
+        return false;
+    }
+    std::string result;
+    appendResultFrame(result, 9, 4.5f, UnitCode::MILLIAMPERE, true);
+    TestOutcome outcome;
+    bool parsed = decodeBinaryFrame(std::string_view(result.data(), result.size() - 1), frame) ==
+                      BinaryDecodeStatus::OK && parseBinaryResult(frame, outcome);
+    std::string ascii = "RESULT:4.5:mA:PASS\r\n";
+
+    // Binary framing: 0x00-delimited and nothing trimmed, so a trailing CR byte is kept
+    LineFramer framer(64);
+    framer.setFraming('\0', false);
+    size_t space = 0;
+    char* region = framer.prepareWrite(space);
+    std::memcpy(region, "ab\r\0cd \0", 8);
+    framer.commitWrite(8);
+    std::string_view first, second;
+    bool framed = framer.nextFrame(first) && framer.nextFrame(second) && first == "ab\r" && second == "cd ";
+
+    return parsed && outcome.measurement_value == 4.5 && outcome.unit == UnitCode::MILLIAMPERE &&
+           std::string(outcome.units) == "mA" && outcome.passed && frame.sequence == 9 &&
+           result.size() < ascii.size() && framed;
+}
+
+bool test_limit_check() {
+    // The dispatched (SIMD) check agrees with the scalar one, including
+    // tails, values on the limits and NaN
+    constexpr size_t count = 515;
+    std::vector<double> readings(count), lower(count), upper(count);
+    std::mt19937 random(3);
+    std::uniform_real_distribution<double> noise(-1.5, 1.5);
+    for (size_t i = 0; i < count; ++i) {
+        lower[i] = -1.0;
+        upper[i] = 1.0;
+        readings[i] = noise(random);
+    }
+    readings[10] = 1.0;
+    readings[11] = -1.0;
+    readings[12] = std::numeric_limits<double>::quiet_NaN();
+    std::vector<std::uint64_t> fast((count + 63) / 64, ~0ULL), reference((count + 63) / 64);
+    size_t fastFailures = checkLimits(readings.data(), lower.data(), upper.data(), count, fast.data());
+    size_t referenceFailures = checkLimitsScalar(readings.data(), lower.data(), upper.data(), count, reference.data());
+    if (fastFailures != referenceFailures || fast != reference || fastFailures == 0 ||
+        (fast[0] >> 10 & 7) != 4) {
+        return false;
+    }
+
+    // Explicit limits override nominal +/- tolerance; unset sides are unbounded
+    EquipmentConfig config;
+    config.measurement_tolerance = 0.1;
+    config.channel_nominal = {1.0, 2.0, 3.0};
+    config.channel_lower_limit = {0.0};
+    config.channel_upper_limit = {5.0, 2.5, 3.1, 9.0};
+    ChannelLimits limits = channelLimitsFrom(config);
+    if (limits.channels() != 4 || limits.lower[0] != 0.0 || std::abs(limits.lower[1] - 1.9) > 1e-12 ||
+        limits.upper[1] != 2.5 || !std::isinf(limits.lower[3]) || limits.upper[3] != 9.0 ||
+        !channelLimitsFrom(EquipmentConfig{}).empty()) {
+        return false;
+    }
+
+    // Channels missing from a reply fail
+    std::vector<std::uint64_t> mask;
+    double reply[] = {4.0, 2.4, 3.2};
+    return checkChannelLimits(limits, reply, 3, mask) == 2 && mask.size() == 1 && mask[0] == 0xC;
+}
+
+bool test_multi_channel_frames() {
+    // ASCII: comma-separated readings, channel 0 is the measurement value
+    TestOutcome outcome;
+    std::vector<double> readings;
+    if (!parseResultFrame("RESULT:1.5,2.5,-3e-3:V:PASS", outcome, &readings) || outcome.channel_count != 3 ||
+        outcome.measurement_value != 1.5 || readings != std::vector<double>{1.5, 2.5, -3e-3} ||
+        parseResultFrame("RESULT:1.5,:V:PASS", outcome) || parseResultFrame("RESULT:1.5,x:V:PASS", outcome) ||
+        !parseResultFrame("RESULT:7:V:PASS", outcome, &readings) || readings.size() != 1) {
+        return false;
+    }
+
+    // Binary: readings split over CHANNELS frames ahead of the RESULT
+    std::vector<double> sent(150);
+    for (size_t i = 0; i < sent.size(); ++i) sent[i] = 0.25 * static_cast<double>(i);
+    std::string wire;
+    appendChannelFrames(wire, 4, sent.data(), sent.size());
+    std::vector<double> received;
+    size_t frames = 0, start = 0;
+    for (size_t end = wire.find('\0'); end != std::string::npos; start = end + 1, end = wire.find('\0', start)) {
+        BinaryFrame frame;
+        if (decodeBinaryFrame(std::string_view(wire).substr(start, end - start), frame) != BinaryDecodeStatus::OK ||
+            frame.sequence != 4 || !parseBinaryChannels(frame, received)) {
+            return false;
+        }
+        ++frames;
+    }
+    return frames == 3 && received == sent;
+}
+
+bool test_result_frame_parsing() {
+    TestOutcome outcome;
+    outcome.code = OutcomeCode::NOT_RUNNING;
+
+    if (!parseResultFrame("RESULT:4.98:V:PASS", outcome)) return false;
+    if (outcome.code != OutcomeCode::COMPLETED || !outcome.passed ||
+        outcome.measurement_value != 4.98 || outcome.unit != UnitCode::VOLT ||
+        std::string(outcome.units) != "V") {
+        return false;
+    }
+
+    if (!parseResultFrame("RESULT:-1e-3:furlongs:FAIL", outcome)) return false;
+    if (outcome.passed || outcome.unit != UnitCode::OTHER || std::string(outcome.units) != "furlong") {
+        return false;
+    }
+
+    // Malformed frames are rejected rather than throwing
+    return !parseResultFrame("RESULT:abc:V:PASS", outcome) &&
+           !parseResultFrame("RESULT:1.0:V", outcome) &&
+           !parseResultFrame("ERROR:1.0:V:PASS", outcome) &&
+           unitCodeFromString(unitCodeToString(UnitCode::KILOOHM)) == UnitCode::KILOOHM;
+}
+
+bool test_timestamp_formatting() {
+    char buffer[32];
+    auto now = std::chrono::system_clock::now();
+    size_t written = formatTimestamp(now, buffer, sizeof(buffer));
+
+    // "YYYY-MM-DD HH:MM:SS"
+    return written == 19 && buffer[4] == '-' && buffer[10] == ' ' && buffer[13] == ':' &&
+           formatTimestamp(now) == std::string(buffer);
+}
+
+bool test_result_store() {
+    ResultStore store;
+    store.reserve(1000);
+
+    TestOutcome outcome;
+    outcome.code = OutcomeCode::COMPLETED;
+    outcome.unit = UnitCode::VOLT;
+    std::strcpy(outcome.units, "V");
+    outcome.timestamp = std::chrono::system_clock::now();
+    for (int i = 0; i < 1000; ++i) {
+        outcome.passed = (i % 10) != 0;
+        outcome.measurement_value = 5.0 + i * 0.001;
+        store.append(i % 2 ? "board_odd" : "board_even", outcome);
+    }
+
+    TestResult legacy;
+    legacy.device_id = "board_odd";
+    legacy.passed = false;
+    legacy.measurement_value = 9.5;
+    legacy.units = "mA";
+    legacy.notes = "No response from device";
+    legacy.outcome = OutcomeCode::NO_RESPONSE;
+    legacy.completed_at = outcome.timestamp;
+    std::uint64_t legacy_id = store.append(legacy);
+
+    // The outcome travels with the result; free-form notes do not change it
+    TestResult annotated = legacy;
+    annotated.outcome = OutcomeCode::COMPLETED;
+    annotated.notes = "Retested after rework";
+    bool carried = makeResultRecord(annotated, 0, 0).outcome == OutcomeCode::COMPLETED;
+
+    // Columns are contiguous and consistent with the row view
+    size_t passes = 0;
+    for (size_t i = 0; i < store.size(); ++i) {
+        passes += store.passedColumn()[i];
+    }
+    double sum = 0.0;
+    store.forEach([&sum](const ResultRecord& record) { sum += record.value; });
+
+    TestResult back = store.toTestResult(store.size() - 1);
+    ResultRecord last = store.record(store.size() - 1);
+    return store.size() == 1001 && store.deviceCount() == 2 && passes == 900 &&
+           sum > 5000.0 && legacy_id == 1001 && last.test_id == legacy_id &&
+           last.outcome == OutcomeCode::NO_RESPONSE && back.device_id == "board_odd" &&
+           back.units == "mA" && back.notes == legacy.notes && back.outcome == OutcomeCode::NO_RESPONSE &&
+           !back.timestamp.empty() && carried;
+}
+
+bool test_calibration_cache() {
+    const char* path = "simple_test_calibration.cache";
+    std::remove(path);
+
+    auto now = std::chrono::system_clock::now();
+    CalibrationProfile first{"fixture_1", now - std::chrono::hours(9), "CAL_OK:gain=1.002"};
+    CalibrationProfile second{"fixture_2", now - std::chrono::minutes(5), "CAL_OK"};
+    bool stored = false;
+    {
+        CalibrationCache cache(path);
+        stored = cache.store(first) && cache.store(second) &&
+                 !cache.store({"bad\tfixture", now, "CAL_OK"}) && !cache.getLastError().empty();
+    }
+
+    // A fresh cache sees both fixtures; the validity window is the reader's choice
+    CalibrationCache reopened(path);
+    CalibrationProfile profile;
+    bool found = reopened.find("fixture_1", profile) && profile.data == first.data &&
+                 std::chrono::abs(profile.calibrated_at - first.calibrated_at) < std::chrono::microseconds(1);
+    bool validity = !calibrationValid(profile, std::chrono::hours(8), now) &&
+                    calibrationValid(profile, std::chrono::hours(10), now) &&
+                    !calibrationValid({"f", now + std::chrono::hours(1), ""}, std::chrono::hours(8), now);
+
+    // Unparseable lines are skipped; replacing and erasing keep the other fixture
+    { std::ofstream(path, std::ios::app) << "garbage line\n"; }
+    second.data = "CAL_OK:gain=0.998";
+    bool updated = reopened.store(second) && reopened.erase("fixture_1") &&
+                   !reopened.find("fixture_1", profile) && reopened.find("fixture_2", profile) &&
+                   profile.data == second.data && CalibrationCache::forPath(path) == CalibrationCache::forPath(path);
+    std::remove(path);
+    return stored && found && validity && updated;
+}
+
+bool test_retry_policy() {
+    EquipmentConfig config;
+    config.max_retry_attempts = 4;
+    config.retry_backoff_ms = 10.0;
+    config.retry_max_backoff_ms = 50.0;
+    config.retry_jitter = 0.0;
+    config.retry_on_corrupt_response = false;
+    bool timeoutsSkipped = !isRetryable(retryPolicyFrom(config), OutcomeCode::NO_RESPONSE);
+    config.retry_on_timeout = true;
+    RetryPolicy policy = retryPolicyFrom(config);
+
+    bool classes = timeoutsSkipped && isRetryable(policy, OutcomeCode::NO_RESPONSE) && isRetryable(policy, OutcomeCode::INVALID_RESPONSE) &&
+                   isRetryable(policy, OutcomeCode::SEND_FAILED) && !isRetryable(policy, OutcomeCode::CORRUPT_RESPONSE) &&
+                   !isRetryable(policy, OutcomeCode::COMPLETED) && !isRetryable(policy, OutcomeCode::NOT_RUNNING);
+
+    // Without jitter: 10, 20, 40, then capped at 50 ms
+    using std::chrono::microseconds;
+    std::uint64_t state = 0;
+    bool backoff = retryDelay(policy, 1, state) == microseconds(10000) &&
+                   retryDelay(policy, 2, state) == microseconds(20000) &&
+                   retryDelay(policy, 3, state) == microseconds(40000) &&
+                   retryDelay(policy, 4, state) == microseconds(50000) &&
+                   retryDelay(policy, 30, state) == microseconds(50000);
+
+    // Full jitter spreads waits over [0, base)
+    policy.jitter = 1.0;
+    microseconds lowest(50000), highest(0);
+    for (int i = 0; i < 200; ++i) {
+        microseconds delay = retryDelay(policy, 1, state);
+        lowest = std::min(lowest, delay);
+        highest = std::max(highest, delay);
+    }
+    return classes && backoff && lowest < microseconds(2000) && highest > microseconds(8000) &&
+           highest < microseconds(10000) && retryPolicyFrom(EquipmentConfig{}).max_retries == 3;
+}
+
+bool test_response_timeout() {
+    using std::chrono::milliseconds;
+    TimeoutOptions options;
+    options.floor_ms = 50;
+    options.ceiling_ms = 5000;
+    ResponseTimeoutEstimator estimator(options);
+
+    // Unseen commands wait the ceiling; fast ones settle on the floor
+    bool unseen = estimator.timeoutMs("DEVICE", "voltage") == 5000 &&
+                  estimator.timeoutMs("STATION", "CALIBRATE", 10000) == 10000;
+    for (int i = 0; i < 50; ++i) {
+        estimator.recordResponse("DEVICE", "voltage", milliseconds(2));
+    }
+    bool floored = estimator.timeoutMs("DEVICE", "voltage") == 50;
+
+    // Slow commands converge on their own response time as the deviation decays
+    estimator.recordResponse("DEVICE", "resistance", milliseconds(200));
+    bool first = estimator.timeoutMs("DEVICE", "resistance") == 600;  // 200 + 4 * 100
+    for (int i = 0; i < 100; ++i) {
+        estimator.recordResponse("DEVICE", "resistance", milliseconds(200));
+    }
+    int settled = estimator.timeoutMs("DEVICE", "resistance");
+
+    // Each timeout doubles the wait up to the ceiling; the next response resets it
+    estimator.recordTimeout("DEVICE", "resistance");
+    int doubled = estimator.timeoutMs("DEVICE", "resistance");
+    for (int i = 0; i < 10; ++i) {
+        estimator.recordTimeout("DEVICE", "resistance");
+    }
+    int capped = estimator.timeoutMs("DEVICE", "resistance");
+    estimator.recordResponse("DEVICE", "resistance", milliseconds(200));
+    bool backoff = doubled >= 2 * settled - 1 && doubled <= 2 * settled + 1 && capped == 5000 &&
+                   estimator.timeoutMs("DEVICE", "resistance") < 300;
+
+    auto stats = estimator.snapshot();
+    bool snapshot = stats.size() == 3 && stats[2].command == "resistance" && stats[2].samples == 102 &&
+                    std::abs(stats[2].smoothed_ms - 200.0) < 1.0 && stats[1].timeout_ms == 10000.0;
+
+    // Disabled, every command waits the ceiling
+    options.adaptive = false;
+    estimator.reset(options);
+    estimator.recordResponse("DEVICE", "voltage", milliseconds(2));
+    bool fixed = estimator.timeoutMs("DEVICE", "voltage") == 5000 && estimator.snapshot().size() == 1;
+
+    bool types = deviceTypeOf("DEVICE_001") == "DEVICE" && deviceTypeOf("dmm-3") == "dmm" &&
+                 deviceTypeOf("slot_12") == "slot" && deviceTypeOf("42") == "42" && deviceTypeOf("psu") == "psu";
+    return unseen && floored && first && settled >= 200 && settled < 210 && backoff && snapshot && fixed && types;
+}
+
+bool test_server_address() {
+    ServerAddress address;
+    bool tcp = parseServerAddress("127.0.0.1:7000", address) && !address.unix_socket &&
+               address.host == "127.0.0.1" && address.port == "7000";
+    bool any = parseServerAddress(":7000", address) && address.host.empty() && address.port == "7000";
+    bool v6 = parseServerAddress("[::1]:0", address) && address.host == "::1" && address.port == "0";
+    bool local = parseServerAddress("unix:/run/mts.sock", address) && address.unix_socket &&
+                 address.path == "/run/mts.sock";
+    bool rejected = !parseServerAddress("7000", address) && !parseServerAddress("host:", address) &&
+                    !parseServerAddress("host:http", address) && !parseServerAddress("[::1]7000", address) &&
+                    !parseServerAddress("unix:", address);
+    return tcp && any && v6 && local && rejected;
+}
+
+bool test_test_plan() {
+    auto step = [](const char* id, std::vector<std::string> depends_on) {
+        TestStep definition;
+        definition.id = id;
+        definition.parameters = {id, "1.0"};
+        definition.depends_on = std::move(depends_on);
+        return definition;
+    };
+
+    // Added out of order; the schedule puts every step after its dependencies
+    TestPlan plan("part");
+    bool added = plan.addStep(step("vision", {"voltage", "current"})) && plan.addStep(step("voltage", {"power"})) &&
+                 plan.addStep(step("current", {"power"})) && plan.addStep(step("power", {})) &&
+                 !plan.addStep(step("power", {})) && !plan.addStep(step("", {}));
+    if (!added || !plan.compile()) return false;
+    std::vector<size_t> position(plan.steps().size());
+    for (size_t i = 0; i < plan.schedule().size(); ++i) position[plan.schedule()[i]] = i;
+    bool ordered = plan.schedule().size() == 4 && position[3] == 0 && position[0] == 3 &&
+                   position[1] < position[0] && position[2] < position[0];
+
+    TestPlan unknown;
+    unknown.addStep(step("a", {"missing"}));
+    TestPlan cyclic;
+    cyclic.addStep(step("a", {"c"}));
+    cyclic.addStep(step("b", {"a"}));
+    cyclic.addStep(step("c", {"b"}));
+    cyclic.addStep(step("d", {}));
+    bool rejected = !unknown.compile() && unknown.getLastError().find("missing") != std::string::npos &&
+                    !cyclic.compile() && cyclic.getLastError().find("cycle") != std::string::npos &&
+                    !cyclic.isCompiled();
+
+    // One controller runs the schedule in order
+    EquipmentConfig config;
+    config.interface_type = "sim";
+    config.device_port = "";
+    config.baud_rate = 115200;
+    config.measurement_tolerance = 0.1;
+    config.enable_logging = false;
+    EquipmentController controller;
+    if (!controller.initialize(config) || !controller.start()) return false;
+    PlanResult result = plan.run(controller, "part_1");
+    PlanResult uncompiled = cyclic.run(controller, "part_1");
+    controller.stop();
+    bool ran = result.passed && !result.aborted && result.steps.size() == 4 &&
+               std::all_of(result.steps.begin(), result.steps.end(), [](const StepResult& s) {
+                   return s.ran && s.passed && s.station == 0 && s.result.device_id == "part_1";
+               });
+
+#ifdef HAS_YAML_CPP
+    const char* path = "simple_test_plan.yaml";
+    {
+        std::ofstream out(path);
+        out << "baud_rate: 115200\n"
+               "test_plan:\n"
+               "  name: fixture_a\n"
+               "  steps:\n"
+               "    - {id: power, parameters: [power, \"on\"]}\n"
+               "    - {id: vision, parameters: [vision], depends_on: power, hard_fail: false, station: 1}\n";
+    }
+    TestPlan loaded;
+    bool yaml = loadTestPlan(path, loaded) && loaded.name() == "fixture_a" && loaded.steps().size() == 2 &&
+                loaded.steps()[1].depends_on == std::vector<std::string>{"power"} &&
+                !loaded.steps()[1].hard_fail && loaded.steps()[1].station == 1 && loaded.steps()[0].hard_fail;
+    std::remove(path);
+#else
+    TestPlan loaded;
+    bool yaml = !loadTestPlan("config.yaml", loaded) && !loaded.getLastError().empty();
+#endif
+    return ordered && rejected && ran && !uncompiled.passed && uncompiled.aborted && yaml;
+}
+
+#ifdef HAS_OPENCV
+bool test_vision_inspection() {
+    // A 40x20 part on a dark background; a second source fails every capture
+    VisionOptions options;
+    options.width = 160;
+    options.height = 120;
+    options.pool_frames = 3;
+    options.min_area_px = 500;
+    VisionInspector inspector(options, [](cv::Mat& frame) {
+        frame.setTo(cv::Scalar::all(0));
+        cv::rectangle(frame, cv::Rect(50, 40, 40, 20), cv::Scalar::all(255), cv::FILLED);
+        return true;
+    });
+    VisionInspector broken(options, [](cv::Mat&) { return false; });
+    if (inspector.inspect("part_0").get().passed || !inspector.start() || !broken.start()) {
+        return false;
+    }
+
+    std::vector<std::future<TestResult>> pending;
+    for (int i = 0; i < 10; ++i) {
+        pending.push_back(inspector.inspect("part_" + std::to_string(i)));
+    }
+    bool measured = true;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        TestResult result = pending[i].get();
+        measured = measured && result.passed && result.device_id == "part_" + std::to_string(i) &&
+                   result.units == "px" && result.measurements.size() == 5 &&
+                   std::abs(result.measurements[1] - 69.5) < 1.0 && std::abs(result.measurements[2] - 49.5) < 1.0 &&
+                   result.measurements[3] == 40 && result.measurements[4] == 20 &&
+                   result.measurement_value > 700 && result.measurement_value <= 800;
+    }
+    TestResult failed = broken.inspect("part_x").get();
+    inspector.stop();
+    broken.stop();
+
+    VisionStats stats = inspector.getStats();
+    return measured && !failed.passed && broken.getStats().capture_errors == 1 && stats.inspected == 10 &&
+           stats.passed == 10 && stats.stages[static_cast<size_t>(VisionStage::MEASURE)].count == 10 &&
+           !inspector.inspect("part_y").get().passed;
+}
+#endif
+
+bool test_result_journal() {
+    const char* path = "simple_test_journal.bin";
+    std::remove(path);
+
+    JournalOptions options;
+    options.grow_records = 16;  // Force several remaps
+
+    TestOutcome outcome;
+    outcome.code = OutcomeCode::COMPLETED;
+    outcome.unit = UnitCode::OHM;
+    outcome.timestamp = std::chrono::system_clock::now();
+    {
+        ResultJournal journal;
+        if (!journal.open(path, "station_7", options)) return false;
+        for (int i = 0; i < 40; ++i) {
+            outcome.passed = (i % 4) != 0;
+            outcome.measurement_value = 100.0 + i;
+            journal.append("resistor_board", outcome);
+        }
+    }
+
+    // Reopening continues after the last committed record
+    ResultJournal journal;
+    if (!journal.open(path, "ignored", options)) return false;
+    TestResult legacy;
+    legacy.device_id = "a_device_id_longer_than_the_inline_field";
+    legacy.passed = false;
+    legacy.measurement_value = 0.0;
+    legacy.notes = "No response from device";
+    legacy.outcome = OutcomeCode::NO_RESPONSE;
+    legacy.completed_at = outcome.timestamp;
+    journal.append(legacy);
+    bool countOk = journal.recordCount() == 41;
+    journal.close();
+
+    JournalReader reader;
+    if (!reader.open(path)) return false;
+    size_t passes = 0;
+    for (size_t i = 0; i < reader.size(); ++i) {
+        passes += reader.record(i).result.passed;
+    }
+    const JournalRecord& last = reader.record(40);
+    bool ok = countOk && reader.size() == 41 && passes == 30 &&
+              std::strcmp(reader.header().station_id, "station_7") == 0 &&
+              reader.record(0).result.test_id == 1 && reader.record(39).result.value == 139.0 &&
+              std::strcmp(reader.record(0).device_id, "resistor_board") == 0 &&
+              last.result.test_id == 41 && last.result.outcome == OutcomeCode::NO_RESPONSE &&
+              std::strlen(last.device_id) == sizeof(last.device_id) - 1;
+    reader.close();
+
+    // Readers only see synced records; the flusher syncs an idle tail on its own
+    options.sync_every_records = 1000;
+    options.sync_interval_ms = 200;
+    journal.open(path, "ignored", options);
+    journal.append(legacy);
+    journal.append(legacy);
+    bool hidden = reader.open(path) && reader.size() == 41;
+    reader.close();
+    bool synced = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (!synced && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        synced = reader.open(path) && reader.size() == 43;
+        reader.close();
+    }
+    journal.close();
+    ok = ok && hidden && synced;
+
+    // Files that are not journals are rejected untouched
+    const char* foreign = "simple_test_not_a_journal.txt";
+    if (FILE* file = std::fopen(foreign, "w")) {
+        std::fputs(std::string(256, 'x').c_str(), file);
+        std::fclose(file);
+    }
+    ResultJournal other;
+    bool rejected = !other.open(foreign, "x") && !reader.open(foreign);
+
+    std::remove(path);
+    std::remove(foreign);
+    return ok && rejected;
+}
+
+bool test_csv_export() {
+    const char* path = "simple_test_export.csv";
+    ResultStore store;
+    ResultRecord record{};
+    record.test_id = 1;
+    record.timestamp_us = 1714566896123456;  // 2024-05-01 12:34:56.123456 UTC
+    record.value = 12.5;
+    record.unit = UnitCode::VOLT;
+    record.outcome = OutcomeCode::COMPLETED;
+    record.passed = 1;
+    record.device_index = store.internDevice("board, rev \"B\"");
+    store.append(record);
+    record.test_id = 2;
+    record.timestamp_us = -1500000;  // Before the epoch: 1969-12-31 23:59:58.5
+    record.value = -0.1;
+    record.unit = UnitCode::NONE;
+    record.outcome = OutcomeCode::NO_RESPONSE;
+    record.passed = 0;
+    record.device_index = store.internDevice("plain");
+    store.append(record);
+    record.test_id = 3;
+    record.timestamp_us += 86400000000LL * 366;
+    store.append(record);
+
+    ExportOptions options;
+    options.row_group_rows = 2;
+    CsvExporter exporter(options);
+    if (!exporter.exportStore(store, path)) return false;
+
+    std::ifstream file(path);
+    std::string header, first, second, third, extra;
+    std::getline(file, header);
+    std::getline(file, first);
+    std::getline(file, second);
+    std::getline(file, third);
+    bool ended = !std::getline(file, extra);
+    file.close();
+    ExportStats stats = exporter.getStats();
+    bool ok = ended && header == "test_id,timestamp,device_id,value,unit,outcome,passed" &&
+              first == "1,2024-05-01T12:34:56.123456Z,\"board, rev \"\"B\"\"\",12.5,V,COMPLETED,1" &&
+              second == "2,1969-12-31T23:59:58.500000Z,plain,-0.1,,NO_RESPONSE,0" &&
+              third.rfind("3,1971-01-01T23:59:58.500000Z,", 0) == 0 &&
+              stats.rows == 3 && stats.total_rows == 3 && stats.row_groups == 2 && !stats.running;
+
+    // Journals export the same way, and a failed export leaves nothing behind
+    const char* journalPath = "simple_test_export_journal.bin";
+    std::remove(journalPath);
+    {
+        ResultJournal journal;
+        if (!journal.open(journalPath, "station_7")) return false;
+        store.forEach([&](const ResultRecord& row) { journal.append(store.deviceName(row.device_index), row); });
+    }
+    std::ifstream storeCsv(path);
+    std::string storeText((std::istreambuf_iterator<char>(storeCsv)), std::istreambuf_iterator<char>());
+    storeCsv.close();
+    bool journalOk = exporter.exportJournal(std::string(journalPath), path);
+    std::ifstream journalCsv(path);
+    std::string journalText((std::istreambuf_iterator<char>(journalCsv)), std::istreambuf_iterator<char>());
+    journalCsv.close();
+
+    std::remove(path);
+    bool missing = !exporter.exportJournal(std::string("simple_test_no_such_journal.bin"), path) &&
+                   !std::ifstream(path).good() && !std::ifstream(std::string(path) + ".tmp").good() &&
+                   !exporter.getLastError().empty();
+    std::remove(journalPath);
+    return ok && journalOk && journalText == storeText && missing;
+}
+
+bool test_mpsc_queue() {
+    MpscQueue<int> queue(5);
+    if (queue.capacity() != 8) return false;
+
+    // Full queues reject rather than block
+    int pushed = 0;
+    while (queue.tryPush(pushed)) ++pushed;
+    int first = -1;
+    bool fifo = pushed == 8 && queue.tryPop(first) && first == 0 && queue.tryPush(8);
+    while (queue.tryPop(first)) {}
+    if (!fifo || first != 8) return false;
+
+    // Four producers, one consumer: every value arrives exactly once
+    MpscQueue<int> shared(256);
+    const int perThread = 5000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&shared, t, perThread]() {
+            for (int i = 0; i < perThread; ++i) {
+                while (!shared.tryPush(t * perThread + i)) std::this_thread::yield();
+            }
+        });
+    }
+    std::vector<int> seen(4 * perThread, 0);
+    int received = 0;
+    int value;
+    while (received < 4 * perThread) {
+        if (shared.tryPop(value)) {
+            ++seen[value];
+            ++received;
+        }
+    }
+    for (auto& producer : producers) producer.join();
+    return std::all_of(seen.begin(), seen.end(), [](int count) { return count == 1; });
+}
+
+bool test_spc_monitor() {
+    // Quantile sketches and Welford against exact values
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    P2Quantile median(0.5), tail(0.99);
+    SpcOptions options;
+    options.baseline_samples = 24;
+    options.max_keys = 6;
+    options.lower_spec = 7.0;
+    options.upper_spec = 13.0;
+    SpcMonitor monitor(options);
+    double sum = 0.0, squares = 0.0;
+    for (int i = 0; i < 20000; ++i) {
+        double x = uniform(random);
+        median.add(x);
+        tail.add(x);
+        monitor.record("RNG", "uniform", x);
+        sum += x;
+        squares += x * x;
+    }
+    SpcStats uniformStats;
+    double mean = sum / 20000, variance = (squares - 20000 * mean * mean) / 19999;
+    bool sketches = std::abs(median.value() - 0.5) < 0.02 && std::abs(tail.value() - 0.99) < 0.005 &&
+                    monitor.stats("RNG", "uniform", uniformStats) && uniformStats.samples == 20000 &&
+                    std::abs(uniformStats.mean - mean) < 1e-9 && std::abs(uniformStats.stddev - std::sqrt(variance)) < 1e-9 &&
+                    std::abs(uniformStats.p50 - 0.5) < 0.02 && uniformStats.min >= 0.0 && uniformStats.max < 1.0 &&
+                    !monitor.stats("RNG", "other", uniformStats);
+
+    // Each rule on a key whose baseline alternates 9 and 11 (center 10, sigma ~1.02)
+    std::vector<SpcAlarm> alarms;
+    monitor.setAlarmCallback([&alarms](const SpcAlarm& alarm) { alarms.push_back(alarm); });
+    auto run = [&monitor](const char* test, std::vector<double> values) {
+        for (int i = 0; i < 24; ++i) {
+            if (monitor.record("BOARD", test, i % 2 ? 11.0 : 9.0) != SpcRule::NONE) return std::vector<SpcRule>();
+        }
+        std::vector<SpcRule> rules;
+        for (double value : values) rules.push_back(monitor.record("BOARD", test, value));
+        return rules;
+    };
+    using R = SpcRule;
+    bool rules = run("rule1", {10.5, 14.0}) == std::vector<R>{R::NONE, R::BEYOND_3_SIGMA} &&
+                 run("rule2", {12.3, 9.0, 12.3}) == std::vector<R>{R::NONE, R::NONE, R::TWO_OF_THREE_BEYOND_2_SIGMA} &&
+                 run("rule3", {11.3, 11.3, 11.3, 11.3}) ==
+                     std::vector<R>{R::NONE, R::NONE, R::NONE, R::FOUR_OF_FIVE_BEYOND_1_SIGMA} &&
+                 run("rule4", std::vector<double>(8, 10.5)) ==
+                     std::vector<R>{R::NONE, R::NONE, R::NONE, R::NONE, R::NONE, R::NONE, R::NONE, R::EIGHT_ON_ONE_SIDE};
+    SpcStats ruled;
+    bool reported = alarms.size() == 4 && alarms[0].test == "rule1" && alarms[0].sample == 26 && alarms[0].z > 3.0 &&
+                    monitor.stats("BOARD", "rule4", ruled) && ruled.alarms == 1 &&
+                    ruled.last_rule == SpcRule::EIGHT_ON_ONE_SIDE && ruled.last_alarm_sample == 32 &&
+                    std::abs(ruled.center - 10.0) < 1e-9 && std::abs(ruled.sigma - std::sqrt(24.0 / 23.0)) < 1e-9;
+
+    // Capability against the 7..13 spec; keys beyond max_keys are not tracked
+    SpcStats capable;
+    run("capability", {});
+    bool capability = monitor.stats("BOARD", "capability", capable) &&
+                      std::abs(capable.cp - 6.0 / (6.0 * std::sqrt(24.0 / 23.0))) < 1e-9 &&
+                      std::abs(capable.cpk - capable.cp) < 1e-6 &&
+                      monitor.record("BOARD", "untracked", 100.0) == SpcRule::NONE && monitor.snapshot().size() == 6;
+    return sketches && rules && reported && capability && spcRuleName(SpcRule::BEYOND_3_SIGMA) != nullptr;
+}
+
+bool test_spsc_ring() {
+    SpscRing<std::vector<int>> ring(3, [](std::vector<int>& slot) { slot.reserve(16); });
+    if (ring.capacity() != 4 || ring.front() != nullptr) return false;
+
+    // Slots keep their buffers; a full ring refuses the claim
+    const int* buffer = nullptr;
+    for (int i = 0; i < 4; ++i) {
+        std::vector<int>* slot = ring.claim();
+        if (!slot || slot->capacity() < 16) return false;
+        if (i == 0) buffer = slot->data();
+        slot->assign(1, i);
+        ring.publish();
+    }
+    if (ring.claim() != nullptr || ring.size() != 4 || ring.front()->front() != 0) return false;
+    ring.release();
+    std::vector<int>* reused = ring.claim();
+    if (!reused || reused->data() != buffer) return false;
+
+    // One producer thread, one consumer: every value arrives once, in order
+    SpscRing<int> shared(64);
+    const int count = 100000;
+    std::thread producer([&shared, count]() {
+        for (int i = 0; i < count; ++i) {
+            int* slot;
+            while ((slot = shared.claim()) == nullptr) std::this_thread::yield();
+            *slot = i;
+            shared.publish();
+        }
+    });
+    int expected = 0;
+    while (expected < count) {
+        if (int* value = shared.front()) {
+            if (*value != expected++) break;
+            shared.release();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    std::uint64_t sequence = 0;
+    std::vector<double> samples;
+    bool parsed = parseSampleFrame("DATA:42:1.5,-2,3e2", sequence, samples) && sequence == 42 &&
+                  samples == std::vector<double>{1.5, -2.0, 300.0} && parseSampleFrame("DATA:0:7", sequence, samples) &&
+                  samples.size() == 1 && !parseSampleFrame("DATA:x:1", sequence, samples) &&
+                  !parseSampleFrame("DATA:1:", sequence, samples) && !parseSampleFrame("DATA:1:1,,2", sequence, samples) &&
+                  !parseSampleFrame("RESULT:1:V:PASS", sequence, samples);
+    return expected == count && parsed;
+}
+
+bool test_async_logger() {
+    const std::string path = "simple_test_async.log";
+    for (const std::string& name : {path, path + ".1", path + ".2", path + ".3"}) {
+        std::remove(name.c_str());
+    }
+
+    LoggerOptions options;
+    options.max_file_bytes = 4096;
+    options.max_files = 3;
+    size_t dropped = 0;
+    {
+        AsyncLogger logger(path, options);
+        if (!logger.isOpen()) return false;
+
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; ++t) {
+            producers.emplace_back([&logger, t]() {
+                for (int i = 0; i < 100; ++i) {
+                    logger.log(LogLevel::INFO, "station_" + std::to_string(t), "message " + std::to_string(i));
+                }
+            });
+        }
+        for (auto& producer : producers) producer.join();
+        logger.flush();  // The next batch finds the file over max_file_bytes and rotates
+
+        TestOutcome outcome;
+        outcome.code = OutcomeCode::COMPLETED;
+        outcome.passed = true;
+        outcome.unit = UnitCode::VOLT;
+        outcome.measurement_value = 4.5;
+        outcome.timestamp = std::chrono::system_clock::now();
+        logger.logResult("station_0", "board_9", outcome);
+        logger.flush();
+        dropped = logger.droppedMessages();
+    }
+
+    // Count lines across the live file and its rotations
+    size_t lines = 0;
+    bool resultLine = false;
+    for (const std::string& name : {path, path + ".1", path + ".2", path + ".3"}) {
+        std::ifstream in(name);
+        std::string line;
+        while (std::getline(in, line)) {
+            ++lines;
+            resultLine = resultLine || line.find("RESULT board_9 PASS 4.5 V") != std::string::npos;
+        }
+    }
+    bool rotated = std::ifstream(path + ".1").good();
+
+    for (const std::string& name : {path, path + ".1", path + ".2", path + ".3"}) {
+        std::remove(name.c_str());
+    }
+    return dropped == 0 && rotated && resultLine && lines == 401;
+}
+
+bool test_status_dispatch() {
+    EquipmentController controller;
+
+    // A slow callback that re-enters the controller must not stall state changes
+    std::atomic<int> primary(0);
+    std::atomic<bool> reentered(false);
+    controller.setStatusCallback([&](EquipmentStatus, const std::string&) {
+        reentered = controller.getStatus() == controller.getStatus();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ++primary;
+    });
+
+    std::mutex seenMutex;
+    std::vector<EquipmentStatus> seen;
+    StatusListenerId observer = controller.addStatusListener([&](EquipmentStatus status, const std::string&) {
+        std::lock_guard<std::mutex> lock(seenMutex);
+        seen.push_back(status);
+    });
+
+    EquipmentConfig config;
+    config.device_port = "test_port";
+    config.baud_rate = 115200;
+    config.measurement_tolerance = 0.1;
+    config.max_retry_attempts = 3;
+    config.enable_logging = false;
+    config.log_file_path = "";
+    controller.initialize(config);
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i) {
+        controller.start();
+        controller.pause();
+        controller.resume();
+        controller.stop();
+    }
+    bool fast = std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(100);
+    bool delivered = controller.waitForStatusEvents(5000);
+
+    bool removed = controller.removeStatusListener(observer) && !controller.removeStatusListener(observer);
+    size_t before;
+    {
+        std::lock_guard<std::mutex> lock(seenMutex);
+        before = seen.size();
+    }
+    controller.start();
+    controller.waitForStatusEvents(5000);
+
+    std::lock_guard<std::mutex> lock(seenMutex);
+    bool noRepeats = std::adjacent_find(seen.begin(), seen.end()) == seen.end();
+    return fast && delivered && removed && reentered && primary > 0 && before > 0 &&
+           seen.size() == before && seen.back() == EquipmentStatus::IDLE && noRepeats;
+}
+
+bool test_latency_histogram() {
+    // Buckets are monotonic and every value falls inside its bucket, within 1/32
+    size_t previous = 0;
+    for (std::uint64_t value = 1; value < (1ull << 40); value = value * 3 / 2 + 1) {
+        size_t index = LatencyHistogram::bucketIndex(value);
+        std::uint64_t upper = LatencyHistogram::bucketUpperBound(index);
+        if (index < previous || upper < value || upper - value > value / 32) return false;
+        previous = index;
+    }
+
+    LatencyHistogram histogram;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&histogram]() {
+            for (std::uint64_t us = 1; us <= 1000; ++us) {
+                histogram.record(us * 1000);
+            }
+        });
+    }
+    for (auto& writer : writers) writer.join();
+
+    LatencySummary summary = histogram.summary();
+    auto near = [](double value, double expected) { return std::abs(value - expected) <= expected * 0.04; };
+    bool ok = summary.count == 4000 && near(summary.mean_us, 500.5) && near(summary.p50_us, 500.0) &&
+              near(summary.p99_us, 990.0) && near(summary.p999_us, 999.0) && summary.max_us == 1000.0;
+
+    histogram.reset();
+    return ok && histogram.count() == 0 && histogram.valueAtPercentile(50.0) == 0 &&
+           std::string(latencyStageName(LatencyStage::FIRST_BYTE)) == "first_byte";
+}
+
 bool test_error_handling() {
     EquipmentController controller;
     
@@ -188,11 +1325,41 @@ int main() {
     framework.run_test("Equipment Configuration", test_equipment_configuration);
     framework.run_test("Equipment State Transitions", test_equipment_state_transitions);
     framework.run_test("Test Execution Interface", test_test_execution);
+    framework.run_test("Batch Test Interface", test_batch_interface);
+    framework.run_test("Async Test Interface", test_async_test_interface);
     framework.run_test("Health Metrics", test_health_metrics);
+    framework.run_test("Health Snapshot", test_health_snapshot);
     framework.run_test("Hardware Interface Creation", test_hardware_interface_creation);
+    framework.run_test("Serial Port Config", test_serial_port_config);
+    framework.run_test("TCP Interface Creation", test_tcp_interface_creation);
+    framework.run_test("USB Interface Creation", test_usb_interface_creation);
+    framework.run_test("Simulated Interface", test_simulated_interface);
     framework.run_test("Calibration Interface", test_calibration_interface);
     framework.run_test("Status Callback", test_status_callback);
+    framework.run_test("Status Dispatch", test_status_dispatch);
+    framework.run_test("Latency Histogram", test_latency_histogram);
     framework.run_test("Error Handling", test_error_handling);
+    framework.run_test("Line Framer", test_line_framer);
+    framework.run_test("Result Frame Parsing", test_result_frame_parsing);
+    framework.run_test("Binary Protocol", test_binary_protocol);
+    framework.run_test("Limit Check", test_limit_check);
+    framework.run_test("Calibration Cache", test_calibration_cache);
+    framework.run_test("Retry Policy", test_retry_policy);
+    framework.run_test("Response Timeout", test_response_timeout);
+    framework.run_test("SPC Monitor", test_spc_monitor);
+    framework.run_test("Server Address", test_server_address);
+    framework.run_test("Test Plan", test_test_plan);
+#ifdef HAS_OPENCV
+    framework.run_test("Vision Inspection", test_vision_inspection);
+#endif
+    framework.run_test("Multi-Channel Result Frames", test_multi_channel_frames);
+    framework.run_test("Timestamp Formatting", test_timestamp_formatting);
+    framework.run_test("Result Store", test_result_store);
+    framework.run_test("Result Journal", test_result_journal);
+    framework.run_test("CSV Export", test_csv_export);
+    framework.run_test("MPSC Queue", test_mpsc_queue);
+    framework.run_test("SPSC Ring", test_spsc_ring);
+    framework.run_test("Async Logger", test_async_logger);
 
     framework.print_summary();
 